@@ -1,13 +1,55 @@
 #pragma once
 
+#include "batch/table.h"
 #include <cstdint>
 #include <atomic>
 #include <vector>
 
+// Batch group of up to MAX_GROUP_SIZE client threads (members) that combine their requests to a server node
+// into one batched message (flat combining).
+// Each member owns one slot per node, padded to a cache line. It publishes a request by storing its size in
+// the slot and adding itself to the publication list of the node: a word of member bits and a sequence number
+// counting the publications. The leader drains the list, claims the published slots and sends them in one
+// batch; members spin on their own slots until the leader hands the responses over.
 struct batch_group_t {
+    // slot states; a positive state is the size of a published request
+    static constexpr int IDLE    = 0;  // no request, or its response has been delivered
+    static constexpr int CLAIMED = -1; // taken into a batch by the leader
+    static constexpr int WAIT    = -2; // the node answered WAIT, the member receives the response itself
+
     batch_group_t(uint32_t group_id);
-    ~batch_group_t() { }
-    std::pair<uint32_t, std::atomic<int>*>* get_entry(uint32_t entry_id) { return &_entries[entry_id]; }
+    ~batch_group_t();
+
+    std::atomic<int>& get_slot(uint32_t member, uint32_t node_id) { return _slots[member * _num_nodes + node_id].state; }
+    uint32_t get_member_id(uint32_t member) { return _group_id * batch_table_t::MAX_GROUP_SIZE + member; }
+
+    // member: makes a request of size bytes visible to the leader
+    void publish(uint32_t member, uint32_t node_id, uint32_t size) {
+        get_slot(member, node_id).store(size);
+        auto& list = _lists[node_id].word;
+        uint64_t word = list.load();
+        while (!list.compare_exchange_weak(word, (word | (1ULL << member)) + SEQ_ONE)) { }
+    }
+
+    // leader: claims the requests published to the node since the last call, as (member id, size)
+    // a member may have taken its request back to send it itself, then its slot is skipped
+    void claim(uint32_t node_id, std::vector<std::pair<uint32_t, uint32_t>>& result) {
+        auto& list = _lists[node_id].word;
+        uint64_t word = list.load();
+        while ((word & MEMBER_MASK) && !list.compare_exchange_weak(word, word & ~MEMBER_MASK)) { }
+        uint64_t members = word & MEMBER_MASK;
+        while (members) {
+            uint32_t member = __builtin_ctzll(members);
+            members &= members - 1;
+            auto& slot = get_slot(member, node_id);
+            int size = slot.load();
+            if (size > 0 && slot.compare_exchange_strong(size, CLAIMED))
+                result.push_back({get_member_id(member), static_cast<uint32_t>(size)});
+        }
+    }
+
+    // number of publications to the node so far; the leader waits for it to move instead of rescanning the slots
+    uint32_t get_seq(uint32_t node_id) { return _lists[node_id].word.load() >> SEQ_SHIFT; }
 
     bool is_leader(int thread_id) {
         int cur = _leader.load();
@@ -20,7 +62,25 @@ struct batch_group_t {
     void leave()                    { _active_members.fetch_sub(1); }
     uint32_t get_active_members()   { return _active_members.load(); }
 
-    std::atomic<int> _leader;
-    std::atomic<int> _active_members;
-    std::pair<uint32_t, std::atomic<int>*>* _entries;
-};
\ No newline at end of file
+    alignas(64) std::atomic<int> _leader;
+    alignas(64) std::atomic<int> _active_members;
+
+private:
+    static constexpr uint32_t SEQ_SHIFT   = 32;
+    static constexpr uint64_t SEQ_ONE     = 1ULL << SEQ_SHIFT;
+    static constexpr uint64_t MEMBER_MASK = SEQ_ONE - 1;
+    static_assert(batch_table_t::MAX_GROUP_SIZE <= SEQ_SHIFT, "a publication list has one bit per member");
+
+    struct alignas(64) slot_t {
+        std::atomic<int> state;
+    };
+
+    struct alignas(64) list_t {
+        std::atomic<uint64_t> word; // [ sequence number (32) | member bits (32) ]
+    };
+
+    uint32_t _group_id;
+    uint32_t _num_nodes;
+    slot_t*  _slots; // MAX_GROUP_SIZE * num_nodes, by member
+    list_t*  _lists; // one per node
+};
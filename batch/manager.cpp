@@ -32,6 +32,16 @@ batch_decision_t::decision_t batch_manager_t::get_decision() {
         return batch_decision_t::decision_t::SEND_IMMEDIATELY;
 }
 
+// 2PC messages (prepare/commit/abort) are small and sent by every distributed txn, so they may be
+// group-committed as soon as another member of the group is active; the decision engine still
+// falls back to sending immediately when batching times out or conflicts
+batch_decision_t::decision_t batch_manager_t::get_commit_decision() {
+    if (group->get_active_members() > 1)
+        return decision_engine.should_wait_for_batch(this);
+    else
+        return batch_decision_t::decision_t::SEND_IMMEDIATELY;
+}
+
 bool batch_manager_t::is_leader() {
     if (leader_active)
         return true;
@@ -68,10 +78,9 @@ void batch_manager_t::resign_leader() {
 //////////////////////
 
 uint32_t batch_manager_t::submit_request(uint32_t node_id, uint32_t size) {
-    auto entry = group->get_entry(entry_idx);
-    assert(entry->first == GET_THD_ID);
-    assert(entry->second[node_id].load() == 0);
-    entry->second[node_id].store(size);
+    assert(group->get_member_id(entry_idx) == GET_THD_ID);
+    assert(group->get_slot(entry_idx, node_id).load() == batch_group_t::IDLE);
+    group->publish(entry_idx, node_id, size);
     
     uint32_t wait_time = decision_engine.calculate_wait_time(this);
     timestamps[node_id] = get_sys_clock();
@@ -81,30 +90,30 @@ uint32_t batch_manager_t::submit_request(uint32_t node_id, uint32_t size) {
 
 bool batch_manager_t::wait_for_completion(uint32_t node_id) {
     assert(entry_idx == GET_THD_ID % batch_table_t::MAX_GROUP_SIZE);
-    auto entry = group->get_entry(entry_idx);
-    auto value = entry->second[node_id].load();
+    auto& slot = group->get_slot(entry_idx, node_id);
+    auto value = slot.load();
     while (value < 0) {
-        if (value == -2) { // received WAIT response, need to receive it again itself
-            entry->second[node_id].store(0);
+        if (value == batch_group_t::WAIT) { // received WAIT response, need to receive it again itself
+            slot.store(batch_group_t::IDLE);
             return true;
         }
-        assert(value == -1);
+        assert(value == batch_group_t::CLAIMED);
         // otherwise, still waiting for response from leader
         PAUSE
-        value = entry->second[node_id].load();
+        value = slot.load();
     }
-    assert(value == 0);
+    assert(value == batch_group_t::IDLE);
     // completed successfully
     return false;
 }
 
 bool batch_manager_t::examine_status(uint32_t node_id, uint32_t wait_time) {
     assert(leader_active == false);
-    auto entry = group->get_entry(entry_idx);
+    auto& slot = group->get_slot(entry_idx, node_id);
     uint64_t deadline = timestamps[node_id] + wait_time;
     uint64_t cur_time = 0;
     while (true) {
-        auto value = entry->second[node_id].load();
+        auto value = slot.load();
         if (value <= 0) // successfully batched
             return false;
         
@@ -112,7 +121,7 @@ bool batch_manager_t::examine_status(uint32_t node_id, uint32_t wait_time) {
         cur_time = get_sys_clock();
         if (cur_time >= deadline || global_manager->is_sim_done()) {
             assert(value > 0);
-            if (entry->second[node_id].compare_exchange_strong(value, 0)) {
+            if (slot.compare_exchange_strong(value, batch_group_t::IDLE)) {
                 // timeout, try to reclaim the request to send it individually
                 return true;
             }
@@ -146,29 +155,26 @@ void batch_manager_t::try_collect_request(uint32_t node_id, std::vector<std::pai
     assert(group->_leader.load() == GET_THD_ID);
     uint64_t cur_time = get_sys_clock();
     uint64_t deadline = cur_time + LEADER_WAIT_TIME;
-    std::vector<uint32_t> claimed_members;
-    do {
-        for (uint32_t i=0; i<batch_table_t::MAX_GROUP_SIZE; i++) {
-            auto entry = group->get_entry(i);
-            auto value = entry->second[node_id].load();
-            if (value > 0) { // try to claim this request
-                if (entry->second[node_id].compare_exchange_strong(value, -1)) {
-                    // successfully claimed
-                    result.push_back({entry->first, value});
-                }
-                // otherwise, members decided to send it themselves or have not reclaimed its last batch yet
-            }
-        }
-        cur_time = get_sys_clock();
-    } while (cur_time < deadline 
-             && result.size() < group->get_active_members()
-             && global_manager->is_sim_done() == false);
+    while (true) {
+        uint32_t seq = group->get_seq(node_id);
+        group->claim(node_id, result);
+        if (result.size() >= group->get_active_members())
+            break;
+        // wait for the next publication instead of rescanning the slots
+        do {
+            PAUSE
+            cur_time = get_sys_clock();
+        } while (group->get_seq(node_id) == seq && cur_time < deadline);
+        if (cur_time >= deadline || global_manager->is_sim_done())
+            break;
+    }
 }
 
 void batch_manager_t::update_status(uint32_t node_id, uint32_t member_id, bool wait_response) {
-    auto entry = group->get_entry(member_id % batch_table_t::MAX_GROUP_SIZE);
-    assert(entry->first == member_id);
-    assert(entry->second[node_id].load() == -1);
+    uint32_t member = member_id % batch_table_t::MAX_GROUP_SIZE;
+    auto& slot = group->get_slot(member, node_id);
+    assert(group->get_member_id(member) == member_id);
+    assert(slot.load() == batch_group_t::CLAIMED);
     assert(member_id / batch_table_t::MAX_GROUP_SIZE == GET_THD_ID / batch_table_t::MAX_GROUP_SIZE);
-    entry->second[node_id].store(wait_response ? -2 : 0);
+    slot.store(wait_response ? batch_group_t::WAIT : batch_group_t::IDLE);
 }
\ No newline at end of file
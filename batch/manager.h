@@ -34,6 +34,7 @@ private:
     void                         try_collect_request(uint32_t node_id, std::vector<std::pair<uint32_t, uint32_t>>& result);
 public:
     batch_decision_t::decision_t get_decision();
+    batch_decision_t::decision_t get_commit_decision();
     uint32_t                     get_wait_time();
     bool                         is_leader();
     void                         check_leader_expiration_status();
@@ -83,6 +83,7 @@ public:
     ~tpcc_order_status_t() = default;
 
     void gen_requests();
+    bool is_read_only() { return true; }
 
     bool by_last_name;
     char c_last[LASTNAME_LEN];
@@ -113,6 +114,7 @@ public:
     }
 
     void gen_requests();
+    bool is_read_only() { return true; }
 
     int64_t threshold;
 };
@@ -5,6 +5,7 @@
 #include "benchmarks/tpcc/query.h"
 #include "benchmarks/tpcc/helper.h"
 #include "utils/helper.h"
+#include "utils/numa.h"
 #include "system/thread.h"
 #include "system/manager.h"
 #include "system/workload.h"
@@ -182,11 +183,11 @@ void tpcc_workload_t::init_tab_item() {
         #if TRANSPORT == ONE_SIDED
         auto row_addr = rpc_alloc(node_id, sizeof(row_t));
         row = reinterpret_cast<row_t*>(buffer);
+        row->init_manager();
         #else // TWO_SIDED
         RC rc = t_item->get_new_row(row);
         assert(rc == RCOK);
         #endif
-        row->init_manager();
 
         row->set_value(schema, I_ID, &i);
         uint64_t id = URand(1L,10000L);
@@ -222,11 +223,11 @@ void tpcc_workload_t::init_tab_wh(uint64_t wid) {
     char* buffer = transport->get_buffer();
     auto row_addr = rpc_alloc(node_id, sizeof(row_t));
     row = reinterpret_cast<row_t*>(buffer);
+    row->init_manager();
 #else // TWO_SIDED
     RC rc = t_warehouse->get_new_row(row);
     assert(rc == RCOK);
 #endif
-    row->init_manager();
     row->set_value(schema, W_ID, &wid);
     char name[10];
     MakeAlphaString(6, 10, name);
@@ -270,11 +271,11 @@ void tpcc_workload_t::init_tab_dist(uint64_t wid) {
         uint32_t node_id = get_partition_by_key(key, TAB_DISTRICT);
         auto row_addr = rpc_alloc(node_id, sizeof(row_t));
         row = reinterpret_cast<row_t*>(buffer);
+        row->init_manager();
         #else // TWO_SIDED
         RC rc = t_district->get_new_row(row);
         assert(rc == RCOK);
         #endif
-        row->init_manager();
 
         row->set_value(schema, D_ID, &did);
         row->set_value(schema, D_W_ID, &wid);
@@ -322,11 +323,11 @@ void tpcc_workload_t::init_tab_stock(uint64_t wid) {
         #if TRANSPORT == ONE_SIDED
         auto row_addr = rpc_alloc(node_id, sizeof(row_t));
         row = reinterpret_cast<row_t*>(buffer);
+        row->init_manager();
         #else // TWO_SIDED
         RC rc = t_stock->get_new_row(row);
         assert(rc == RCOK);
         #endif
-        row->init_manager();
 
         row->set_value(schema, S_I_ID, &iid);
         row->set_value(schema, S_W_ID, &wid);
@@ -369,11 +370,11 @@ void tpcc_workload_t::init_tab_cust(uint64_t did, uint64_t wid) {
         #if TRANSPORT == ONE_SIDED
         auto row_addr = rpc_alloc(node_id, sizeof(row_t));
         row = reinterpret_cast<row_t*>(buffer);
+        row->init_manager();
         #else // TWO_SIDED
         RC rc = t_customer->get_new_row(row);
         assert(rc == RCOK);
         #endif
-        row->init_manager();
 
         row->set_value(schema, C_ID, &cid);
         row->set_value(schema, C_D_ID, &did);
@@ -457,11 +458,11 @@ void tpcc_workload_t::init_tab_hist(uint64_t c_id, uint64_t d_id, uint64_t w_id)
     #if TRANSPORT == ONE_SIDED
     auto row_addr = rpc_alloc(node_id, sizeof(row_t));
     row = reinterpret_cast<row_t*>(buffer);
+    row->init_manager();
     #else // TWO_SIDED
     RC rc = t_history->get_new_row(row);
     assert(rc == RCOK);
     #endif
-    row->init_manager();
 
     row->set_value(schema, H_C_ID, &c_id);
     row->set_value(schema, H_C_D_ID, &d_id);
@@ -502,11 +503,11 @@ void tpcc_workload_t::init_tab_order(uint64_t did, uint64_t wid) {
         uint32_t node_id = get_partition_by_key(key, TAB_ORDER);
         auto row_addr = rpc_alloc(node_id, sizeof(row_t));
         row = reinterpret_cast<row_t*>(buffer);
+        row->init_manager();
         #else // TWO_SIDED
         RC rc = t_order->get_new_row(row);
         assert(rc == RCOK);
         #endif
-        row->init_manager();
 
         uint64_t o_ol_cnt = 1;
         uint64_t cid = perm[oid - 1];
@@ -548,11 +549,11 @@ void tpcc_workload_t::init_tab_order(uint64_t did, uint64_t wid) {
             node_id = get_partition_by_key(key, TAB_ORDERLINE);
             row_addr = rpc_alloc(node_id, sizeof(row_t));
             row = reinterpret_cast<row_t*>(buffer);
+            row->init_manager();
             #else // TWO_SIDED
             RC rc = t_orderline->get_new_row(row);
             assert(rc == RCOK);
             #endif
-            row->init_manager();
 
             row->set_value(ol_schema, OL_O_ID, &oid);
             row->set_value(ol_schema, OL_D_ID, &did);
@@ -594,11 +595,11 @@ void tpcc_workload_t::init_tab_order(uint64_t did, uint64_t wid) {
             node_id = get_partition_by_key(key, TAB_NEWORDER);
             row_addr = rpc_alloc(node_id, sizeof(row_t));
             row = reinterpret_cast<row_t*>(buffer);
+            row->init_manager();
             #else // TWO_SIDED
             rc = t_neworder->get_new_row(row);
             assert(rc == RCOK);
             #endif
-            row->init_manager();
 
             row->set_value(no_schema, NO_O_ID, &oid);
             row->set_value(no_schema, NO_D_ID, &did);
@@ -656,7 +657,11 @@ void tpcc_workload_t::init_table_parallel(uint32_t tid) {
     uint32_t num_nodes = g_num_server_nodes;
 #endif
     global_manager->set_tid(tid);
+#if NUMA_AWARE
+    numa::bind_thread(tid, g_init_parallelism); // each loader fills a contiguous chunk of the partition
+#else
     bind_core(tid);
+#endif
 
     uint64_t w_per_node = g_num_wh * g_num_server_nodes / num_nodes;
     uint64_t w_per_thread = w_per_node / g_init_parallelism;
@@ -835,6 +840,27 @@ uint64_t tpcc_workload_t::get_index_key(row_t* row, uint32_t index_id) {
     }
 }
 
+// warehouses are loaded in contiguous chunks (see init_table_parallel) and keys end with the warehouse id
+uint32_t tpcc_workload_t::get_socket_by_key(uint64_t key, uint32_t index_id) {
+    uint64_t num_wh = g_num_wh * g_num_server_nodes;
+    uint64_t wid = 0;
+    switch (index_id) {
+        case IDX_ITEM:          return get_socket_of_loader(0, g_num_wh); // loaded by the first thread
+        case IDX_WAREHOUSE:     wid = key; break;
+        case IDX_DISTRICT:
+        case IDX_NEWORDER:
+        case IDX_CUSTOMER_ID:
+        case IDX_ORDER_CUST:
+        case IDX_ORDER:
+        case IDX_STOCK:         wid = (key - 1) % num_wh + 1; break;
+        case IDX_ORDERLINE:     wid = (key / 16 - 1) % num_wh + 1; break; // accessed by orderlinePrimaryKey
+        case IDX_CUSTOMER_LAST: return numa::get_num_sockets(); // the last name hash overlaps the warehouse id
+        default:                assert(false);
+    }
+    uint64_t from = g_num_wh * g_node_id + 1;
+    return get_socket_of_loader(wid > from ? wid - from : 0, g_num_wh);
+}
+
 void tpcc_workload_t::set_partition(uint32_t table_id) {
     uint64_t partition_size = 0;
     switch (table_id) {
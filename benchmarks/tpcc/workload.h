@@ -35,6 +35,7 @@ public:
     table_t* get_table(uint32_t table_id) { return _tables[table_id]; }
     INDEX*   get_index(uint32_t index_id) { return _indexes[index_id]; }
 
+    uint32_t get_socket_by_key(uint64_t key, uint32_t index_id = 0);
     void     set_partition(uint32_t table_id = 0);
 
     catalog_t* schema;
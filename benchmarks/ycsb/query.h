@@ -19,6 +19,11 @@ public:
     uint64_t get_request_count() { return _request_cnt; }
     request_t* get_requests() { return _requests; }
     void gen_requests();
+    bool is_read_only() {
+        for (uint32_t i=0; i<_request_cnt; i++)
+            if (_requests[i].rtype != RD && _requests[i].rtype != SCAN) return false;
+        return true;
+    }
 
 private:
     request_t* _requests;
@@ -10,6 +10,7 @@
 #include "storage/row.h"
 #include "storage/table.h"
 #include "storage/catalog.h"
+#include "storage/scan.h"
 #include "txn/id.h"
 #include "txn/txn.h"
 #include "txn/stored_procedure.h"
@@ -44,9 +45,13 @@ RC ycsb_stored_procedure_t::execute() {
     uint32_t request_cnt = query->get_request_count();
     auto requests = query->get_requests();
     if (_curr_step != 0) { // get data for the last registered access
+        bool resumed = (_curr_step > request_cnt); // only range scans are left
+        bool scanning = false;
         for (uint32_t i=0; i<request_cnt; i++) {
             auto req = &requests[i];
             char* data = nullptr;
+            if (resumed && req->rtype != SCAN)
+                continue;
             if (req->rtype == RD) {
                 data = cc_man->get_data(req->key, table_id);
                 assert(data != nullptr);
@@ -69,6 +74,30 @@ RC ycsb_stored_procedure_t::execute() {
                 #endif
             }
             else { // SCAN
+#if TRANSPORT == TWO_SIDED && !PARTITIONED
+                // [ rows | next key | (key | row) * rows ]
+                auto& scan = _scans[i];
+                if (scan.key == 0) // complete
+                    continue;
+                data = cc_man->get_data(scan.key, table_id);
+                assert(data != nullptr);
+                uint32_t rows = *(uint32_t *)data;
+                uint64_t next_key = *(uint64_t *)(data + sizeof(uint32_t));
+                uint32_t entry_size = sizeof(uint64_t) + wl->get_table(table_id)->get_schema()->get_tuple_size();
+                for (uint32_t j=0; j<rows; j++) {
+                    char* row = data + scan_spec_t::HEADER_SIZE + j * entry_size + sizeof(uint64_t);
+                    for (int fid=0; fid<10; fid++)
+                        __attribute__((unused)) uint64_t fval = *(uint64_t *)(&row[fid * 100]);
+                }
+                // resume the scan from next key (on the next partition, or where a full response stopped)
+                scan.rows += rows;
+                scan.key = (scan.rows < req->value) ? next_key : 0;
+                if (scan.key != 0) {
+                    scan_spec_t spec = {req->key + req->value - 1, static_cast<uint32_t>(req->value - scan.rows), 0, 0, scan_spec_t::NONE, 0};
+                    cc_man->register_scan(wl->get_partition_by_key(scan.key), scan.key, table_id, index_id, spec);
+                    scanning = true;
+                }
+#else
                 for (uint32_t j=0; j<req->value; j++) {
                     uint64_t key = req->key + j;
                     data = cc_man->get_data(key, table_id);
@@ -80,15 +109,29 @@ RC ycsb_stored_procedure_t::execute() {
                         __attribute__((unused)) uint64_t fval = *(uint64_t *)(&data[fid * 100]);
                     #endif
                 }
+#endif
             }
         }
+        if (scanning) {
+            _curr_step++;
+            return RCOK;
+        }
         return FINISH; // proceed to commit
     }
     else { // register all the request information 
+#if TRANSPORT == TWO_SIDED && !PARTITIONED
+        _scans.assign(request_cnt, {0, 0});
+#endif
         for (uint32_t i=0; i<request_cnt; i++) {
             auto req = &requests[i];
             auto type = req->rtype;
             if (type == SCAN) {
+#if TRANSPORT == TWO_SIDED && !PARTITIONED
+                // the memory server of the start key scans its index; the scan resumes on the next node past its partition
+                scan_spec_t spec = {req->key + req->value - 1, static_cast<uint32_t>(req->value), 0, 0, scan_spec_t::NONE, 0};
+                cc_man->register_scan(wl->get_partition_by_key(req->key), req->key, table_id, index_id, spec);
+                _scans[i].key = req->key;
+#else
                 // HACK: we don't actually scan an index, 
                 //       just perform read a key at a time, 
                 //       because Sherman has a strong assumption that
@@ -98,6 +141,7 @@ RC ycsb_stored_procedure_t::execute() {
                     uint32_t node_id = wl->get_partition_by_key(key);
                     cc_man->register_access(node_id, RD, key, table_id, index_id, 0);
                 }
+#endif
             }
             else { // RD or WR
                 uint32_t node_id = wl->get_partition_by_key(req->key);
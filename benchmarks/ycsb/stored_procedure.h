@@ -3,6 +3,7 @@
 #include "txn/id.h"
 #include "txn/txn.h"
 #include "txn/stored_procedure.h"
+#include <vector>
 
 class row_t;
 class base_query_t;
@@ -18,5 +19,12 @@ public:
     void init();
 
 private:
+    // a range scan still returning rows: key to resume from (0 once complete) and rows returned so far
+    struct scan_state_t {
+        uint64_t key;
+        uint32_t rows;
+    };
+
     uint32_t _curr_step;
+    std::vector<scan_state_t> _scans; // one per request
 };
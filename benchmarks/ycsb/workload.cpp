@@ -3,6 +3,7 @@
 #include "benchmarks/ycsb/interactive.h"
 #include "benchmarks/ycsb/query.h"
 #include "utils/helper.h"
+#include "utils/numa.h"
 #include "system/thread.h"
 #include "system/manager.h"
 #include "system/query.h"
@@ -87,7 +88,11 @@ void ycsb_workload_t::init_table_parallel(uint32_t tid) {
     uint32_t num_nodes = g_num_server_nodes;
 #endif
     global_manager->set_tid(tid);
+#if NUMA_AWARE
+    numa::bind_thread(tid, g_init_parallelism); // each loader fills a contiguous chunk of the partition
+#else
     bind_core(tid);
+#endif
     uint64_t chunk_per_node = g_synth_table_size / num_nodes;
     uint64_t chunk_per_thread = chunk_per_node / g_init_parallelism;
     uint64_t from = chunk_per_node * g_node_id + chunk_per_thread * tid + 1;
@@ -97,10 +102,10 @@ void ycsb_workload_t::init_table_parallel(uint32_t tid) {
         else to = chunk_per_node * (g_node_id + 1);
     }
 
-    auto row_size = the_table->get_tuple_size() + 16;
-    assert(row_size == sizeof(row_t));
+    auto row_size = the_table->get_row_size();
     auto schema = the_schema;
 #if TRANSPORT == ONE_SIDED
+    assert(row_size == the_table->get_tuple_size() + 16);
     char* buffer = transport->get_buffer();
     for (uint64_t key=from; key<=to; key++) {
         uint32_t node_id = get_partition_by_key(key);
@@ -120,13 +125,19 @@ void ycsb_workload_t::init_table_parallel(uint32_t tid) {
         the_index->insert(key, value);
     }
 #else // TWO_SIDED
+    // rows are allocated in batches from the slabs of the table
+    const uint64_t batch_size = 1024;
+    row_t* rows[batch_size];
+    uint64_t num_rows = 0, next = 0;
     for (uint64_t key=from; key<=to; key++) {
-        uint32_t node_id = get_partition_by_key(key);
-        row_t* row = nullptr;
+        if (next == num_rows) {
+            num_rows = std::min(batch_size, to - key + 1);
+            RC rc = the_table->get_new_rows(rows, num_rows);
+            assert(rc == RCOK);
+            next = 0;
+        }
+        row_t* row = rows[next++];
         uint64_t primary_key = key;
-        RC rc = the_table->get_new_row(row);
-        assert(rc == RCOK);
-        row->init_manager();
         row->set_value(schema, 0, &primary_key);
         for(uint32_t fid=1; fid<schema->get_field_cnt(); fid++){
             // char value[6] = "hello";
@@ -155,7 +166,11 @@ void ycsb_workload_t::init_index_parallel(uint32_t tid) {
         num_nodes = g_num_server_nodes;
     }
     global_manager->set_tid(tid);
+#if NUMA_AWARE
+    numa::bind_thread(tid, g_init_parallelism); // each loader fills a contiguous chunk of the partition
+#else
     bind_core(tid);
+#endif
 
     uint64_t chunk_per_node = g_synth_table_size / num_nodes;
     uint64_t chunk_per_thread = chunk_per_node / g_init_parallelism;
@@ -211,6 +226,14 @@ uint64_t ycsb_workload_t::get_primary_key(row_t* row, uint32_t table_id) {
     return key;
 }
 
+uint32_t ycsb_workload_t::get_socket_by_key(uint64_t key, uint32_t index_id) {
+    // keys are loaded in contiguous chunks of the node's key range (see init_table_parallel)
+    uint64_t chunk_per_node = g_synth_table_size / g_num_server_nodes;
+    uint64_t from = chunk_per_node * g_node_id + 1;
+    uint64_t idx = key > from ? key - from : 0;
+    return get_socket_of_loader(idx, chunk_per_node);
+}
+
 void ycsb_workload_t::set_partition(uint32_t table_id) {
     uint64_t partition_size = g_synth_table_size / g_num_server_nodes;
     _partition_size[table_id] = partition_size;
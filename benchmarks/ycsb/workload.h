@@ -31,6 +31,7 @@ public:
     INDEX*   get_index(uint32_t index_id) { return the_index; }
     table_t* get_table(uint32_t table_id) { return the_table; }
 
+    uint32_t get_socket_by_key(uint64_t key, uint32_t index_id = 0);
     void     set_partition(uint32_t table_id = 0);
 
     catalog_t*       the_schema;
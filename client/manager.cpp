@@ -16,10 +16,19 @@
 #include "benchmarks/ycsb/workload.h"
 
 client_txn_manager_t::client_txn_manager_t(thread_t* thread)
-    : txn_manager_t(thread), _txn(nullptr) { }
+    : client_txn_manager_t(thread, 0) { }
+
+client_txn_manager_t::client_txn_manager_t(thread_t* thread, uint32_t coro_id)
+    : txn_manager_t(thread), _txn(nullptr), _coro_id(coro_id), _coro(nullptr), _yield(nullptr),
+      _traffic_request(0), _traffic_response(0) {
+    // coroutine 0 of each thread uses the thread's own QP
+    _qp_id = coro_id * g_num_client_threads + thread->get_tid();
+    assert(_qp_id < g_num_client_qps);
+}
 
 client_txn_manager_t::~client_txn_manager_t() {
     clear_txn();
+    if (_coro) delete _coro;
 }
 
 void client_txn_manager_t::init(base_query_t* query) {
@@ -92,6 +101,36 @@ void client_txn_manager_t::terminate() {
     }
 }
 
+void client_txn_manager_t::spawn(std::function<void(client_txn_manager_t*)> func) {
+    assert(_coro == nullptr);
+    _coro = new coro_call_t([this, func](coro_yield_t& yield) {
+        _yield = &yield;
+        func(this);
+        _yield = nullptr;
+    }, boost::coroutines::attributes(CORO_STACK_SIZE));
+}
+
+// run the coroutine until it yields or finishes; returns false once it has finished
+bool client_txn_manager_t::resume() {
+    assert(_coro != nullptr);
+    if (!*_coro) return false;
+
+    global_manager->set_qp_id(_qp_id);
+    global_manager->set_txn_manager(this);
+    traffic_request = _traffic_request;
+    traffic_response = _traffic_response;
+    (*_coro)();
+    _traffic_request = traffic_request;
+    _traffic_response = traffic_response;
+    global_manager->set_txn_manager(nullptr);
+    global_manager->set_qp_id(_thread->get_tid());
+    return static_cast<bool>(*_coro);
+}
+
+void client_txn_manager_t::yield() {
+    if (_yield) (*_yield)();
+}
+
 void client_txn_manager_t::clear_txn() {
     if (_txn) {
         if (txn_table->find(_txn->get_id()) != nullptr)
@@ -2,13 +2,19 @@
 #include "system/global.h"
 #include "system/global_address.h"
 #include "txn/manager.h"
+#include <functional>
+#include <boost/coroutine/all.hpp>
 
 class thread_t;
 class base_query_t;
 class txn_t;
 class client_txn_manager_t: public txn_manager_t {
 public:
+	using coro_call_t  = boost::coroutines::symmetric_coroutine<void>::call_type;
+	using coro_yield_t = boost::coroutines::symmetric_coroutine<void>::yield_type;
+
 	client_txn_manager_t(thread_t* thread);
+	client_txn_manager_t(thread_t* thread, uint32_t coro_id);
 	~client_txn_manager_t();
 
 	void init(base_query_t*);
@@ -19,6 +25,24 @@ public:
 	void terminate();
 	void clear_txn();
 
+	// coroutine execution
+	// each coroutine owns a txn manager (i.e., its own txn, QP and message buffers)
+	// and yields to the other coroutines of the thread while waiting for responses
+	void     spawn(std::function<void(client_txn_manager_t*)> func);
+	bool     resume();
+	void     yield();
+	uint32_t get_coro_id() { return _coro_id; }
+
+	static constexpr uint64_t CORO_STACK_SIZE = 1024 * 1024; // txn code keeps wc/message arrays on stack
+
 private:
 	txn_t* 			   _txn;
-};
\ No newline at end of file
+
+	uint32_t           _coro_id;
+	uint32_t           _qp_id;
+	coro_call_t*       _coro;
+	coro_yield_t*      _yield;
+	// per-txn traffic counters are thread_local; keep a copy for each coroutine
+	uint64_t           _traffic_request;
+	uint64_t           _traffic_response;
+};
@@ -1,5 +1,6 @@
 #include "client/thread.h"
 #include "client/manager.h"
+#include "client/tuner.h"
 #include "txn/txn.h"
 #include "benchmarks/ycsb/workload.h"
 #include "benchmarks/ycsb/query.h"
@@ -15,14 +16,19 @@
 #include "utils/debug.h"
 #include <functional>
 #include <random>
+#include <vector>
 
 client_thread_t::client_thread_t(uint32_t tid) 
 	: thread_t(tid, thread_t::type_t::CLIENT_THREAD) {
-	_txn_time_start = 0;
-	_txn_time_end = 0;
-	_txn_time_restart = 0;
 	_txn_cnt_abort = 0;
 	_txn_cnt_commit = 0;
+	_sim_done = false;
+	_warmup_done = false;
+	_init_time = 0;
+	_warmup_time = 0;
+	_last_cp_time = 0;
+	_cp_rebased = false;
+	_tuner = nullptr;
 }
 
 RC client_thread_t::run() {
@@ -46,22 +52,78 @@ RC client_thread_t::run() {
 	if (get_tid() == 0) {
 		printf("Begin!\n");
 	}
+	#if ADAPTIVE_CACHE
+	if (get_tid() == 0)
+		_tuner = new cache_tuner_t();
+	#endif
+
+	_sim_done = false;
+	_warmup_done = false;
+	_init_time = get_sys_clock();
+	_warmup_time = 0;
+	_last_cp_time = _init_time;
+	_cp_rebased = false;
+
+	if (g_num_client_coros == 1)
+		run_txns(txn_man);
+	else {
+		// every coroutine owns a txn manager and keeps one txn in flight;
+		// coroutines are resumed round-robin and yield while waiting for responses
+		std::vector<client_txn_manager_t*> coro_txn_mans(g_num_client_coros);
+		coro_txn_mans[0] = txn_man;
+		for (uint32_t i=1; i<g_num_client_coros; i++)
+			coro_txn_mans[i] = new client_txn_manager_t(this, i);
+		for (uint32_t i=0; i<g_num_client_coros; i++)
+			coro_txn_mans[i]->spawn([this](client_txn_manager_t* coro_txn_man) { run_txns(coro_txn_man); });
+
+		uint32_t num_active = g_num_client_coros;
+		while (num_active > 0) {
+			num_active = 0;
+			for (uint32_t i=0; i<g_num_client_coros; i++) {
+				if (coro_txn_mans[i]->resume())
+					num_active++;
+			}
+		}
+
+		for (uint32_t i=1; i<g_num_client_coros; i++) {
+			coro_txn_mans[i]->clear_txn();
+			delete coro_txn_mans[i];
+		}
+	}
+
+	// run time is per thread: until its last coroutine has finished
+	INC_FLOAT_STATS(run_time, get_sys_clock() - _warmup_time);
+	txn_man->clear_txn();
+	pthread_barrier_wait(&global_barrier);
+	if (get_tid() == 0) {
+		txn_man->terminate();
+		checkpoint();
+		delete _tuner;
+	}
+	#if BATCH
+	delete batch_manager;
+	#endif
+	delete txn_man;
+
+	return FINISH;
+}
+
+void client_thread_t::run_txns(client_txn_manager_t* txn_man) {
+	#if BATCH
+	auto batch_manager = global_manager->get_batch_manager();
+	auto batch_group = GET_BATCH_TABLE->get_group(get_tid() / batch_table_t::MAX_GROUP_SIZE);
+	#endif
 
     RC rc = RCOK;
-    uint64_t cnt_commit = 0;
     uint64_t cnt_abort = 0;
-    uint64_t time_txn_start = 0;
-    uint64_t time_txn_end = 0;
-
-	bool sim_done = false;
-	bool warmup_done = false;
-	uint64_t init_time = get_sys_clock();
-	uint64_t warmup_time = 0;
+    uint64_t txn_time_start = 0;
+    uint64_t txn_time_restart = 0;
+    uint64_t txn_time_end = 0;
 
     while (true) {
 		if (rc == RCOK) {
-			_txn_time_start = get_sys_clock();
-			_txn_time_restart = _txn_time_start;
+			txn_time_start = get_sys_clock();
+			txn_time_restart = txn_time_start;
 			cnt_abort = 0;
 			txn_man->init(GET_WORKLOAD->gen_query());
 		}
@@ -75,7 +137,7 @@ RC client_thread_t::run() {
 			#endif
 			backoff(cnt_abort);
 			cnt_abort++;
-			_txn_time_restart = get_sys_clock();
+			txn_time_restart = get_sys_clock();
 			#if BATCH
 			batch_group->join();
 			#endif
@@ -84,15 +146,13 @@ RC client_thread_t::run() {
 		rc = RCOK;
 		rc = txn_man->run();
 
-		_txn_time_end = get_sys_clock();
+		txn_time_end = get_sys_clock();
 		if (rc == RCOK) {
 			INC_INT_STATS(num_commits, 1);
-			INC_FLOAT_STATS(txn_latency, _txn_time_end - _txn_time_start);
-			#if COLLECT_LATENCY
-			stats->_stats[get_tid()]->all_latency.push_back((_txn_time_end - _txn_time_start));
-			#endif
-			INC_FLOAT_STATS(time_process_txn, _txn_time_end - _txn_time_restart);
-			INC_FLOAT_STATS(time_abort, _txn_time_restart - _txn_time_start);
+			INC_FLOAT_STATS(txn_latency, txn_time_end - txn_time_start);
+			INC_LATENCY_STATS(txn_latency, txn_time_end - txn_time_start);
+			INC_FLOAT_STATS(time_process_txn, txn_time_end - txn_time_restart);
+			INC_FLOAT_STATS(time_abort, txn_time_restart - txn_time_start);
 			_txn_cnt_commit++;
 			INC_INT_STATS(bytes_request, traffic_request);
 			INC_INT_STATS(bytes_response, traffic_response);
@@ -100,63 +160,66 @@ RC client_thread_t::run() {
 		else {
 			assert(rc == ABORT);
 			INC_INT_STATS(num_aborts, 1);
-			INC_FLOAT_STATS(time_process_txn, _txn_time_end - _txn_time_restart);
-			INC_FLOAT_STATS(time_abort, _txn_time_restart - _txn_time_start);
+			INC_FLOAT_STATS(time_process_txn, txn_time_end - txn_time_restart);
+			INC_FLOAT_STATS(time_abort, txn_time_restart - txn_time_start);
 			_txn_cnt_abort++;
 			INC_INT_STATS(bytes_abort, traffic_request);
 			INC_INT_STATS(bytes_abort, traffic_response);
 		}
 
 		reset_traffic_stats();
-		uint64_t cur_time = _txn_time_end;
-		if (!g_warmup_done && (cur_time - init_time > g_warmup_time * BILLION)) {
-			if (!warmup_done) {
+		uint64_t cur_time = txn_time_end;
+		// every thread has cleared its stats once warmup is done: no checkpoint window may span the clear
+		if (get_tid() == 0 && txn_man->get_coro_id() == 0 && g_warmup_done && !_cp_rebased) {
+			stats->rebase_checkpoints();
+			_cp_rebased = true;
+			_last_cp_time = cur_time;
+		}
+		// checkpoint every STATS_CP_INTERVAL ms
+		if (get_tid() == 0 && txn_man->get_coro_id() == 0 && (cur_time - _last_cp_time > STATS_CP_INTERVAL * 1000 * 1000)) {
+			checkpoint();
+			_last_cp_time += STATS_CP_INTERVAL * 1000 * 1000;
+		}
+		if (!g_warmup_done && (cur_time - _init_time > g_warmup_time * BILLION)) {
+			if (!_warmup_done) {
 				clear();
-				warmup_done = true;
+				_warmup_done = true;
 				global_manager->warmup_thread_done();
-				warmup_time = get_sys_clock();
+				_warmup_time = get_sys_clock();
 			}
 			if (global_manager->is_warmup_done()) {
 				g_warmup_done = true;
 			}
 		}
-		else if (g_warmup_done && (cur_time - warmup_time > g_run_time * BILLION)) {
-			assert(warmup_time - init_time > 0);
-			if (!sim_done) {
-				sim_done = true;
+		else if (g_warmup_done && (cur_time - _warmup_time > g_run_time * BILLION)) {
+			assert(_warmup_time - _init_time > 0);
+			if (!_sim_done) {
+				_sim_done = true;
 				global_manager->worker_thread_done();
 			}
-			if (global_manager->is_sim_done()) {
-				INC_FLOAT_STATS(run_time, cur_time - warmup_time);
+			if (global_manager->is_sim_done())
 				break;
-			}
 		}
 	}
-
-	txn_man->clear_txn();
-	pthread_barrier_wait(&global_barrier);
-	if (get_tid() == 0) {
-		txn_man->terminate();
-		stats->checkpoint();
-	}
-	#if BATCH
-	delete batch_manager;
-	#endif
-	delete txn_man;
-
-	return FINISH;
 }
 
 void client_thread_t::backoff(uint32_t abort_cnt) {
 	_txn_cnt_abort++;
-	for (uint64_t i = 0; i < abort_cnt; i++)
+	// an aborted coroutine must not stall the others of its thread, which may hold locks
+	for (uint64_t i = 0; i < abort_cnt; i++) {
 		PAUSE100
+		global_manager->yield();
+	}
+}
+
+void client_thread_t::checkpoint() {
+	stats->checkpoint();
+	#if ADAPTIVE_CACHE
+	_tuner->tune();
+	#endif
 }
 
 void client_thread_t::clear() {
-	_txn_time_start = 0;
-	_txn_time_end = 0;
-	_txn_time_restart = 0;
 	_txn_cnt_abort = 0;
 	_txn_cnt_commit = 0;
 	CLEAR_STATS();
@@ -2,6 +2,8 @@
 #include "system/thread.h"
 
 class ntp_client_t;
+class client_txn_manager_t;
+class cache_tuner_t;
 
 class client_thread_t : public thread_t {
 public:
@@ -10,12 +12,20 @@ public:
 	RC run();
 	
 private:
+	void run_txns(client_txn_manager_t* txn_man);
 	void backoff(uint32_t penalty);
 	void clear();
+	void checkpoint();
 
-	uint64_t _txn_time_start;
-	uint64_t _txn_time_end;
-	uint64_t _txn_time_restart;
 	uint64_t _txn_cnt_abort;
 	uint64_t _txn_cnt_commit;
-};
\ No newline at end of file
+
+	// shared by all coroutines of this thread
+	bool     _sim_done;
+	bool     _warmup_done;
+	uint64_t _init_time;
+	uint64_t _warmup_time;
+	uint64_t _last_cp_time;
+	bool     _cp_rebased; // checkpoints restarted after the warmup clear (thread 0)
+	cache_tuner_t* _tuner; // thread 0 only (ADAPTIVE_CACHE)
+};
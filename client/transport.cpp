@@ -8,13 +8,13 @@
 
 client_transport_t::client_transport_t()
     : transport_t() {
-    if(!init()) exit(0);
-	if(!connect()) exit(0);
+    if(!init()) exit(EXIT_FAILURE);
+	if(!connect()) exit(EXIT_FAILURE);
 
     // sleep(1);
 	// all the setup is complete, prepost RECVs for all server nodes
 	for(uint32_t i=0; i<g_num_server_nodes; i++) {
-		for (uint32_t j=0; j<g_num_client_threads; j++) {
+		for (uint32_t j=0; j<g_num_client_qps; j++) {
 			auto recv_ptr = get_recv_buffer(i, j);
 			post_recv(recv_ptr, i, j, MAX_MESSAGE_SIZE);
 		}
@@ -45,9 +45,9 @@ bool client_transport_t::init(){
         return cleanup();
 
     // create CQs for each client thread
-    _send_cqs = new ibv_cq*[g_num_client_threads];
-    _recv_cqs = new ibv_cq*[g_num_client_threads];
-    for(uint32_t i=0; i<g_num_client_threads; i++) {
+    _send_cqs = new ibv_cq*[g_num_client_qps];
+    _recv_cqs = new ibv_cq*[g_num_client_qps];
+    for(uint32_t i=0; i<g_num_client_qps; i++) {
         _send_cqs[i] = create_cq(_context.ctx);
         _recv_cqs[i] = create_cq(_context.ctx);
         if (!_send_cqs[i] || !_recv_cqs[i])
@@ -57,8 +57,8 @@ bool client_transport_t::init(){
     // create QPs
     _qps = new ibv_qp**[g_num_server_nodes];
     for(uint32_t i=0; i<g_num_server_nodes; i++) {
-        _qps[i] = new ibv_qp*[g_num_client_threads];
-        for(uint32_t j=0; j<g_num_client_threads; j++) {
+        _qps[i] = new ibv_qp*[g_num_client_qps];
+        for(uint32_t j=0; j<g_num_client_qps; j++) {
             _qps[i][j] = create_qp(_context.pd, _send_cqs[j], _recv_cqs[j]);
             if (!_qps[i][j]) return cleanup();
             if (!modify_qp_state_to_init(_qps[i][j])) return cleanup();
@@ -125,7 +125,7 @@ bool client_transport_t::cleanup(){
 	if (_qps) {
 		for(int i=0; i<g_num_server_nodes; i++) {
 			if(_qps[i]) {
-				for(int j=0; j<g_num_client_threads; j++) 
+				for(int j=0; j<g_num_client_qps; j++) 
 					if(_qps[i][j]) ibv_destroy_qp(_qps[i][j]);
 				delete[] _qps[i];
 			}
@@ -134,13 +134,13 @@ bool client_transport_t::cleanup(){
 	}
 
 	if (_send_cqs) {
-		for (int i=0; i<g_num_client_threads; i++)
+		for (int i=0; i<g_num_client_qps; i++)
 			if (_send_cqs[i])
 				ibv_destroy_cq(_send_cqs[i]);
 		delete[] _send_cqs;
 	}
     if (_recv_cqs) {
-        for (int i=0; i<g_num_client_threads; i++)
+        for (int i=0; i<g_num_client_qps; i++)
             if (_recv_cqs[i])
                 ibv_destroy_cq(_recv_cqs[i]);
         delete[] _recv_cqs;
@@ -158,6 +158,7 @@ bool client_transport_t::connect() {
     local.gid_idx = _context.gid_idx;
     memcpy(&local.gid, &_context.gid, sizeof(union ibv_gid));
     local.lid = _context.port_attr.lid;
+    local.num_qps = g_num_client_qps;
 
     _meta = new rdma_meta[g_num_server_nodes];
     memset(_meta, 0, data_size * g_num_server_nodes);
@@ -176,8 +177,17 @@ bool client_transport_t::connect() {
         uint32_t node_id = recv_msg->get_node_id();
         char* qp_info = recv_msg->get_data();
         memcpy(&_meta[node_id], qp_info, data_size);
+        if (_meta[node_id].num_qps != g_num_client_qps) {
+            debug::notify_error("Server node %u expects %u QPs, this client runs %u (client threads x coroutines)",
+                                node_id, _meta[node_id].num_qps, g_num_client_qps);
+            // the server checks the count too, let it fail as well
+            auto send_msg = new message_t(message_t::type_t::QP_SETUP, 0, data_size, reinterpret_cast<char*>(&local));
+            sendMsg(send_msg, node_id);
+            delete send_msg;
+            return cleanup();
+        }
         // modify QP states
-        for (uint32_t j=0; j<g_num_client_threads; j++) {
+        for (uint32_t j=0; j<g_num_client_qps; j++) {
             if(!modify_qp_state_to_rtr(_qps[node_id][j], _meta[node_id].gid, _meta[node_id].gid_idx, _meta[node_id].lid, _meta[node_id].qpn[j])){
                 debug::notify_error("Failed to modify qp state to RTR");
                 return cleanup();
@@ -200,7 +210,7 @@ bool client_transport_t::connect() {
         }
 
         delete recv_msg;
-        for (uint32_t j=0; j<g_num_client_threads; j++)
+        for (uint32_t j=0; j<g_num_client_qps; j++)
             local.qpn[j] = _qps[i][j]->qp_num;
         for (uint32_t j=0; j<g_num_batch_threads; j++)
             local.batch_qpn[j] = _batch_qps[i][j]->qp_num;
@@ -216,7 +226,7 @@ bool client_transport_t::connect() {
 
 // prepost RDMA RECV for the given QP
 void client_transport_t::post_recv(char* ptr, uint32_t node_id, uint32_t size){
-    rdma_recv_prepost(_qps[node_id][GET_THD_ID], ptr, size, _mr->lkey, node_id);
+    rdma_recv_prepost(_qps[node_id][GET_QP_ID], ptr, size, _mr->lkey, node_id);
 }
 
 void client_transport_t::post_recv(char* ptr, uint32_t node_id, uint32_t qp_id, uint32_t size){
@@ -224,7 +234,7 @@ void client_transport_t::post_recv(char* ptr, uint32_t node_id, uint32_t qp_id,
 }
 
 int client_transport_t::poll(struct ibv_wc* wc, int num) {
-    int ret = poll_cq(_recv_cqs[GET_THD_ID], num, wc);
+    int ret = poll_cq(_recv_cqs[GET_QP_ID], num, wc);
     uint32_t recv_size = 0;
     for (int i=0; i<ret; i++)
         recv_size += wc[i].byte_len;
@@ -234,7 +244,7 @@ int client_transport_t::poll(struct ibv_wc* wc, int num) {
 }
 
 int client_transport_t::poll_once(struct ibv_wc* wc, int num) {
-    int ret = poll_cq_once(_recv_cqs[GET_THD_ID], num, wc);
+    int ret = poll_cq_once(_recv_cqs[GET_QP_ID], num, wc);
     uint32_t recv_size = 0;
     for (int i=0; i<ret; i++)
         recv_size += wc[i].byte_len;
@@ -244,14 +254,15 @@ int client_transport_t::poll_once(struct ibv_wc* wc, int num) {
 }
 
 void client_transport_t::recv(char* ptr, uint32_t node_id, uint32_t size){
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     rdma_recv(_qps[node_id][qp_id], _recv_cqs[qp_id], ptr, size, _mr->lkey);
 }
 
 void client_transport_t::send(char* ptr, uint32_t node_id, uint32_t size, bool signaled){
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     rdma_send(_qps[node_id][qp_id], _send_cqs[qp_id], ptr, size, _mr->lkey, signaled);
     INC_INT_STATS(bytes_sent, size);
+    traffic_request += size;
 }
 
 void client_transport_t::post_recv_batch(char* ptr, uint32_t node_id, uint32_t size){
@@ -295,21 +306,21 @@ void client_transport_t::send_batch(char* ptr, uint32_t node_id, uint32_t size,
 }
 
 void client_transport_t::write(char* src, global_addr_t dest, uint32_t size, bool signaled){
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     rdma_write(_qps[dest.node_id][qp_id], _send_cqs[qp_id], src, dest.addr, size, _mr->lkey, _meta[dest.node_id].rkey, signaled);
     INC_INT_STATS(bytes_written, size);
     traffic_request += size;
 }
 
 void client_transport_t::read(char* src, global_addr_t dest, uint32_t size, bool signaled){ 
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     rdma_read(_qps[dest.node_id][qp_id], _send_cqs[qp_id], src, dest.addr, size, _mr->lkey, _meta[dest.node_id].rkey, signaled);
     INC_INT_STATS(bytes_read, size);
     traffic_request += size;
 }
 
 bool client_transport_t::cas(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint32_t size, bool signaled){
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     bool ret = rdma_cas(_qps[dest.node_id][qp_id], _send_cqs[qp_id], src, dest.addr, cmp, swap, size, _mr->lkey, _meta[dest.node_id].rkey, signaled);
     INC_INT_STATS(bytes_cas, size);
     traffic_request += size;
@@ -317,7 +328,7 @@ bool client_transport_t::cas(char* src, global_addr_t dest, uint64_t cmp, uint64
 }
 
 bool client_transport_t::cas_mask(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint64_t mask, uint32_t size, bool signaled){
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     bool ret = rdma_cas_mask(_qps[dest.node_id][qp_id], _send_cqs[qp_id], src, dest.addr, cmp, swap, mask, size, _mr->lkey, _meta[dest.node_id].rkey, signaled);
     INC_INT_STATS(bytes_cas, size);
     traffic_request += size;
@@ -325,14 +336,14 @@ bool client_transport_t::cas_mask(char* src, global_addr_t dest, uint64_t cmp, u
 }
 
 void client_transport_t::faa(char* src, global_addr_t dest, uint64_t add, uint32_t size, bool signaled){
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     rdma_faa(_qps[dest.node_id][qp_id], _send_cqs[qp_id], src, dest.addr, add, size, _mr->lkey, _meta[dest.node_id].rkey, signaled);
     INC_INT_STATS(bytes_faa, size);
     traffic_request += size;
 }
 
 void client_transport_t::faa_bound(char* src, global_addr_t dest, uint64_t add, uint64_t boundary, uint32_t size, bool signaled){
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     rdma_faa_bound(_qps[dest.node_id][qp_id], _send_cqs[qp_id], src, dest.addr, add, boundary, size, _mr->lkey, _meta[dest.node_id].rkey, signaled);
     INC_INT_STATS(bytes_faa, size);
     traffic_request += size;
@@ -340,7 +351,7 @@ void client_transport_t::faa_bound(char* src, global_addr_t dest, uint64_t add,
 
 void client_transport_t::read_dm(char* src, global_addr_t dest, uint32_t size, bool signaled){
     assert(_meta[dest.node_id].dm_rkey != 0);
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     rdma_read(_qps[dest.node_id][qp_id], _send_cqs[qp_id], src, _meta[dest.node_id].dm_base + dest.addr, size, _mr->lkey, _meta[dest.node_id].dm_rkey, signaled);
     INC_INT_STATS(bytes_read, size);
     traffic_request += size;
@@ -348,7 +359,7 @@ void client_transport_t::read_dm(char* src, global_addr_t dest, uint32_t size, b
 
 void client_transport_t::write_dm(char* src, global_addr_t dest, uint32_t size, bool signaled){
     assert(_meta[dest.node_id].dm_rkey != 0);
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     rdma_write(_qps[dest.node_id][qp_id], _send_cqs[qp_id], src, _meta[dest.node_id].dm_base + dest.addr, size, _mr->lkey, _meta[dest.node_id].dm_rkey, signaled);
     INC_INT_STATS(bytes_written, size);
     traffic_request += size;
@@ -356,7 +367,7 @@ void client_transport_t::write_dm(char* src, global_addr_t dest, uint32_t size,
 
 bool client_transport_t::cas_dm(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint32_t size, bool signaled){
     assert(_meta[dest.node_id].dm_rkey != 0);
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     bool ret = rdma_cas(_qps[dest.node_id][qp_id], _send_cqs[qp_id], src, _meta[dest.node_id].dm_base + dest.addr, cmp, swap, size, _mr->lkey, _meta[dest.node_id].dm_rkey, signaled);
     INC_INT_STATS(bytes_cas, size);
     traffic_request += size;
@@ -365,7 +376,7 @@ bool client_transport_t::cas_dm(char* src, global_addr_t dest, uint64_t cmp, uin
 
 bool client_transport_t::cas_dm_mask(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint64_t mask, uint32_t size, bool signaled){
     assert(_meta[dest.node_id].dm_rkey != 0);
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     INC_INT_STATS(bytes_cas, size);
     traffic_request += size;
     return rdma_cas_mask(_qps[dest.node_id][qp_id], _send_cqs[qp_id], src, _meta[dest.node_id].dm_base + dest.addr, cmp, swap, mask, size, _mr->lkey, _meta[dest.node_id].dm_rkey, signaled);
@@ -373,7 +384,7 @@ bool client_transport_t::cas_dm_mask(char* src, global_addr_t dest, uint64_t cmp
 
 void client_transport_t::faa_dm(char* src, global_addr_t dest, uint64_t add, uint32_t size, bool signaled){
     assert(_meta[dest.node_id].dm_rkey != 0);
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     rdma_faa(_qps[dest.node_id][qp_id], _send_cqs[qp_id], src, _meta[dest.node_id].dm_base + dest.addr, add, size, _mr->lkey, _meta[dest.node_id].dm_rkey, signaled);
     INC_INT_STATS(bytes_faa, size);
     traffic_request += size;
@@ -381,8 +392,71 @@ void client_transport_t::faa_dm(char* src, global_addr_t dest, uint64_t add, uin
 
 void client_transport_t::faa_dm_bound(char* src, global_addr_t dest, uint64_t add, uint64_t boundary, uint32_t size, bool signaled){
     assert(_meta[dest.node_id].dm_rkey != 0);
-    uint32_t qp_id = GET_THD_ID;
+    uint32_t qp_id = GET_QP_ID;
     rdma_faa_bound(_qps[dest.node_id][qp_id], _send_cqs[qp_id], src, _meta[dest.node_id].dm_base + dest.addr, add, boundary, size, _mr->lkey, _meta[dest.node_id].dm_rkey, signaled);
     INC_INT_STATS(bytes_faa, size);
     traffic_request += size;
-}
\ No newline at end of file
+}
+void client_transport_t::post_batch(wr_batch_t& batch){
+    post_batch_async(batch);
+    wait_batch(batch);
+}
+
+void client_transport_t::post_batch_async(wr_batch_t& batch){
+    uint32_t qp_id = GET_QP_ID;
+    uint32_t num_wrs = batch.size();
+    assert(num_wrs > 0);
+    assert(batch.pending() == 0);
+    struct ibv_send_wr wrs[wr_batch_t::MAX_WRS];
+    struct ibv_sge sges[wr_batch_t::MAX_WRS];
+    bool chained[wr_batch_t::MAX_WRS] = {false};
+    int num_chains = 0;
+
+    for (uint32_t i=0; i<num_wrs; i++) {
+        if (chained[i])
+            continue;
+        // chain all ops to the same node as op i, keeping their order
+        uint32_t node_id = batch.get_wr(i).dest.node_id;
+        struct ibv_send_wr* last = nullptr;
+        for (uint32_t j=i; j<num_wrs; j++) {
+            auto& op = batch.get_wr(j);
+            if (chained[j] || op.dest.node_id != node_id)
+                continue;
+            if (op.dm) {
+                assert(_meta[node_id].dm_rkey != 0);
+                prepare_wr(&wrs[j], &sges[j], op, _meta[node_id].dm_base + op.dest.addr, _mr->lkey, _meta[node_id].dm_rkey);
+            }
+            else
+                prepare_wr(&wrs[j], &sges[j], op, op.dest.addr, _mr->lkey, _meta[node_id].rkey);
+            if (last)
+                last->next = &wrs[j];
+            last = &wrs[j];
+            chained[j] = true;
+
+            switch (op.opcode) {
+                case wr_batch_t::OP_READ:  INC_INT_STATS(bytes_read, op.size); break;
+                case wr_batch_t::OP_WRITE: INC_INT_STATS(bytes_written, op.size); break;
+                case wr_batch_t::OP_CAS:   INC_INT_STATS(bytes_cas, op.size); break;
+                case wr_batch_t::OP_FAA:   INC_INT_STATS(bytes_faa, op.size); break;
+            }
+            traffic_request += op.size;
+        }
+        // completions of a QP are in order -- signaling the last WR is enough
+        last->send_flags |= IBV_SEND_SIGNALED;
+        last->wr_id = reinterpret_cast<uint64_t>(&batch);
+        post_send_list(_qps[node_id][qp_id], &wrs[i]);
+        num_chains++;
+    }
+    batch.pending() = num_chains;
+}
+
+void client_transport_t::wait_batch(wr_batch_t& batch){
+    uint32_t qp_id = GET_QP_ID;
+    struct ibv_wc wc;
+    // batches in flight share the send CQ -- charge each completion to the batch it belongs to
+    while (batch.pending() > 0) {
+        poll_completion(_send_cqs[qp_id], &wc);
+        assert(wc.wr_id != 0);
+        reinterpret_cast<wr_batch_t*>(wc.wr_id)->pending()--;
+    }
+}
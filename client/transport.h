@@ -44,6 +44,11 @@ public:
     void faa_dm(char* src, global_addr_t dest, uint64_t add, uint32_t size, bool signaled = true);
     void faa_dm_bound(char* src, global_addr_t dest, uint64_t add, uint64_t boundary, uint32_t size, bool signaled = true);
 
+    // one-sided RDMA batch
+    void post_batch(wr_batch_t& batch);
+    void post_batch_async(wr_batch_t& batch);
+    void wait_batch(wr_batch_t& batch);
+
 private:
     bool cleanup();
     bool connect();
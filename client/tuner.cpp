@@ -0,0 +1,120 @@
+#include "client/tuner.h"
+#include "system/workload.h"
+#include "system/stats.h"
+#include "index/idx_wrapper.h"
+#include "utils/helper.h"
+#include <algorithm>
+#include <string>
+
+cache_tuner_t::cache_tuner_t() {
+	for (uint32_t i=0; i<GET_WORKLOAD->get_num_indexes(); i++) {
+		INDEX* index = GET_WORKLOAD->get_index(i);
+		if (index == nullptr)
+			continue;
+		// a negative ratio means the index lacks the knob: the two-sided caches have no admission ratio
+		// under ADMIT_TINYLFU, which admits by frequency, so their ADMISSION knob is not registered
+		if (index->get_admission_ratio() >= 0)
+			_knobs.push_back({index, i, ADMISSION, INIT_STEP, 0});
+		if (index->get_rpc_ratio() >= 0)
+			_knobs.push_back({index, i, RPC, INIT_STEP, 0});
+	}
+	_cur = 0;
+	_trial = false;
+	_prev_ratio = 0;
+	_base_thr = 0;
+	_last = sample();
+}
+
+void cache_tuner_t::tune() {
+	// trace of the ratios the last window ran with
+	std::vector<std::string> names;
+	std::vector<double> ratios;
+	for (auto& knob: _knobs) {
+		names.push_back("index" + std::to_string(knob.index_id) + (knob.type == ADMISSION ? "_admission" : "_rpc"));
+		ratios.push_back(get(knob));
+	}
+	stats->record_knobs(names, ratios);
+
+	window_t total = sample();
+	if (total.commits < _last.commits) { // stats were cleared after warmup, the window is incomplete
+		if (_trial)
+			set(_knobs[_cur], _prev_ratio);
+		_trial = false;
+		_last = total;
+		return;
+	}
+	window_t window = {total.commits - _last.commits, total.hits - _last.hits, total.misses - _last.misses,
+	                   total.evictions - _last.evictions};
+	_last = total;
+	if (_knobs.empty() || window.commits == 0)
+		return;
+
+	double thr = window.commits;
+	if (_trial) {
+		auto& knob = _knobs[_cur];
+		_trial = false;
+		_cur = (_cur + 1) % _knobs.size();
+		if (thr > _base_thr * (1 + TOLERANCE)) {
+			// keep the move; this window is the base of the next one
+			_base_thr = thr;
+			move(_knobs[_cur], window);
+		}
+		else {
+			// undo it; the next window measures the base again
+			set(knob, _prev_ratio);
+			knob.dir = -knob.dir;
+			knob.step = std::max(MIN_STEP, knob.step / 2);
+		}
+		return;
+	}
+	_base_thr = thr;
+	move(_knobs[_cur], window);
+}
+
+cache_tuner_t::window_t cache_tuner_t::sample() {
+	window_t window = {0, 0, 0, 0};
+	for (uint32_t tid=0; tid<g_total_num_threads; tid++) {
+		auto int_stats = stats->_stats[tid]->_int_stats;
+		window.commits += int_stats[STAT_num_commits];
+		window.hits += int_stats[STAT_num_cache_hits];
+		window.misses += int_stats[STAT_num_cache_misses];
+		window.evictions += int_stats[STAT_num_cache_evictions];
+	}
+	return window;
+}
+
+double cache_tuner_t::get(knob_t& knob) {
+	return knob.type == ADMISSION ? knob.index->get_admission_ratio() : knob.index->get_rpc_ratio();
+}
+
+void cache_tuner_t::set(knob_t& knob, double ratio) {
+	if (knob.type == ADMISSION)
+		knob.index->set_admission_ratio(ratio);
+#if PARTITIONED
+	else
+		knob.index->set_rpc_ratio(ratio);
+#endif
+}
+
+void cache_tuner_t::move(knob_t& knob, window_t& window) {
+	if (knob.dir == 0) {
+		// the first move follows what the cache reports
+		uint64_t accesses = window.hits + window.misses;
+		double hit_rate = accesses > 0 ? 1.0 * window.hits / accesses : 0;
+		if (knob.type == ADMISSION) // admitted entries are evicted faster than they are hit: admit less
+			knob.dir = window.evictions > window.hits ? -1 : 1;
+		else // a cache that mostly misses costs more round trips than pushing the lookups down
+			knob.dir = hit_rate < 0.5 ? 1 : -1;
+	}
+	// DEX takes at most 0.99 as RPC ratio
+	double max_ratio = knob.type == ADMISSION ? 1.0 : 0.99;
+	double ratio = get(knob);
+	double next = std::min(max_ratio, std::max(0.0, ratio + knob.dir * knob.step));
+	if (next == ratio) { // at a bound
+		knob.dir = -knob.dir;
+		next = std::min(max_ratio, std::max(0.0, ratio + knob.dir * knob.step));
+	}
+	_prev_ratio = ratio;
+	set(knob, next);
+	_trial = true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "system/global.h"
+#include <vector>
+
+// Feedback controller of the compute-side index caches (ADAPTIVE_CACHE).
+// At every stats checkpoint it samples the window of the client threads (commits, cache hits/misses/evictions)
+// and hill-climbs the admission and RPC ratios of the indexes, one knob at a time:
+// a knob is moved by its step, and the move is kept if the next window commits more txns; otherwise
+// it is undone and the knob will move the other way by half the step. Knobs an index lacks are skipped.
+class cache_tuner_t {
+public:
+	cache_tuner_t();
+
+	// called by client thread 0 right after each checkpoint
+	void tune();
+
+private:
+	enum knob_type_t { ADMISSION, RPC };
+
+	struct knob_t {
+		INDEX*      index;
+		uint32_t    index_id;
+		knob_type_t type;
+		double      step;
+		int         dir; // 0 until the first move
+	};
+
+	struct window_t {
+		uint64_t commits;
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t evictions;
+	};
+
+	static constexpr double INIT_STEP = 0.2;
+	static constexpr double MIN_STEP  = 0.05;
+	static constexpr double TOLERANCE = 0.02; // a move must beat the noise between two windows
+
+	window_t sample();
+	double   get(knob_t& knob);
+	void     set(knob_t& knob, double ratio);
+	void     move(knob_t& knob, window_t& window);
+
+	std::vector<knob_t> _knobs;
+	uint32_t            _cur;        // knob that is moved next (or was moved in the last window)
+	bool                _trial;      // the last window ran with a move that is not decided yet
+	double              _prev_ratio; // value of the knob before the move
+	double              _base_thr;   // commits of the window before the move
+	window_t            _last;       // totals at the last checkpoint
+};
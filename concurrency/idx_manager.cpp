@@ -12,6 +12,7 @@
 #include "utils/packetize.h"
 #include "utils/helper.h"
 #include "client/transport.h"
+#include "transport/access_list.h"
 
 #if PARTITIONED
 ///////////////////////
@@ -26,6 +27,7 @@ void idx_manager_t::clear() {
     _access_set.clear();
     _index_access_set.clear();
     _cache_set.clear();
+    _nodes_involved.clear();
     cc_manager_t::clear();
 }
 
@@ -128,8 +130,7 @@ void idx_manager_t::register_access(uint32_t node_id, access_t type, uint64_t ke
 #endif
     
     // printf("TXN %lu register access %u (key %lu)\n", _txn->get_id().to_uint64(), _access_set.size()-1, key);
-    if (_nodes_involved.find(node_id) == _nodes_involved.end())
-        _nodes_involved.insert(node_id);
+    _nodes_involved.insert(node_id);
 }
 
 void idx_manager_t::process_cache(cc_manager_t::RowAccess* access) {
@@ -165,6 +166,13 @@ void idx_manager_t::process_cache(cc_manager_t::RowAccess* access) {
         }
     }
 
+    if (ret == 1) {
+        INC_INT_STATS(num_cache_hits, 1);
+    }
+    else {
+        INC_INT_STATS(num_cache_misses, 1);
+    }
+
     if (ret == 1)
         access->processed = true;
     else if (ret == 2) {
@@ -179,7 +187,7 @@ void idx_manager_t::process_cache(cc_manager_t::RowAccess* access) {
 
 // serialize access request for stored procedure txn
 void idx_manager_t::serialize(uint32_t node_id, std::vector<cc_manager_t::RowAccess*>& access_set, char*& data, uint32_t& size) {
-    // stored_procedure [ num | (access_type | key | index_id | table_id) * num ]
+    // stored_procedure [ num | (IndexTuple | (EvictTuple)) * num ]
     UnstructuredBuffer buffer(data);
 
     for (auto& access : _access_set) {
@@ -188,19 +196,17 @@ void idx_manager_t::serialize(uint32_t node_id, std::vector<cc_manager_t::RowAcc
     }
 
     uint32_t num = access_set.size();
-    if (num > 0) {
+    if (num > 0 && access_list_t::is_compact(message_t::type_t::REQUEST_STORED_PROCEDURE)) {
+        access_list_t::encode(access_set, buffer);
+        size = buffer.size();
+    }
+    else if (num > 0) {
         buffer.put(&num);
         for (auto& access : access_set) {
-            uint64_t cache_op = access->cache;
-            buffer.put(&cache_op);
-            buffer.put(&access->type);
-            buffer.put(&access->key);
-            buffer.put(&access->index_id);
-            buffer.put(&access->table_id);
-            buffer.put(&access->value.val);
-            if (cache_op == 2) { // cache admission + eviction
-                buffer.put(access->cache_data, sizeof(uint64_t) * 2); // evict key + evict value
-            }
+            auto tuple = buffer.put_ptr<cc_manager_t::IndexTuple>();
+            *tuple = {access->cache, access->type, access->key, access->index_id, access->table_id, access->value.val};
+            if (access->cache == 2) // cache admission + eviction
+                *buffer.put_ptr<cc_manager_t::EvictTuple>() = *reinterpret_cast<cc_manager_t::EvictTuple*>(access->cache_data);
         }
         size = buffer.size();
     }
@@ -215,7 +221,7 @@ void idx_manager_t::deserialize(uint32_t node_id, std::vector<cc_manager_t::RowA
     uint32_t num = 0;
     buffer.get(&num);
     for (auto& access: access_set) {
-        buffer.get(&access->value.val);
+        get_result(access, buffer);
         // assert(access->value.val == access->key);
         assert(access->data != nullptr);
         if (access->cache != 0) { // cache admission
@@ -241,23 +247,24 @@ void idx_manager_t::deserialize(uint32_t node_id, std::vector<cc_manager_t::RowA
 
 // serialize last access request for interactive txn
 void idx_manager_t::serialize_last(uint32_t node_id, char*& data, uint32_t& size) {
-    // interactive [ access_type | key | index_id | table_id ]
+    // interactive [ 1 | IndexTuple | (EvictTuple) ]
     UnstructuredBuffer buffer(data);
     assert(_last_access != nullptr);
     assert(_last_access->node_id == node_id);
 
     uint64_t cache_op = _last_access->cache;
-    if (cache_op != 1) {
+    if (cache_op != 1 && access_list_t::is_compact(message_t::type_t::REQUEST_INTERACTIVE)) {
+        std::vector<cc_manager_t::RowAccess*> access_set = {_last_access};
+        access_list_t::encode(access_set, buffer);
+        size = buffer.size();
+    }
+    else if (cache_op != 1) {
         uint32_t num = 1;
         buffer.put(&num);
-        buffer.put(&cache_op);
-        buffer.put(&_last_access->type);
-        buffer.put(&_last_access->key);
-        buffer.put(&_last_access->index_id);
-        buffer.put(&_last_access->table_id);
-        buffer.put(&_last_access->value.val);
+        auto tuple = buffer.put_ptr<cc_manager_t::IndexTuple>();
+        *tuple = {cache_op, _last_access->type, _last_access->key, _last_access->index_id, _last_access->table_id, _last_access->value.val};
         if (cache_op == 2) // admission + eviction
-            buffer.put(_last_access->cache_data, sizeof(uint64_t) * 2); // evict key + evict value
+            *buffer.put_ptr<cc_manager_t::EvictTuple>() = *reinterpret_cast<cc_manager_t::EvictTuple*>(_last_access->cache_data);
         size = buffer.size();
     }
     else 
@@ -272,7 +279,7 @@ void idx_manager_t::deserialize_last(uint32_t node_id, char* data, uint32_t size
     buffer.get(&num);
     assert(num == 1);
 
-    buffer.get(&_last_access->value.val);
+    get_result(_last_access, buffer);
     if (_last_access->cache != 0) { // cache admission
         auto index = GET_WORKLOAD->get_index(_last_access->index_id);
         UnstructuredBuffer cache_buffer(_last_access->cache_data);
@@ -294,6 +301,17 @@ void idx_manager_t::deserialize_last(uint32_t node_id, char* data, uint32_t size
     _cache_set.clear();
 }
 
+// reads the result of an access in place
+void idx_manager_t::get_result(cc_manager_t::RowAccess* access, UnstructuredBuffer& buffer) {
+    auto result = buffer.get_ptr<cc_manager_t::IndexResult>();
+    access->value.val = result->value;
+#if NUM_HOT_KEYS > 0
+    // the memory server flags keys it serves often; the cache will keep them from their next miss on
+    if (result->hot)
+        GET_WORKLOAD->get_index(access->index_id)->set_hot(access->key);
+#endif
+}
+
 // get last node involved for interactive txn
 uint32_t idx_manager_t::get_last_node_involved() {
     return _last_access->node_id;
@@ -342,29 +360,39 @@ void idx_manager_t::register_access(access_t type, uint64_t key, uint32_t table_
 // get response data for stored procedure txn
 void idx_manager_t::get_resp_data(uint32_t from, uint32_t to, char*& data, uint32_t &size) {
     assert(from < to);
-    // stored_procedure [ num | (data) * num ]
+    // stored_procedure [ num | IndexResult * num ]
     UnstructuredBuffer buffer(data);
     uint32_t num_tuples = to - from;
     buffer.put(&num_tuples);
-    for (uint32_t i=from; i<to; i++) {
-        auto& access = _access_set[i];
-        buffer.put(&access.value.val);
-    }
+    for (uint32_t i=from; i<to; i++)
+        put_result(&_access_set[i], buffer);
     size = buffer.size();
 }
 
 // get response data for interactive txn
 void idx_manager_t::get_resp_data_last(char*& data, uint32_t &size) {
-    // interactive [ data ]
+    // interactive [ IndexResult ]
     UnstructuredBuffer buffer(data);
     assert(_last_access != nullptr);
-    buffer.put(&_last_access->value.val);
+    put_result(_last_access, buffer);
     size = buffer.size();
 }
 
+// writes the result of an access in place
+void idx_manager_t::put_result(cc_manager_t::RowAccess* access, UnstructuredBuffer& buffer) {
+    auto result = buffer.put_ptr<cc_manager_t::IndexResult>();
+    result->value = access->value.val;
+#if NUM_HOT_KEYS > 0
+    result->hot = access->hot;
+#endif
+}
+
 row_t* idx_manager_t::process_index(cc_manager_t::RowAccess* access) {
     auto index = GET_WORKLOAD->get_index(access->index_id);
     assert(index != nullptr);
+#if NUMA_AWARE
+    count_socket_access(access);
+#endif
 
     // process index to get the row pointer
     uint64_t cache = access->cache;
@@ -380,6 +408,9 @@ row_t* idx_manager_t::process_index(cc_manager_t::RowAccess* access) {
         res = index->remove(access->key);
     else if (access->type == RD)
         res = index->lookup(access->key, access->value);
+#if NUM_HOT_KEYS > 0
+    access->hot = index->access_hot(access->key);
+#endif
 
     if (cache == 2) { // handle write-back for dirty data (eviction)
         uint64_t evict_key = reinterpret_cast<uint64_t>(access->data);
@@ -56,11 +56,13 @@ private:
     cc_manager_t::RowAccess* get_write_access(uint32_t& idx_writes);
     uint32_t   get_access_idx(uint64_t key, uint32_t table_id);
     void       commit_insdel();
+    void       get_result(cc_manager_t::RowAccess* access, UnstructuredBuffer& buffer);
+    void       put_result(cc_manager_t::RowAccess* access, UnstructuredBuffer& buffer);
 
-    std::set<uint32_t>       _nodes_involved;
+    node_set_t               _nodes_involved;
     std::vector<IndexAccess> _index_access_set;
     std::map<uint64_t, value_t> _cache_set;
-    std::vector<cc_manager_t::RowAccess>   _access_set;
+    inline_vector_t<cc_manager_t::RowAccess, INLINE_ACCESSES> _access_set;
     cc_manager_t::RowAccess*               _last_access;
     int _last_access_idx;
 };
@@ -11,6 +11,7 @@
 #include "system/query.h"
 #include "system/global_address.h"
 #include "txn/txn.h"
+#include "txn/manager.h"
 #include "storage/row.h"
 #include "storage/table.h"
 #include "storage/catalog.h"
@@ -20,6 +21,8 @@
 #include "storage/row.h"
 #include "storage/table.h"
 #include "storage/catalog.h"
+#include "transport/access_list.h"
+#include "storage/scan.h"
 
 #if !PARTITIONED
 ///////////////////////
@@ -27,10 +30,11 @@
 ///////////////////////
 
 lock_manager_t::lock_manager_t(txn_t* txn)
-    : cc_manager_t(txn), _last_access(nullptr), _last_access_idx(-1) { }
+    : cc_manager_t(txn), _last_access(nullptr), _last_access_idx(-1), _prepared(false) { }
 
 void lock_manager_t::clear() {
     _last_access = nullptr;
+    _prepared = false;
     _last_access_idx = -1;
     _access_set.clear();
     _index_access_set.clear();
@@ -134,16 +138,42 @@ void lock_manager_t::register_access(uint32_t node_id, access_t type, uint64_t k
     process_cache(access);
     
     // printf("TXN %lu register access %u (key %lu)\n", _txn->get_id().to_uint64(), _access_set.size()-1, key);
-    if (_remote_nodes.find(node_id) == _remote_nodes.end())
-        _remote_nodes.insert(node_id);
-    if (_nodes_involved.find(node_id) == _nodes_involved.end())
-        _nodes_involved.insert(node_id);
+    _remote_nodes.insert(node_id);
+    _nodes_involved.insert(node_id);
+}
+
+void lock_manager_t::register_scan(uint32_t node_id, uint64_t key, uint32_t table_id, uint32_t index_id, const scan_spec_t& spec) {
+    cc_manager_t::RowAccess ac;
+    _access_set.push_back(ac);
+    auto access = &_access_set.back();
+    _last_access = access;
+
+    access->node_id = node_id;
+    access->processed = false;
+    access->type = SCAN;
+    access->key = key;
+    access->table_id = table_id;
+    access->index_id = index_id;
+    access->cache = scan_spec_t::RANGE;
+    access->scan = new scan_spec_t(spec);
+    access->data_size = access->scan->get_result_size(GET_WORKLOAD->get_table(table_id)->get_schema());
+    access->data = new char[access->data_size];
+
+    _remote_nodes.insert(node_id);
+    _nodes_involved.insert(node_id);
 }
 
 void lock_manager_t::process_cache(cc_manager_t::RowAccess* access) {
     auto index = GET_WORKLOAD->get_index(access->index_id);
     UnstructuredBuffer buffer(access->cache_data);
     int ret = index->search_cache(access->key, buffer);
+    if (ret == 2) {
+        INC_INT_STATS(num_cache_hits, 1);
+    }
+    else {
+        INC_INT_STATS(num_cache_misses, 1);
+    }
+
     if (ret == 1) // cache miss, but admit to cache
         access->cache = static_cast<uint64_t>(1); // no cache ptr
     else if (ret == 2) { // cache hit
@@ -171,13 +201,14 @@ void lock_manager_t::serialize_commit(uint32_t node_id, char*& data, uint32_t& s
 
 // serialize access request for stored procedure txn
 void lock_manager_t::serialize(uint32_t node_id, std::vector<cc_manager_t::RowAccess*>& access_set, char*& data, uint32_t& size) {
-    // stored_procedure [ num | (access_type | key | index_id | table_id) * num ]
+    // stored_procedure [ (timestamp) | num | AccessTuple * num ]
     UnstructuredBuffer buffer(data);
-#if CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT
-    // if waitdie, add timestamp at the beginning
+#if CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || SNAPSHOT_READ
+    // if waitdie, add timestamp at the beginning (the snapshot of a read-only txn)
     uint64_t timestamp = _txn->get_ts();
     buffer.put(&timestamp);
 #endif
+    uint32_t flags = _txn->is_snapshot() ? access_list_t::SNAPSHOT : 0;
 
     for (auto& access : _access_set) {
         if ((access.node_id == node_id) && (access.processed == false)) {
@@ -186,15 +217,19 @@ void lock_manager_t::serialize(uint32_t node_id, std::vector<cc_manager_t::RowAc
         }
     }
 
-    uint32_t num = access_set.size();
+    if (access_list_t::is_compact(message_t::type_t::REQUEST_STORED_PROCEDURE)) {
+        access_list_t::encode(access_set, buffer, flags);
+        size = buffer.size();
+        return;
+    }
+    uint32_t num = access_set.size() | flags;
     buffer.put(&num);
     for (auto& access : access_set) {
         // examine client cache first
-        buffer.put(&access->type);
-        buffer.put(&access->key);
-        buffer.put(&access->index_id);
-        buffer.put(&access->table_id);
-        buffer.put(&access->cache);
+        auto tuple = buffer.put_ptr<cc_manager_t::AccessTuple>();
+        *tuple = {access->type, access->key, access->index_id, access->table_id, access->cache};
+        if (access->scan)
+            *buffer.put_ptr<scan_spec_t>() = *access->scan;
     }
     size = buffer.size();
 }
@@ -207,6 +242,10 @@ void lock_manager_t::deserialize(uint32_t node_id, std::vector<cc_manager_t::Row
     buffer.get(&num);
     for (auto& access: access_set) {
         assert(access->data != nullptr);
+        if (access->scan) {
+            get_scan_result(access, buffer);
+            continue;
+        }
         if (access->cache > 1) {  // cache hint was provided
             int stale = 0;
             buffer.get(&stale);
@@ -237,24 +276,30 @@ void lock_manager_t::deserialize(uint32_t node_id, std::vector<cc_manager_t::Row
 
 // serialize last access request for interactive txn
 void lock_manager_t::serialize_last(uint32_t node_id, char*& data, uint32_t& size) {
-    // interactive [ access_type | key | index_id | table_id ]
+    // interactive [ (timestamp) | 1 | AccessTuple ]
     UnstructuredBuffer buffer(data);
     assert(_last_access != nullptr);
     assert(_last_access->node_id == node_id);
 
-#if CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT
+#if CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || SNAPSHOT_READ
     uint64_t timestamp = _txn->get_ts();
-    // if waitdie, add timestamp at the beginning
+    // if waitdie, add timestamp at the beginning (the snapshot of a read-only txn)
     buffer.put(&timestamp);
 #endif
+    uint32_t flags = _txn->is_snapshot() ? access_list_t::SNAPSHOT : 0;
 
-    uint32_t num = 1;
+    if (access_list_t::is_compact(message_t::type_t::REQUEST_INTERACTIVE)) {
+        std::vector<cc_manager_t::RowAccess*> access_set = {_last_access};
+        access_list_t::encode(access_set, buffer, flags);
+        size = buffer.size();
+        return;
+    }
+    uint32_t num = 1 | flags;
     buffer.put(&num);
-    buffer.put(&_last_access->type);
-    buffer.put(&_last_access->key);
-    buffer.put(&_last_access->index_id);
-    buffer.put(&_last_access->table_id);
-    buffer.put(&_last_access->cache);
+    auto tuple = buffer.put_ptr<cc_manager_t::AccessTuple>();
+    *tuple = {_last_access->type, _last_access->key, _last_access->index_id, _last_access->table_id, _last_access->cache};
+    if (_last_access->scan)
+        *buffer.put_ptr<scan_spec_t>() = *_last_access->scan;
     size = buffer.size();
 }
 
@@ -266,6 +311,11 @@ void lock_manager_t::deserialize_last(uint32_t node_id, char* data, uint32_t siz
     buffer.get(&num);
     assert(num == 1);
 
+    if (_last_access->scan) {
+        get_scan_result(_last_access, buffer);
+        assert(buffer.size() == size);
+        return;
+    }
     if (_last_access->cache > 1) {  // cache hint was provided
         int stale = 0;
         buffer.get(&stale);
@@ -292,6 +342,19 @@ void lock_manager_t::deserialize_last(uint32_t node_id, char* data, uint32_t siz
     assert(buffer.size() == size);
 }
 
+// copy the result of a range scan out of the response
+void lock_manager_t::get_scan_result(cc_manager_t::RowAccess* access, UnstructuredBuffer& buffer) {
+    // [ rows | next key | (key | projected columns) * rows ]
+    auto schema = GET_WORKLOAD->get_table(access->table_id)->get_schema();
+    char* ptr = nullptr;
+    buffer.get(ptr, scan_spec_t::HEADER_SIZE);
+    uint32_t rows = *reinterpret_cast<uint32_t*>(ptr);
+    uint32_t size = scan_spec_t::HEADER_SIZE + rows * access->scan->get_entry_size(schema);
+    assert(size <= access->data_size);
+    memcpy(access->data, ptr, size);
+    buffer.get(ptr, size - scan_spec_t::HEADER_SIZE);
+}
+
 // get last node involved for interactive txn
 uint32_t lock_manager_t::get_last_node_involved() {
     return _last_access->node_id;
@@ -318,6 +381,10 @@ void lock_manager_t::abort() {
             delete[] access.data;
             access.data = nullptr;
         }
+        if (access.scan) {
+            delete access.scan;
+            access.scan = nullptr;
+        }
         if (access.cache_data) {
             delete[] access.cache_data;
             access.cache_data = nullptr;
@@ -360,15 +427,71 @@ void lock_manager_t::register_access(access_t type, uint64_t key, uint32_t table
         access->data = nullptr;
 }
 
+void lock_manager_t::register_scan(uint64_t key, uint32_t table_id, uint32_t index_id, const scan_spec_t& spec) {
+    assert(TRANSPORT == TWO_SIDED);
+    // the scan itself takes no lock; the rows it visits follow it as reads
+    uint32_t idx = _access_set.size();
+    cc_manager_t::RowAccess ac;
+    _access_set.push_back(ac);
+    auto access = &_access_set.back();
+    access->node_id = g_node_id;
+    access->type = SCAN;
+    access->key = key;
+    access->table_id = table_id;
+    access->index_id = index_id;
+    access->value = 0;
+    access->cache = scan_spec_t::RANGE;
+    access->data_size = 0;
+    access->data = nullptr;
+    access->scan = new scan_spec_t(spec);
+
+    auto index = GET_WORKLOAD->get_index(index_id);
+    uint32_t data_size = GET_WORKLOAD->get_table(table_id)->get_schema()->get_tuple_size();
+    std::vector<value_t> values(spec.limit);
+    value_t* ptr = values.data();
+    int num = index->scan(key, spec.limit, ptr);
+    uint32_t visited = 0;
+    for (int i=0; i<num; i++) {
+        uint64_t row_key = GET_WORKLOAD->get_primary_key(values[i].row, table_id);
+        if (row_key > spec.end_key)
+            break;
+        cc_manager_t::RowAccess row_ac;
+        _access_set.push_back(row_ac);
+        auto row_access = &_access_set.back();
+        row_access->node_id = g_node_id;
+        row_access->type = RD;
+        row_access->key = row_key;
+        row_access->table_id = table_id;
+        row_access->index_id = index_id;
+        row_access->value = values[i]; // no index lookup in get_row()
+        row_access->cache = 0;
+        row_access->data_size = data_size;
+        row_access->data = nullptr;
+        visited++;
+    }
+    // this node holds the keys up to the next partition bound; past it, the scan continues on the next node
+    auto scan = _access_set[idx].scan;
+    uint64_t partition_end = GET_WORKLOAD->get_partition_by_node(g_node_id + 1, table_id);
+    // from here on, limit is the number of rows registered after the scan and end_key the key to resume from (0 if none)
+    scan->end_key = scan->get_next_key(visited, partition_end);
+    scan->limit = visited;
+    _last_access = &_access_set[idx];
+}
+
 // get response data for stored procedure txn
 void lock_manager_t::get_resp_data(uint32_t from, uint32_t to, char*& data, uint32_t &size) {
     assert(from < to);
     // stored_procedure [ num | (data) * num ]
     UnstructuredBuffer buffer(data);
-    uint32_t num_tuples = to - from;
-    buffer.put(&num_tuples);
+    auto num_tuples = buffer.put_ptr<uint32_t>();
+    *num_tuples = 0;
     for (uint32_t i = from; i < to; i++) {
         auto& access = _access_set[i];
+        (*num_tuples)++;
+        if (access.scan) {
+            i += put_scan_result(i, buffer);
+            continue;
+        }
         if (access.cache == 1) { // cache admission
             buffer.put(&access.value.val);
         }
@@ -382,7 +505,7 @@ void lock_manager_t::get_resp_data(uint32_t from, uint32_t to, char*& data, uint
                 buffer.put(&access.value.val);
             }
         }
-        char* ptr = access.value.row->get_data();
+        char* ptr = _txn->is_snapshot() ? access.data : access.value.row->get_data();
         buffer.put(ptr, access.data_size);
     }
     size = buffer.size();
@@ -393,6 +516,11 @@ void lock_manager_t::get_resp_data_last(char*& data, uint32_t &size) {
     // interactive [ data ]
     UnstructuredBuffer buffer(data);
     assert(_last_access != nullptr);
+    if (_last_access->scan) {
+        put_scan_result(_last_access - _access_set.begin(), buffer);
+        size = buffer.size();
+        return;
+    }
     if (_last_access->cache == 1) { // cache admission
         buffer.put(&_last_access->value.val);
     }
@@ -407,11 +535,40 @@ void lock_manager_t::get_resp_data_last(char*& data, uint32_t &size) {
         }
     }
 
-    char* ptr = _last_access->value.row->get_data();
+    char* ptr = _txn->is_snapshot() ? _last_access->data : _last_access->value.row->get_data();
     buffer.put(ptr, _last_access->data_size);
     size = buffer.size();
 }
 
+// write the result of the range scan at idx from the rows registered after it; returns the number of those rows
+uint32_t lock_manager_t::put_scan_result(uint32_t idx, UnstructuredBuffer& buffer) {
+    // [ rows | next key | (key | projected columns) * rows ]
+    auto& access = _access_set[idx];
+    auto spec = access.scan;
+    auto schema = GET_WORKLOAD->get_table(access.table_id)->get_schema();
+    uint32_t entry_size = spec->get_entry_size(schema);
+    uint32_t capacity = MAX_MESSAGE_SIZE - (sizeof(message_t) - sizeof(char*));
+    auto rows = buffer.put_ptr<uint32_t>();
+    auto next_key = buffer.put_ptr<uint64_t>();
+    *rows = 0;
+    *next_key = spec->end_key;
+    char entry[entry_size];
+    for (uint32_t i=1; i<=spec->limit; i++) {
+        auto& row_access = _access_set[idx + i];
+        if (buffer.size() + entry_size > capacity) { // the response is full
+            *next_key = row_access.key;
+            break;
+        }
+        char* data = _txn->is_snapshot() ? row_access.data : row_access.value.row->get_data();
+        if (!spec->match(schema, data))
+            continue;
+        buffer.put(entry, spec->project(schema, row_access.key, data, entry));
+        (*rows)++;
+    }
+    INC_INT_STATS(num_scan_rows, *rows);
+    return spec->limit;
+}
+
 void lock_manager_t::prefetch_row(char* ptr, uint32_t size) {
     // uint32_t num = size / 64; // get the number of cache lines to prefetch
     uint32_t num = 4;
@@ -423,6 +580,9 @@ void lock_manager_t::prefetch_row(char* ptr, uint32_t size) {
 row_t* lock_manager_t::process_index(cc_manager_t::RowAccess* access) {
     auto index = GET_WORKLOAD->get_index(access->index_id);
     assert(index != nullptr);
+#if NUMA_AWARE
+    count_socket_access(access);
+#endif
 
     // process index to get the row pointer
     uint64_t cache = access->cache;
@@ -503,9 +663,33 @@ RC lock_manager_t::get_row(cc_manager_t::RowAccess* access) {
     }
 
     assert(access != nullptr); 
-    row_t* row = process_index(access);
+    if (access->scan) { // the rows of a range scan are registered after it
+        access->processed = true;
+        return RCOK;
+    }
+    uint64_t starttime = get_sys_clock();
+    // rows visited by a range scan already know their row
+    row_t* row = access->value.row ? access->value.row : process_index(access);
+    uint64_t endtime = get_sys_clock();
+    INC_TIME_STATS(time_index, endtime - starttime);
+#if SNAPSHOT_READ
+    if (_txn->is_snapshot()) { // read-only txn, copy the version at its timestamp instead of locking the row
+        assert(access->type == RD || access->type == SCAN);
+        access->data = new char[access->data_size];
+        if (!row->versions.read(_txn->get_ts(), row->get_data(), access->data, access->data_size)) {
+            INC_INT_STATS(num_snapshot_aborts, 1);
+            _txn->set_state(txn_t::state_t::ABORTING);
+            cleanup(ABORT);
+            return ABORT;
+        }
+        INC_INT_STATS(num_snapshot_reads, 1);
+        access->processed = true;
+        return RCOK;
+    }
+#endif
     auto lock_type = (access->type == RD) ? lock_type_t::LOCK_SH : lock_type_t::LOCK_EX;
     rc = row->manager->lock_get(lock_type, _txn);
+    INC_TIME_STATS(time_lock, get_sys_clock() - endtime);
     if (rc == ABORT) {
         _txn->set_state(txn_t::state_t::ABORTING);
         cleanup(rc);
@@ -616,7 +800,19 @@ RC lock_manager_t::process_prepare(char* data, uint32_t size) {
         }
         assert(size == buffer.size());
     }
-    
+
+#if SNAPSHOT_READ
+    // lower bound of the commit timestamp; the rows written stay PENDING until commit or abort
+    uint64_t bound = 0;
+    for (auto& access : _access_set) {
+        if (access.value.row == nullptr) // range scan
+            continue;
+        auto& versions = access.value.row->versions;
+        bound = std::max(bound, access.type == WR ? versions.prepare_write() : versions.prepare_read());
+    }
+    _txn->set_commit_ts(bound);
+    _prepared = true;
+#endif
     return RCOK;
 }
 
@@ -657,16 +853,16 @@ void lock_manager_t::cleanup(RC rc) {
         row_t* row = reinterpret_cast<row_t*>(buffer);
         // row_t* row = reinterpret_cast<row_t*>(buffer + offset);
         global_addr_t row_addr = access->value.addr;
+        // auto row_man = new ((ROW_MAN*)&row->manager) ROW_MAN();
+        auto row_man = (ROW_MAN*)&row->manager;
         if (access->type == WR && rc == COMMIT && processed) {
             auto schema = GET_WORKLOAD->get_table(access->table_id)->get_schema();
             row->copy(schema, access->data);
-            global_addr_t write_addr = GADD(row_addr, 16); // skip lock part
-            transport->write(reinterpret_cast<char*>(row) + 16, write_addr, access->data_size, i==(_access_set.size()-1) ? true : false);
+            // write back the data and release the lock with one doorbell
+            row_man->lock_release(ltype, _txn, row_addr, row->data, access->data_size);
         }
-        // auto row_man = new ((ROW_MAN*)&row->manager) ROW_MAN();
-        auto row_man = (ROW_MAN*)&row->manager;
-        if (processed)
-            row_man->lock_release(ltype, _txn, access->value.addr);
+        else if (processed)
+            row_man->lock_release(ltype, _txn, row_addr);
 
         if (access->cache_data) {
             delete[] access->cache_data;
@@ -680,12 +876,24 @@ void lock_manager_t::cleanup(RC rc) {
     }
 #else // TRANSPORT == TWO_SIDED
     for (auto & access : _access_set) {
-        if (g_is_server) { 
+        if (g_is_server && !_txn->is_snapshot()) { // a snapshot read holds no lock
             auto ltype = (access.type == RD) ? lock_type_t::LOCK_SH : lock_type_t::LOCK_EX;
+#if SNAPSHOT_READ
+            auto row = access.value.row;
+            if (row != nullptr && rc == COMMIT) {
+                if (access.type == WR)
+                    row->versions.commit_write(_txn->get_commit_ts(), row->get_data(), access.data, access.data_size);
+                else
+                    row->versions.commit_read(_txn->get_commit_ts());
+            }
+            else if (row != nullptr && _prepared && access.type == WR)
+                row->versions.abort_write();
+#else
             if (access.type == WR && rc == COMMIT) {
                 auto schema = GET_WORKLOAD->get_table(access.table_id)->get_schema();
                 access.value.row->copy(schema, access.data);
             }
+#endif
             if (access.value.row != nullptr)
                 access.value.row->manager->lock_release(ltype, _txn, access.value.addr);
         }
@@ -697,6 +905,10 @@ void lock_manager_t::cleanup(RC rc) {
             delete[] access.data;
             access.data = nullptr;
         }
+        if (access.scan) {
+            delete access.scan;
+            access.scan = nullptr;
+        }
     }
 #endif
     clear();
@@ -711,27 +923,7 @@ void lock_manager_t::cleanup(RC rc) {
 // get row data after acquiring its lock for stored procedure txn
 void lock_manager_t::get_resp_data() {
     assert(TRANSPORT == ONE_SIDED);
-    char* buffer = transport->get_buffer();
-    uint32_t offset = 0;
-    for (uint32_t i=0; i<_access_set.size(); i++) {
-        auto access = &_access_set[i];
-        global_addr_t row_addr = access->value.addr;
-        global_addr_t data_addr = GADD(row_addr, 16); // skip lock part
-        // printf("[data %u] row_addr %lu data_addr %lu\n", i, row_addr.addr, data_addr.addr);
-        char* data = buffer + offset;
-        uint32_t data_size = access->data_size;
-        assert(data_size > 0 && access->data != nullptr);
-        transport->read(data, data_addr, data_size);
-        offset += data_size;
-    }
-
-    offset = 0;
-    for (auto& access: _access_set) {
-        assert(access.data != nullptr);
-        char* data = buffer + offset;
-        memcpy(access.data, buffer + offset, access.data_size);
-        offset += access.data_size;
-    }
+    // row data has already been read along with its lock in get_remote_row()
 }
 
 // get data after acquiring its lock for interactive txn
@@ -742,6 +934,7 @@ void lock_manager_t::get_resp_data(uint32_t access_idx) {
     global_addr_t row_addr = access->value.addr;
     global_addr_t data_addr = GADD(row_addr, 16); // skip lock part
     assert(access->data_size > 0 && access->data != nullptr);
+    txn_manager_t::yield_scope_t scope(global_manager->get_txn_manager());
     transport->read(buffer, data_addr, access->data_size);
     memcpy(access->data, buffer, access->data_size);
 }
@@ -758,7 +951,9 @@ RC lock_manager_t::get_remote_row(uint32_t access_idx) {
     auto index = GET_WORKLOAD->get_index(access->index_id);
     row_t* row = reinterpret_cast<row_t*>(transport->get_buffer());
     value_t value;
+    uint64_t starttime = get_sys_clock();
     bool found = index->lookup(access->key, value);
+    INC_TIME_STATS(time_index, get_sys_clock() - starttime);
     if (!found) { // this is an insert
         uint64_t key = access->key;
         value.addr = GET_WORKLOAD->rpc_alloc(access->node_id, sizeof(row_t));
@@ -779,11 +974,20 @@ RC lock_manager_t::get_remote_row(uint32_t access_idx) {
 
     auto lock_type = (access->type == RD) ? lock_type_t::LOCK_SH : lock_type_t::LOCK_EX;
     auto row_man = (ROW_MAN*)&row->manager;
+    // the row data is read along with the lock
+    starttime = get_sys_clock();
+#if TRANSPORT == ONE_SIDED
+    rc = row_man->lock_get(lock_type, _txn, access->value.addr, row->data, access->data_size);
+#else // two-sided row managers do not read the row data
     rc = row_man->lock_get(lock_type, _txn, access->value.addr);
+#endif
+    INC_TIME_STATS(time_lock, get_sys_clock() - starttime);
     if (rc != ABORT) {
         access->processed = true;
         if (rc == WAIT)
             access->waiting = true;
+        if (access->data)
+            memcpy(access->data, row->data, access->data_size);
     }
 
     return rc;
@@ -800,7 +1004,9 @@ RC lock_manager_t::get_remote_row(cc_manager_t::RowAccess* access) {
     auto index = GET_WORKLOAD->get_index(access->index_id);
     row_t* row = reinterpret_cast<row_t*>(transport->get_buffer());
     value_t value;
+    uint64_t starttime = get_sys_clock();
     bool found = index->lookup(access->key, value);
+    INC_TIME_STATS(time_index, get_sys_clock() - starttime);
     if (!found) { // this is an insert
         uint64_t key = access->key;
         value.addr = GET_WORKLOAD->rpc_alloc(access->node_id, sizeof(row_t));
@@ -820,11 +1026,20 @@ RC lock_manager_t::get_remote_row(cc_manager_t::RowAccess* access) {
 
     auto lock_type = (access->type == RD) ? lock_type_t::LOCK_SH : lock_type_t::LOCK_EX;
     auto row_man = (ROW_MAN*)&row->manager;
+    // the row data is read along with the lock
+    starttime = get_sys_clock();
+#if TRANSPORT == ONE_SIDED
+    rc = row_man->lock_get(lock_type, _txn, access->value.addr, row->data, access->data_size);
+#else // two-sided row managers do not read the row data
     rc = row_man->lock_get(lock_type, _txn, access->value.addr);
+#endif
+    INC_TIME_STATS(time_lock, get_sys_clock() - starttime);
     if (rc != ABORT) {
         access->processed = true;
         if (rc == WAIT)
             access->waiting = true;
+        if (access->data)
+            memcpy(access->data, row->data, access->data_size);
     }
 
     return rc;
@@ -11,6 +11,8 @@ public:
 
     void       register_access(uint32_t node_id, access_t type, uint64_t key, uint32_t table_id, uint32_t index_id, uint64_t value=0);
     void       register_access(access_t type, uint64_t key, uint32_t table_id, uint32_t index_id, uint64_t cache, uint64_t value=0, uint64_t evict_key=0, uint64_t evict_value=0);
+    void       register_scan(uint32_t node_id, uint64_t key, uint32_t table_id, uint32_t index_id, const scan_spec_t& spec);
+    void       register_scan(uint64_t key, uint32_t table_id, uint32_t index_id, const scan_spec_t& spec);
 
     void       get_resp_data_last(char*& data, uint32_t& size);
     void       get_resp_data(uint32_t from, uint32_t to, char*& data, uint32_t& size);
@@ -58,13 +60,16 @@ private:
     uint32_t   get_access_idx(uint64_t key, uint32_t table_id);
     void       commit_insdel();
     void       prefetch_row(char* ptr, uint32_t size);
+    uint32_t   put_scan_result(uint32_t idx, UnstructuredBuffer& buffer);
+    void       get_scan_result(cc_manager_t::RowAccess* access, UnstructuredBuffer& buffer);
 
-    std::set<uint32_t>       _nodes_involved; // for commit
-    std::set<uint32_t>       _remote_nodes;   // for txn requests
+    node_set_t               _nodes_involved; // for commit
+    node_set_t               _remote_nodes;   // for txn requests
     std::vector<IndexAccess> _index_access_set;
-    std::vector<cc_manager_t::RowAccess>   _access_set;
+    inline_vector_t<cc_manager_t::RowAccess, INLINE_ACCESSES> _access_set;
     cc_manager_t::RowAccess*               _last_access;
     int _last_access_idx;
+    bool                     _prepared; // rows written are PENDING in their versions (SNAPSHOT_READ)
 };
 
 #endif
\ No newline at end of file
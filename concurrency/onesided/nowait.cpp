@@ -3,37 +3,55 @@
 #include "system/manager.h"
 #include "utils/helper.h"
 #include "txn/txn.h"
+#include "txn/manager.h"
 
 namespace onesided{
 
-RC nowait_t::lock_get(lock_type_t type, txn_t* txn, global_addr_t addr) {
+RC nowait_t::lock_get(lock_type_t type, txn_t* txn, global_addr_t addr, char* data, uint32_t size) {
+    txn_manager_t::yield_scope_t scope(global_manager->get_txn_manager()); // the other coroutines run during round trips
     char* ptr = reinterpret_cast<char*>(&_lock);
-RETRY:
+    global_addr_t data_addr = GADD(addr, sizeof(nowait_t));
+    // the data read rides on the first CAS only; a contended SH lock spins on the CAS alone
+    bool read_batched = (data != nullptr);
     transport->read(ptr, addr, sizeof(_lock));
+RETRY:
     bool conflict = _lock.conflict(type);
     if(conflict) // lock conflicts -- cannot acquire a lock
         return ABORT;
 
     lock_t cur_lock = _lock;
+    transport_t::wr_batch_t batch;
     if(type == LOCK_SH){
         assert(cur_lock.writer == 0);
         lock_t new_lock(cur_lock.readers + 1, 0);
-        if(!transport->cas(ptr, addr, cur_lock.val, new_lock.val, sizeof(_lock)))
-            goto RETRY;
+        batch.cas(ptr, addr, cur_lock.val, new_lock.val, sizeof(_lock));
     }
     else{
         assert(cur_lock.writer == 0 && cur_lock.readers == 0);
         lock_t new_lock(0, 1);
-        if(!transport->cas(ptr, addr, cur_lock.val, new_lock.val, sizeof(_lock)))
-            return ABORT;
+        batch.cas(ptr, addr, cur_lock.val, new_lock.val, sizeof(_lock));
+    }
+    if(read_batched) // the data read is ordered after the CAS
+        batch.read(data, data_addr, size);
+    transport->post_batch(batch);
+    if(!batch.cas_succeeded(0)){
+        if(type == LOCK_SH){ // a failed CAS has returned the current lock
+            read_batched = false;
+            goto RETRY;
+        }
+        return ABORT;
     }
+    if(data && !read_batched)
+        transport->read(data, data_addr, size);
     return RCOK;
 }
 
-void nowait_t::lock_release(lock_type_t type, txn_t* txn, global_addr_t addr) {
+void nowait_t::lock_release(lock_type_t type, txn_t* txn, global_addr_t addr, char* data, uint32_t size) {
+    txn_manager_t::yield_scope_t scope(global_manager->get_txn_manager()); // the other coroutines run during round trips
     char* ptr = reinterpret_cast<char*>(&_lock);
 RETRY:
 	if (type == LOCK_SH) {
+        assert(data == nullptr);
         transport->read(ptr, addr, sizeof(_lock));
         lock_t cur_lock = _lock;
         assert(cur_lock.readers > 0 && cur_lock.writer == 0);
@@ -43,8 +61,12 @@ RETRY:
         // transport->faa(ptr, addr, static_cast<uint64_t>(-1), sizeof(_lock));
     }
     else{ // LOCK_EX
+        transport_t::wr_batch_t batch;
+        if (data) // write back the data before the lock is released
+            batch.write(data, GADD(addr, sizeof(nowait_t)), size);
         memset(&_lock, 0, sizeof(_lock));
-        transport->write(ptr, addr, sizeof(_lock));
+        batch.write(ptr, addr, sizeof(_lock));
+        transport->post_batch(batch);
     }
 }
 }
\ No newline at end of file
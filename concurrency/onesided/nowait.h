@@ -12,8 +12,10 @@ class nowait_t {
 public:
 	nowait_t(): _lock() { }
 
-	RC lock_get(lock_type_t type, txn_t* txn, global_addr_t addr);
-	void lock_release(lock_type_t type, txn_t* txn, global_addr_t addr);
+	// data (if given) is the row data that follows the lock; it is read (written back) in the
+	// same doorbell as the CAS that acquires (the write that releases) the lock
+	RC   lock_get(lock_type_t type, txn_t* txn, global_addr_t addr, char* data=nullptr, uint32_t size=0);
+	void lock_release(lock_type_t type, txn_t* txn, global_addr_t addr, char* data=nullptr, uint32_t size=0);
 
 private:
 	lock_t   _lock;
@@ -2,37 +2,63 @@
 #include "utils/helper.h"
 #include "system/stats.h"
 #include "txn/txn.h"
+#include "txn/manager.h"
+#include "system/manager.h"
 #include "client/transport.h"
 
 namespace onesided{
 
-RC waitdie_t::lock_get(lock_type_t type, txn_t* txn, global_addr_t addr){
+RC waitdie_t::lock_get(lock_type_t type, txn_t* txn, global_addr_t addr, char* data, uint32_t size){
+    txn_manager_t::yield_scope_t scope(global_manager->get_txn_manager()); // the other coroutines run during round trips
     bool retry = false;
     uint64_t timestamp = txn->get_ts();
     global_addr_t lock_addr = addr;
     global_addr_t ts_addr = GADD(addr, sizeof(_lock));
+    global_addr_t data_addr = GADD(addr, sizeof(waitdie_t));
     char* lock_ptr = reinterpret_cast<char*>(&_lock);
     char* ts_ptr = reinterpret_cast<char*>(&_timestamp);
+    // a failed SH CAS returns the current lock, so a contended lock spins on the CAS alone;
+    // the data read rides on a CAS only if the lock and timestamp were read right before it
+    bool spinning;
 RETRY_LOCK:
+    spinning = false;
     transport->read(lock_ptr, lock_addr, sizeof(waitdie_t));
+RETRY_CAS:
     bool conflict = _lock.conflict(type);
     if(conflict){ // lock conflicts -- cannot acquire a lock
+        if(spinning) // the timestamp of the owner is needed
+            goto RETRY_LOCK;
         if(timestamp < _timestamp){ // new txn has higher priority, can wait
             txn->set_state(txn_t::state_t::WAITING);
             PAUSE;
+            global_manager->yield(); // the holder may be another coroutine of this thread
             goto RETRY_LOCK;
         }
         txn->set_state(txn_t::state_t::ABORTING);
         return ABORT;
     }
 
-    // no conflict -- acquire the lock
+    // no conflict -- acquire the lock (the data read is ordered after the CAS)
     lock_t cur_lock = _lock;
+    transport_t::wr_batch_t batch;
     if(type == LOCK_SH){
         assert(cur_lock.writer == 0);
         lock_t new_lock(cur_lock.readers + 1, 0);
-        if(!transport->cas(lock_ptr, lock_addr, cur_lock.val, new_lock.val, sizeof(_lock)))
-            goto RETRY_LOCK;
+        batch.cas(lock_ptr, lock_addr, cur_lock.val, new_lock.val, sizeof(_lock));
+        if(data && !spinning)
+            batch.read(data, data_addr, size);
+        transport->post_batch(batch);
+        if(!batch.cas_succeeded(0)){
+            spinning = true;
+            goto RETRY_CAS;
+        }
+        if(spinning){ // read the timestamp and the data after the lock is acquired
+            transport_t::wr_batch_t reads;
+            reads.read(ts_ptr, ts_addr, sizeof(_timestamp));
+            if(data)
+                reads.read(data, data_addr, size);
+            transport->post_batch(reads);
+        }
     RETRY_TIMESTAMP:
         if(_timestamp == 0 || timestamp < _timestamp){ // update timestamp
             if(!transport->cas(ts_ptr, ts_addr, _timestamp, timestamp, sizeof(_timestamp))){
@@ -44,7 +70,11 @@ RETRY_LOCK:
     else{ // LOCK_EX
         assert(cur_lock.writer == 0 && cur_lock.readers == 0);
         lock_t new_lock(0, 1);
-        if(!transport->cas(lock_ptr, lock_addr, cur_lock.val, new_lock.val, sizeof(_lock)))
+        batch.cas(lock_ptr, lock_addr, cur_lock.val, new_lock.val, sizeof(_lock));
+        if(data)
+            batch.read(data, data_addr, size);
+        transport->post_batch(batch);
+        if(!batch.cas_succeeded(0))
             return ABORT;
         _timestamp = timestamp;
         transport->write(ts_ptr, ts_addr, sizeof(_timestamp));
@@ -54,7 +84,8 @@ RETRY_LOCK:
     return RCOK;
 }
 
-void waitdie_t::lock_release(lock_type_t type, txn_t* txn, global_addr_t addr){
+void waitdie_t::lock_release(lock_type_t type, txn_t* txn, global_addr_t addr, char* data, uint32_t size){
+    txn_manager_t::yield_scope_t scope(global_manager->get_txn_manager()); // the other coroutines run during round trips
     global_addr_t lock_addr = addr;
     global_addr_t ts_addr = GADD(addr, sizeof(_lock));
     uint64_t timestamp = txn->get_ts();
@@ -63,6 +94,7 @@ void waitdie_t::lock_release(lock_type_t type, txn_t* txn, global_addr_t addr){
     char* ts_ptr = reinterpret_cast<char*>(&_timestamp);
 
     if(type == LOCK_SH){
+        assert(data == nullptr);
         // first update timestamp
         transport->read(ts_ptr, ts_addr, sizeof(_timestamp));
         if(_timestamp == timestamp){
@@ -73,9 +105,13 @@ void waitdie_t::lock_release(lock_type_t type, txn_t* txn, global_addr_t addr){
         transport->faa(lock_ptr, addr, static_cast<uint64_t>(-1), sizeof(_lock));
     }
     else{ // LOCK_EX
+        transport_t::wr_batch_t batch;
+        if(data) // write back the data before the lock is released
+            batch.write(data, GADD(addr, sizeof(waitdie_t)), size);
         _timestamp = 0;
         memset(&_lock, 0, sizeof(_lock));
-        transport->write(lock_ptr, addr, sizeof(_lock) + sizeof(_timestamp));
+        batch.write(lock_ptr, addr, sizeof(_lock) + sizeof(_timestamp));
+        transport->post_batch(batch);
     }
 }
 }
\ No newline at end of file
@@ -14,8 +14,9 @@ class waitdie_t {
 public:
 	waitdie_t(): _lock(), _timestamp(0) { }
 
-	RC   lock_get(lock_type_t type, txn_t* txn, global_addr_t addr);
-	void lock_release(lock_type_t type, txn_t* txn, global_addr_t addr);
+	// data: row data that follows the lock, piggybacked on the lock operations (see nowait_t)
+	RC   lock_get(lock_type_t type, txn_t* txn, global_addr_t addr, char* data=nullptr, uint32_t size=0);
+	void lock_release(lock_type_t type, txn_t* txn, global_addr_t addr, char* data=nullptr, uint32_t size=0);
 
 private:
 	lock_t   _lock;
@@ -0,0 +1,59 @@
+#include "concurrency/twosided/lock_node.h"
+#include "txn/txn.h"
+
+#if TRANSPORT == TWO_SIDED
+namespace twosided {
+
+// nodes are never returned to the system; a freed node goes to the pool of the freeing thread
+static thread_local lock_node_t* free_nodes = nullptr;
+
+lock_node_t* lock_node_t::alloc(txn_t* txn, const void* lock, lock_type_t type) {
+	if (free_nodes == nullptr) {
+		auto slab = new lock_node_t[NODES_PER_SLAB];
+		for (uint32_t i=0; i<NODES_PER_SLAB-1; i++)
+			slab[i].next = &slab[i+1];
+		slab[NODES_PER_SLAB-1].next = nullptr;
+		free_nodes = slab;
+	}
+
+	auto node = free_nodes;
+	free_nodes = node->next;
+	node->next = nullptr;
+	node->txn = txn;
+	node->lock = lock;
+	node->ts = txn->get_ts();
+	node->type = type;
+	node->state.store(WAITING, std::memory_order_relaxed);
+	node->txn_next = txn->get_lock_nodes();
+	txn->set_lock_nodes(node);
+	return node;
+}
+
+lock_node_t* lock_node_t::find(txn_t* txn, const void* lock, lock_type_t type) {
+	for (auto node = txn->get_lock_nodes(); node != nullptr; node = node->txn_next) {
+		if (node->lock == lock && node->type == type)
+			return node;
+	}
+	return nullptr;
+}
+
+void lock_node_t::free(lock_node_t* node) {
+	auto txn = node->txn;
+	if (txn->get_lock_nodes() == node)
+		txn->set_lock_nodes(node->txn_next);
+	else {
+		auto prev = txn->get_lock_nodes();
+		while (prev->txn_next != node)
+			prev = prev->txn_next;
+		prev->txn_next = node->txn_next;
+	}
+
+	node->txn = nullptr;
+	node->lock = nullptr;
+	node->txn_next = nullptr;
+	node->next = free_nodes;
+	free_nodes = node;
+}
+
+}
+#endif
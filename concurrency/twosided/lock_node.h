@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include "system/global.h"
+
+class txn_t;
+namespace twosided {
+
+// Node of the intrusive lock lists used by lockword_t.
+// Nodes are preallocated in per-thread pools; every node in use is also chained
+// to its txn so that lock_release() can tell whether the txn holds or waits for the lock.
+struct lock_node_t {
+	enum state_t : uint32_t { WAITING, GRANTED, REMOVED };
+
+	lock_node_t*         next;     // next node in the wait (or owner) list of the lock
+	lock_node_t*         txn_next; // next node used by the same txn
+	txn_t*               txn;
+	const void*          lock;
+	uint64_t             ts;
+	lock_type_t          type;
+	std::atomic<state_t> state;
+
+	static lock_node_t* alloc(txn_t* txn, const void* lock, lock_type_t type);
+	// a txn may request a lock more than once with different types; release the node of the given type
+	static lock_node_t* find(txn_t* txn, const void* lock, lock_type_t type);
+	static void         free(lock_node_t* node);
+
+	static constexpr uint32_t NODES_PER_SLAB = 256;
+};
+
+}
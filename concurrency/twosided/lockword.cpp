@@ -0,0 +1,332 @@
+#include "concurrency/twosided/lockword.h"
+#include "concurrency/twosided/common.h"
+#include "utils/helper.h"
+#include "txn/txn.h"
+
+#if TRANSPORT == TWO_SIDED
+namespace twosided {
+
+template <uint32_t ALG>
+uint64_t lockword_t<ALG>::grant(uint64_t w, lock_type_t type, uint64_t ts) {
+	uint64_t owners = get_owners(w) + 1;
+	assert(owners <= MAX_OWNERS);
+	uint64_t oldest = std::min(get_ts(w), pack_ts(ts));
+	return make(type, owners, oldest, w & (LATCH_BIT | WAITERS_BIT));
+}
+
+template <uint32_t ALG>
+uint64_t lockword_t<ALG>::revoke(uint64_t w) {
+	uint64_t owners = get_owners(w);
+	assert(owners > 0);
+	if (--owners == 0)
+		return make(LOCK_NONE, 0, TS_NONE, w & (LATCH_BIT | WAITERS_BIT));
+	return make(get_type(w), owners, get_ts(w), w & (LATCH_BIT | WAITERS_BIT));
+}
+
+// returns the word as it was before latching
+template <uint32_t ALG>
+uint64_t lockword_t<ALG>::latch() {
+	uint64_t w = _word.load(std::memory_order_relaxed);
+	while (true) {
+		if (w & LATCH_BIT) {
+			PAUSE
+			w = _word.load(std::memory_order_relaxed);
+		}
+		else if (_word.compare_exchange_weak(w, w | LATCH_BIT, std::memory_order_acquire))
+			return w;
+	}
+}
+
+template <uint32_t ALG>
+void lockword_t<ALG>::unlatch(uint64_t w) {
+	w &= ~(LATCH_BIT | WAITERS_BIT);
+	if (_waiters != nullptr)
+		w |= WAITERS_BIT;
+	if (ALG == WOUND_WAIT && get_owners(w) > 0) // owners are known, keep the exact oldest one
+		w = make(get_type(w), get_owners(w), pack_ts(_owners->ts), w & WAITERS_BIT);
+	_word.store(w, std::memory_order_release);
+}
+
+template <uint32_t ALG>
+void lockword_t<ALG>::insert(lock_node_t*& head, lock_node_t* node) {
+	lock_node_t** pp = &head;
+	if (ALG == WAIT_DIE) { // waiters are promoted from the youngest one
+		while (*pp != nullptr && (*pp)->ts >= node->ts)
+			pp = &(*pp)->next;
+	}
+	else {
+		while (*pp != nullptr && (*pp)->ts <= node->ts)
+			pp = &(*pp)->next;
+	}
+	node->next = *pp;
+	*pp = node;
+}
+
+template <uint32_t ALG>
+bool lockword_t<ALG>::unlink(lock_node_t*& head, lock_node_t* node) {
+	for (lock_node_t** pp = &head; *pp != nullptr; pp = &(*pp)->next) {
+		if (*pp == node) {
+			*pp = node->next;
+			node->next = nullptr;
+			return true;
+		}
+	}
+	return false;
+}
+
+// promote non-conflicting waiters from the head of the wait list
+template <uint32_t ALG>
+uint64_t lockword_t<ALG>::promote(uint64_t w) {
+	while (_waiters != nullptr && !lock_conflict(get_type(w), _waiters->type)) {
+		auto node = _waiters;
+		_waiters = node->next;
+		node->next = nullptr;
+		// publish the grant before the txn can observe RUNNING
+		node->state.store(lock_node_t::GRANTED);
+		auto state = node->txn->get_state();
+		if (state == txn_t::state_t::WAITING && node->txn->update_state(state, txn_t::state_t::RUNNING)) {
+			w = grant(w, node->type, node->ts);
+			if (ALG == WOUND_WAIT)
+				insert(_owners, node);
+		}
+		else // the waiting txn has entered ABORTING state, help it remove
+			node->state.store(lock_node_t::REMOVED);
+	}
+	return w;
+}
+
+template <uint32_t ALG>
+RC lockword_t<ALG>::lock_get(lock_type_t type, txn_t* txn, global_addr_t addr) {
+	if (ALG != NO_WAIT) {
+		assert(txn->get_ts() != 0);
+		auto txn_state = txn->get_state();
+		if (txn_state != txn_t::state_t::RUNNING) { // wounded by another txn
+			assert(txn_state == txn_t::state_t::ABORTING);
+			return ABORT;
+		}
+	}
+
+	auto node = lock_node_t::alloc(txn, this, type);
+	if (ALG == WOUND_WAIT) // owners have to be known for wounding
+		return lock_get_latched(type, txn, node);
+
+	uint64_t timestamp = txn->get_ts();
+	uint64_t w = _word.load(std::memory_order_relaxed);
+	while (true) {
+		if (w & LATCH_BIT) {
+			PAUSE
+			w = _word.load(std::memory_order_relaxed);
+			continue;
+		}
+
+		bool conflict = lock_conflict(get_type(w), type);
+		if (ALG == WAIT_DIE && (w & WAITERS_BIT)) // there are already waiters, must wait/abort
+			conflict = true;
+
+		if (!conflict) {
+			if (_word.compare_exchange_weak(w, grant(w, type, timestamp), std::memory_order_acq_rel)) {
+				node->state.store(lock_node_t::GRANTED, std::memory_order_relaxed);
+				return RCOK;
+			}
+			continue;
+		}
+
+		// WAIT_DIE: truncated timestamps that are equal also abort
+		if (ALG == NO_WAIT || get_ts(w) <= pack_ts(timestamp)) {
+			lock_node_t::free(node);
+			return ABORT;
+		}
+
+		// all owners are younger -- wait
+		if (!_word.compare_exchange_weak(w, w | LATCH_BIT, std::memory_order_acquire))
+			continue;
+		RC rc = WAIT;
+		if (txn->update_state(txn_t::state_t::RUNNING, txn_t::state_t::WAITING))
+			insert(_waiters, node);
+		else // the waiting txn has entered ABORTING state
+			rc = ABORT;
+		unlatch(w);
+		if (rc == ABORT)
+			lock_node_t::free(node);
+		return rc;
+	}
+}
+
+template <uint32_t ALG>
+RC lockword_t<ALG>::lock_get_latched(lock_type_t type, txn_t* txn, lock_node_t* node) {
+	uint64_t timestamp = txn->get_ts();
+	// set txn state to WAITING outside critical section
+	if (!txn->update_state(txn_t::state_t::RUNNING, txn_t::state_t::WAITING)) {
+		assert(txn->get_state() == txn_t::state_t::ABORTING);
+		lock_node_t::free(node);
+		return ABORT;
+	}
+
+	uint64_t w = latch();
+	if (_owners == nullptr && _waiters == nullptr) { // no current owners, grab the lock
+		RC rc = RCOK;
+		if (txn->update_state(txn_t::state_t::WAITING, txn_t::state_t::RUNNING)) {
+			node->state.store(lock_node_t::GRANTED, std::memory_order_relaxed);
+			insert(_owners, node);
+			w = grant(w, type, timestamp);
+		}
+		else // the txn was wounded by another txn
+			rc = ABORT;
+		unlatch(w);
+		if (rc == ABORT)
+			lock_node_t::free(node);
+		return rc;
+	}
+
+	// examine owners for preemption
+	for (lock_node_t** pp = &_owners; *pp != nullptr; ) {
+		auto owner = *pp;
+		auto state = owner->txn->get_state();
+		if (state == txn_t::state_t::ABORTING) { // this txn has already been aborting, help it remove
+			*pp = owner->next;
+			owner->next = nullptr;
+			owner->state.store(lock_node_t::REMOVED);
+			w = revoke(w);
+			continue;
+		}
+		// cannot preempt committing txns, txns with higher priority, or non-conflicting txns
+		if (state == txn_t::state_t::COMMITTING || timestamp > owner->ts || !lock_conflict(get_type(w), type)) {
+			pp = &owner->next;
+			continue;
+		}
+		// try to wound this owner; on failure, examine it again (maybe ABORTING / WAITING / COMMITTING)
+		owner->txn->update_state(state, txn_t::state_t::ABORTING);
+	}
+
+	insert(_waiters, node);
+	RC rc = WAIT;
+
+	bool promotion_done = false;
+	bool preemption_done = false;
+	for (lock_node_t** pp = &_waiters; *pp != nullptr; ) {
+		auto waiter = *pp;
+		auto state = waiter->txn->get_state();
+		if (state == txn_t::state_t::ABORTING) { // this txn has already been aborting
+			if (waiter->txn == txn) {
+				rc = ABORT;
+				preemption_done = true;
+			}
+			*pp = waiter->next; // help it remove
+			waiter->next = nullptr;
+			waiter->state.store(lock_node_t::REMOVED);
+			continue;
+		}
+
+		// try to wound conflicting txns
+		if (!preemption_done) {
+			if (waiter->txn != txn && timestamp < waiter->ts) { // cur txn has higher priority than this waiter
+				if (lock_conflict(type, waiter->type)) {
+					waiter->txn->update_state(state, txn_t::state_t::ABORTING);
+					// even if update fails, it has to be ABORTING now
+					*pp = waiter->next;
+					waiter->next = nullptr;
+					waiter->state.store(lock_node_t::REMOVED);
+					continue;
+				}
+				else if (promotion_done) { // pass non-conflicting txn
+					pp = &waiter->next;
+					continue;
+				}
+			}
+			else if (waiter->txn != txn) // cannot preempt txns with higher priority
+				preemption_done = true;
+			// else, cannot preempt self
+		}
+
+		// examine lock conflict between waiters and owners for promotion
+		if (!promotion_done && !lock_conflict(get_type(w), waiter->type)) { // promote non-conflicting waiters
+			*pp = waiter->next;
+			waiter->next = nullptr;
+			waiter->state.store(lock_node_t::GRANTED);
+			if (state == txn_t::state_t::WAITING && waiter->txn->update_state(state, txn_t::state_t::RUNNING)) {
+				insert(_owners, waiter);
+				w = grant(w, waiter->type, waiter->ts);
+			}
+			else // the waiting txn has just entered ABORTING state, help it remove
+				waiter->state.store(lock_node_t::REMOVED);
+		}
+		else { // conflicting waiter, stop promotion
+			promotion_done = true;
+			pp = &waiter->next;
+		}
+
+		if (promotion_done && preemption_done) // nothing more to do
+			break;
+	}
+
+	// check if the current txn has been promoted to an owner
+	if (rc == WAIT) {
+		auto state = node->state.load();
+		if (state == lock_node_t::GRANTED) {
+			rc = RCOK;
+			assert(txn->get_state() != txn_t::state_t::WAITING);
+		}
+		else if (state == lock_node_t::REMOVED) // has been wounded by another txn
+			rc = ABORT;
+	}
+
+	unlatch(w);
+	if (rc == ABORT)
+		lock_node_t::free(node);
+	return rc;
+}
+
+template <uint32_t ALG>
+void lockword_t<ALG>::lock_release(lock_type_t type, txn_t* txn, global_addr_t addr) {
+	auto node = lock_node_t::find(txn, this, type);
+	if (node == nullptr) // neither an owner nor a waiter (e.g., lock_get has aborted)
+		return;
+
+	if (ALG != WOUND_WAIT) {
+		uint64_t w = _word.load(std::memory_order_acquire);
+		while (true) {
+			if (w & LATCH_BIT) {
+				PAUSE
+				w = _word.load(std::memory_order_acquire);
+				continue;
+			}
+			auto state = node->state.load();
+			if (state == lock_node_t::REMOVED) { // removed from the wait list by another txn
+				lock_node_t::free(node);
+				return;
+			}
+			if (state == lock_node_t::WAITING || (w & WAITERS_BIT)) // remove or promote waiters under the latch
+				break;
+			if (_word.compare_exchange_weak(w, revoke(w), std::memory_order_acq_rel)) {
+				lock_node_t::free(node);
+				return;
+			}
+		}
+	}
+	lock_release_latched(node);
+}
+
+template <uint32_t ALG>
+void lockword_t<ALG>::lock_release_latched(lock_node_t* node) {
+	uint64_t w = latch();
+	auto state = node->state.load();
+	if (state == lock_node_t::GRANTED) {
+		if (ALG == WOUND_WAIT)
+			unlink(_owners, node);
+		w = revoke(w);
+	}
+	else if (state == lock_node_t::WAITING)
+		unlink(_waiters, node);
+	// else, the node has been removed (wounded or aborted while waiting)
+
+	w = promote(w);
+	unlatch(w);
+	lock_node_t::free(node);
+}
+
+template class lockword_t<NO_WAIT>;
+template class lockword_t<WAIT_DIE>;
+template class lockword_t<WOUND_WAIT>;
+
+}
+#endif
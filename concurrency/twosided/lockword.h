@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include "system/global.h"
+#include "system/global_address.h"
+#include "concurrency/twosided/lock_node.h"
+
+class txn_t;
+namespace twosided {
+
+// Row lock manager that keeps the lock state in a single atomic word
+//   [ oldest owner ts (48) | owner count (12) | waiters (1) | latch (1) | lock type (2) ]
+// NO_WAIT and WAIT_DIE grant and release locks with a single CAS as long as nobody waits.
+// Waiters (and, for WOUND_WAIT, owners that may be wounded) are kept in intrusive lists
+// sorted by timestamp; the lists are only modified while the latch bit is set.
+// Drop-in replacement of nowait_t, waitdie_t and woundwait_t (see ROW_LOCK in config.h).
+template <uint32_t ALG>
+class lockword_t {
+public:
+	lockword_t(): _word(EMPTY), _waiters(nullptr), _owners(nullptr) { }
+
+	RC   lock_get(lock_type_t type, txn_t* txn, global_addr_t addr=0);
+	void lock_release(lock_type_t type, txn_t* txn, global_addr_t addr=0);
+
+private:
+	static constexpr uint64_t TYPE_MASK      = 0x3;
+	static constexpr uint64_t LATCH_BIT      = 1ULL << 2;
+	static constexpr uint64_t WAITERS_BIT    = 1ULL << 3;
+	static constexpr uint32_t OWNERS_SHIFT   = 4;
+	static constexpr uint64_t MAX_OWNERS     = 0xfff;
+	static constexpr uint32_t TS_SHIFT       = 16;
+	static constexpr uint64_t TS_NONE        = (1ULL << 48) - 1; // no owner
+	static constexpr uint32_t TS_GRANULARITY = 16; // timestamps are truncated to 64 us
+	static constexpr uint64_t EMPTY          = (TS_NONE << TS_SHIFT) | LOCK_NONE;
+
+	static lock_type_t get_type(uint64_t w)   { return static_cast<lock_type_t>(w & TYPE_MASK); }
+	static uint64_t    get_owners(uint64_t w) { return (w >> OWNERS_SHIFT) & MAX_OWNERS; }
+	static uint64_t    get_ts(uint64_t w)     { return w >> TS_SHIFT; }
+	static uint64_t    pack_ts(uint64_t ts)   { return ts >> TS_GRANULARITY; }
+	static uint64_t    make(lock_type_t type, uint64_t owners, uint64_t ts, uint64_t flags) {
+		return (ts << TS_SHIFT) | (owners << OWNERS_SHIFT) | flags | type;
+	}
+	// add an owner; the oldest owner ts is only reset once all owners have left
+	static uint64_t    grant(uint64_t w, lock_type_t type, uint64_t ts);
+	// remove an owner of the given word (latch and waiters bits are kept)
+	static uint64_t    revoke(uint64_t w);
+
+	uint64_t latch();
+	void     unlatch(uint64_t w);
+
+	// list operations; must hold the latch
+	void     insert(lock_node_t*& head, lock_node_t* node);
+	bool     unlink(lock_node_t*& head, lock_node_t* node);
+	uint64_t promote(uint64_t w);
+
+	RC       lock_get_latched(lock_type_t type, txn_t* txn, lock_node_t* node);
+	void     lock_release_latched(lock_node_t* node);
+
+	std::atomic<uint64_t> _word;
+	lock_node_t*          _waiters; // WAIT_DIE: youngest first, WOUND_WAIT: oldest first
+	lock_node_t*          _owners;  // WOUND_WAIT only, oldest first
+};
+
+}
@@ -11,12 +11,27 @@
 #define TWO_SIDED 2
 #define TRANSPORT TWO_SIDED
 #define BATCH 0
+// COMPACT_ACCESS_LIST: message types whose access lists are sent in the compact encoding of transport/access_list.h,
+// as a bitmask of message_t::type_t, e.g., (1 << message_t::REQUEST_STORED_PROCEDURE); 0 keeps fixed-size tuples
+#define COMPACT_ACCESS_LIST 0
+// Supported backends: IBVERBS, SHM
+// SHM emulates RDMA with shared-memory rings so that compute and memory nodes
+// can run as local processes on a single host (no NIC required).
+#define IBVERBS 1
+#define SHM 2
+#define TRANSPORT_BACKEND IBVERBS
 
 // Partitioning in compute layer
 // ==========
 // When set to true, each client is assigned with a specific set of partitions.
 #define PARTITIONED true
 
+// NUMA placement in memory layer
+// ==========
+// When set to true, each memory server spreads its partition, the threads loading it and
+// its server threads over the sockets, so that rows and index nodes are allocated locally.
+#define NUMA_AWARE false
+
 // Statistics
 // ==========
 // COLLECT_LATENCY: when set to true, will collect transaction latency information
@@ -39,6 +54,17 @@
 #define WAIT_DIE 2
 #define WOUND_WAIT 3
 #define CC_ALG WAIT_DIE
+// Supported row lock managers (TWO_SIDED): LOCK_SET, LOCK_WORD
+// LOCK_SET keeps lock owners/waiters in std::set protected by a pthread mutex
+// LOCK_WORD packs the lock state into a single atomic word with intrusive wait lists
+#define LOCK_SET 1
+#define LOCK_WORD 2
+#define ROW_LOCK LOCK_SET
+// SNAPSHOT_READ (TWO_SIDED, !PARTITIONED): read-only txns read a snapshot at their start timestamp from per-row
+// versions without taking locks (storage/version.h); update txns keep 2PL and stamp their writes with a commit timestamp
+// MAX_VERSIONS: committed versions kept per row besides the newest one
+#define SNAPSHOT_READ false
+#define MAX_VERSIONS 4
 
 // per-row lock/ts management or central lock/ts management
 #define BUCKET_CNT 31
@@ -49,6 +75,9 @@
 
 // [ INDEX ]
 #define INDEX_STRUCT IDX_BTREE
+// SIMD_SEARCH: search the keys of tree nodes with AVX-512/AVX2 (selected at runtime, scalar fallback);
+// off by default until it is shown to win over the scalar search (compare both with idx_test)
+#define SIMD_SEARCH false
 
 
 ////////////////////////////////////////////////////////////////////////
@@ -60,12 +89,33 @@
 #define MAX_NUM_THREADS 48
 #define NUM_SERVER_THREADS 8
 #define NUM_CLIENT_THREADS 40
+#define NUM_CLIENT_COROS 1 // txns in flight per client thread (one coroutine each)
+#define MAX_NUM_COROS 8
 #define INIT_PARALLELISM NUM_CLIENT_THREADS
 #define MAX_NUM_WAITS 64
 #define THINK_TIME 0  // in us
 #define RPC_RATE 0.1
 #define CACHE_ADMISSION_RATE 0.5
 #define CACHE_SIZE 128
+// Supported cache admission policies: ADMIT_RANDOM, ADMIT_TINYLFU
+// ADMIT_RANDOM admits a missed key with probability CACHE_ADMISSION_RATE
+// ADMIT_TINYLFU admits it only if its estimated frequency (count-min sketch) beats the one of an eviction victim
+#define ADMIT_RANDOM 1
+#define ADMIT_TINYLFU 2
+#define CACHE_ADMISSION ADMIT_TINYLFU
+// Supported cache eviction policies: EVICT_SAMPLING, EVICT_CLOCK
+// EVICT_SAMPLING evicts the less frequently used of two entries sampled with index lookups
+// EVICT_CLOCK sweeps a ring of the cached entries and evicts the first one whose frequency has aged to zero
+#define EVICT_SAMPLING 1
+#define EVICT_CLOCK 2
+#define CACHE_EVICTION EVICT_SAMPLING
+#define RECLAIM_THRESHOLD (1ULL * 1024 * 1024) // bytes of retired cache entries a thread keeps before it reclaims eagerly
+// ADAPTIVE_CACHE: client thread 0 tunes the admission and RPC ratios of every index at each stats checkpoint
+// (starting from CACHE_ADMISSION_RATE and RPC_RATE) to maximize the committed throughput
+#define ADAPTIVE_CACHE false
+// NUM_HOT_KEYS: memory servers report up to this many hot keys, which compute nodes always keep in their caches
+// (PARTITIONED, two-sided); 0 (the default) disables hot-key replication
+#define NUM_HOT_KEYS 0
 // WORKLOAD can be YCSB or TPCC
 #define WORKLOAD YCSB
 
@@ -115,6 +165,7 @@
 #define YCSB 1
 #define TPCC 2
 #define DEFAULT_ROW_SIZE (1024 - 16)
+#define ROW_SLAB_SIZE (64ULL * 1024 * 1024) // rows of a table are allocated from hugepage slabs of this size (TWO_SIDED)
 #define DEVICE_MEMORY_SIZE (1024 * 128)
 
 /***********************************************/
@@ -34,6 +34,9 @@ public:
 	virtual void set_rpc_ratio(double ratio) = 0;
 	virtual void get_newest_root() = 0;
 	virtual void reset_buffer_pool(bool flush_dirty) = 0;
+	// hot-key replication (utils/hot_keys.h)
+	virtual bool access_hot(Key k) { return false; } // memory server: records an access, true if the key is hot
+	virtual void set_hot(Key k) { }                  // compute node: the key has been reported as hot
 #else
 	virtual void add_to_cache(Key k, char* page) = 0;
 	// virtual void add_to_cache(char* page) = 0;
@@ -45,5 +48,8 @@ public:
 	// virtual void get_newest_root(int tid) {}
 	// virtual void reset_buffer_pool(bool flush_dirty) {}
 	virtual void set_admission_ratio(double ratio) {}
+	// knobs of the compute-side cache (client/tuner.h); negative if the index has no such knob
+	virtual double get_admission_ratio() { return -1; }
+	virtual double get_rpc_ratio() { return -1; }
 	virtual void set_partition(Key from, Key to) {}
 };
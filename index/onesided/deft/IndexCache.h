@@ -1,8 +1,6 @@
 #pragma once
 
 #include <atomic>
-// #include <queue>
-#include <list>
 #include <vector>
 #include "system/global.h"
 #include "system/global_address.h"
@@ -12,6 +10,7 @@
 #include "index/onesided/deft/Timer.h"
 #include "index/onesided/deft/thread_epoch.h"
 #include "utils/huge_page.h"
+#include "utils/reclaim.h"
 #include "index/WRLock.h"
 #include "third_party/inlineskiplist.h"
 
@@ -19,11 +18,6 @@
 namespace deft {
 using CacheSkipList = InlineSkipList<CacheEntryComparator>;
 
-struct alignas(64) DelayFreeList {
-  std::list<std::pair<void *, uint64_t>> list;
-  WRLock lock;
-};
-
 class IndexCache {
  public:
   IndexCache(uint64_t cache_size, uint32_t index_id=0);
@@ -36,8 +30,11 @@ class IndexCache {
   const CacheEntry *search_from_cache(const Key &k, global_addr_t *addr,
                                       global_addr_t *parent_addr);
 
-  void search_range_from_cache(const Key &from, const Key &to,
-                               std::vector<InternalPage *> &result);
+  // the first cached page ending at or after from and starting at or before
+  // to, nullptr if there is none; page_to is the last key it covers. The page
+  // is valid between thread_status->rcu_progress() and rcu_exit()
+  InternalPage *search_next_from_cache(const Key &from, const Key &to,
+                                       Key &page_to);
 
   bool add_entry(const Key &from, const Key &to, InternalPage *ptr);
   const CacheEntry *find_entry(const Key &k);
@@ -52,8 +49,6 @@ class IndexCache {
 
   void bench();
 
-  void free_delay();
-  
   ThreadStatus *thread_status;
 
  private:
@@ -64,19 +59,14 @@ class IndexCache {
   std::atomic<uint64_t> max_key{0};
   int64_t all_page_cnt;
 
-  // std::queue<std::pair<void *, uint64_t>> delay_free_list;
-  // WRLock free_lock;
-
-  DelayFreeList delay_free_lists[MAX_NUM_THREADS];
-  std::atomic_bool delay_free_stop_flag{false};
-  std::thread free_delay_thread_;
-
   // SkipList
   CacheSkipList *skiplist;
   CacheEntryComparator cmp;
   Allocator alloc;
 
   void evict_one(int thread_id);
+  // frees a replaced or invalidated page once no reader can reach it
+  void retire(InternalPage *page);
 };
 
 inline IndexCache::IndexCache(uint64_t cache_size, uint32_t index_id) : cache_size(cache_size), index_id(index_id) {
@@ -88,14 +78,9 @@ inline IndexCache::IndexCache(uint64_t cache_size, uint32_t index_id) : cache_si
   all_page_cnt = memory_size / kInternalPageSize * kMaxInternalGroup;
   free_page_cnt.store(all_page_cnt);
   skiplist_node_cnt.store(0);
-  free_delay_thread_ = std::thread(&IndexCache::free_delay, this);
 }
 
 IndexCache::~IndexCache() {
-  delay_free_stop_flag.store(true, std::memory_order_release);
-  if (free_delay_thread_.joinable()) {
-    free_delay_thread_.join();
-  }
   delete skiplist;
   delete thread_status;
 }
@@ -140,6 +125,7 @@ inline const CacheEntry *IndexCache::find_entry(const Key &k) {
 }
 
 inline bool IndexCache::add_to_cache(InternalPage *page, int thread_id) {
+  reclaim::guard_t guard;
   InternalPage *new_page = (InternalPage *)malloc(kInternalPageSize);
   memcpy(reinterpret_cast<void *>(new_page), page, kInternalPageSize);
   new_page->hdr.index_cache_freq = 0;
@@ -178,10 +164,7 @@ inline bool IndexCache::add_to_cache(InternalPage *page, int thread_id) {
               evict_one(thread_id);
             }
           }
-          delay_free_lists[thread_id].lock.wLock();
-          delay_free_lists[thread_id].list.push_back(
-              std::make_pair(ptr, asm_rdtsc()));
-          delay_free_lists[thread_id].lock.wUnlock();
+          retire(ptr);
         }
         return true;
       }
@@ -196,6 +179,7 @@ inline bool IndexCache::add_sub_node(global_addr_t addr, int group_id,
                                      int granularity, int guard_offset,
                                      InternalEntry *guard, int size, Key min,
                                      Key max, int thread_id) {
+  reclaim::guard_t reclaim_guard;
   InternalPage *new_page = (InternalPage *)malloc(kInternalPageSize);
   // memset(new_page, 0, kInternalPageSize);
 
@@ -255,10 +239,7 @@ inline bool IndexCache::add_sub_node(global_addr_t addr, int group_id,
             evict_one(thread_id);
           }
         }
-        delay_free_lists[thread_id].lock.wLock();
-        delay_free_lists[thread_id].list.push_back(
-            std::make_pair(ptr, asm_rdtsc()));
-        delay_free_lists[thread_id].lock.wUnlock();
+        retire(ptr);
       }
       return true;
     }
@@ -306,6 +287,7 @@ inline bool IndexCache::add_sub_node(global_addr_t addr, int group_id,
 
 inline const CacheEntry *IndexCache::search_from_cache(
     const Key &k, global_addr_t *addr, global_addr_t *parent_addr) {
+  reclaim::guard_t guard;
   auto entry = find_entry(k);
 
   InternalPage *page = entry ? entry->ptr : nullptr;
@@ -361,11 +343,11 @@ inline const CacheEntry *IndexCache::search_from_cache(
   return nullptr;
 }
 
-inline void IndexCache::search_range_from_cache(
-    const Key &from, const Key &to, std::vector<InternalPage *> &result) {
+inline InternalPage *IndexCache::search_next_from_cache(const Key &from,
+                                                       const Key &to,
+                                                       Key &page_to) {
   CacheSkipList::Iterator iter(skiplist);
 
-  result.clear();
   CacheEntry e;
   e.from = from;
   e.to = from;
@@ -373,18 +355,17 @@ inline void IndexCache::search_range_from_cache(
 
   while (iter.Valid()) {
     auto val = (const CacheEntry *)iter.key();
-    if (val->ptr) {
-      if (val->from > to) {
-        return;
-      }
-      if (result.size() == 0 ||
-          (result.back()->hdr.lowest < val->ptr->hdr.lowest &&
-           result.back()->hdr.highest > val->ptr->hdr.highest)) {
-        result.push_back(val->ptr);
-      }
+    if (val->from > to) {
+      return nullptr;
+    }
+    auto page = val->ptr;
+    if (page) {
+      page_to = val->to;
+      return page;
     }
     iter.Next();
   }
+  return nullptr;
 }
 
 inline bool IndexCache::invalidate(const CacheEntry *entry, int thread_id) {
@@ -399,10 +380,7 @@ inline bool IndexCache::invalidate(const CacheEntry *entry, int thread_id) {
     for (int i = 0; i < kMaxInternalGroup; ++i) {
       cnt += ptr->hdr.grp_in_cache[i];
     }
-    delay_free_lists[thread_id].lock.wLock();
-    delay_free_lists[thread_id].list.push_back(
-        std::make_pair(ptr, asm_rdtsc()));
-    delay_free_lists[thread_id].lock.wUnlock();
+    retire(ptr);
     free_page_cnt.fetch_add(cnt);
     return true;
   }
@@ -420,6 +398,7 @@ inline bool IndexCache::invalidate(const Key &from, const Key &to,
 }
 
 inline const CacheEntry *IndexCache::get_a_random_entry(uint64_t &freq) {
+  reclaim::guard_t guard;
   uint32_t seed = asm_rdtsc();
 retry:
   auto k = rand_r(&seed) % max_key.load(std::memory_order_relaxed);
@@ -473,28 +452,9 @@ inline void IndexCache::bench() {
   t.end_print(loop);
 }
 
-
-void IndexCache::free_delay() {
-  std::list<std::pair<void *, uint64_t>> local_list;
-
-  while (!delay_free_stop_flag.load(std::memory_order_acquire)) {
-    for (int i = 0; i < MAX_NUM_THREADS; ++i) {
-      delay_free_lists[i].lock.wLock();
-      local_list.splice(local_list.end(), delay_free_lists[i].list);
-      delay_free_lists[i].lock.wUnlock();
-    }
-    thread_status->rcu_barrier();
-    auto it = local_list.begin();
-    for (; it != local_list.end(); ++it) {
-      if (asm_rdtsc() - it->second > 5000ul * 10) {
-        free(it->first);
-      } else {
-        break;
-      }
-    }
-    local_list.erase(local_list.begin(), it);  // erase not include it
-    usleep(5);
-  }
+inline void IndexCache::retire(InternalPage *page) {
+  reclaim::retire(page, kInternalPageSize,
+                  [](void *ptr, void *) { free(ptr); });
 }
 }
 #endif
\ No newline at end of file
@@ -1035,25 +1035,57 @@ next:
 
 int Tree::range_query(const Key &from, const Key &to, Value *value_buffer,
                       int max_cnt, CoroContext *ctx, int coro_id) {
-  const int kParaFetch = 32;
-  thread_local std::vector<InternalPage *> result;
-  thread_local std::vector<global_addr_t> leaves;
-
-  result.clear();
-  leaves.clear();
+  RangeCursor cursor(this, from, to, max_cnt, max_cnt);
+  int counter = 0;
+  Key k;
+  Value v;
+  while (cursor.next(k, v)) {
+    value_buffer[counter++] = v;
+  }
+  return counter;
+}
 
-  index_cache->thread_status->rcu_progress(GET_THD_ID);
+int Tree::scan(Key k, int range, value_t *&buffer) {
+  RangeCursor cursor(this, k, kKeyMax, range, range);
+  int counter = 0;
+  Key key;
+  Value v;
+  while (cursor.next(key, v)) {
+    buffer[counter++].val = v;
+  }
+  return counter;
+}
 
-  index_cache->search_range_from_cache(from, to, result);
+Tree::RangeCursor::RangeCursor(Tree *tree, const Key &from, const Key &to,
+                               int max_cnt, int fetch_size)
+    : from(from), to(to), max_cnt(max_cnt), fetch_size(fetch_size),
+      counter(0), cache(tree->index_cache), next_key(from), collected(false),
+      next_leaf(0), posted(0), decoded(0), pos(0) {
+  static_assert(kNumSlots * kWaveSize * kLeafPageSize <= MAX_MESSAGE_SIZE,
+                "the ring must fit in the transport buffer");
+  ring = transport->get_buffer();
+}
 
-  // FIXME: here, we assume all innernal nodes are cached in compute node
-  if (result.empty()) {
-    index_cache->thread_status->rcu_exit(GET_THD_ID);
-    return 0;
-  }
+// replaces the leaves with those of the next cached page in the range; false
+// once the range has no leaves left
+bool Tree::RangeCursor::collect_leaves() {
+  leaves.clear();
+  next_leaf = 0;
+  while (leaves.empty() && !collected) {
+    cache->thread_status->rcu_progress(GET_THD_ID);
+    Key page_to;
+    // FIXME: here, we assume all innernal nodes are cached in compute node
+    auto page = cache->search_next_from_cache(next_key, to, page_to);
+    if (page == nullptr || page_to >= to) {
+      collected = true;
+    } else {
+      next_key = page_to + 1;
+    }
+    if (page == nullptr) {
+      cache->thread_status->rcu_exit(GET_THD_ID);
+      break;
+    }
 
-  int counter = 0;
-  for (auto page : result) {
     std::vector<InternalEntry> tmp_records;
     tmp_records.reserve(kInternalCardinality);
     for (int i = 0; i < kInternalCardinality; ++i) {
@@ -1078,79 +1110,96 @@ int Tree::range_query(const Key &from, const Key &to, Value *value_buffer,
         leaves.push_back(tmp_records[cnt - 1].ptr);
       }
     }
+
+    // the leaf addresses stay valid, the cached page is not touched anymore
+    cache->thread_status->rcu_exit(GET_THD_ID);
+  }
+  return !leaves.empty();
+}
+
+bool Tree::RangeCursor::next(Key &k, Value &v) {
+  if (pos == records.size()) {
+    fetch();
+    if (records.empty()) {
+      return false;
+    }
   }
+  k = records[pos].first;
+  v = records[pos].second;
+  pos++;
+  return true;
+}
 
-  int cq_cnt = 0;
-  char* range_buffer = transport->get_buffer();
-  // char *range_buffer = (dsm_client_->get_rbuf(coro_id)).get_range_buffer();
-  for (size_t i = 0; i < leaves.size(); ++i) {
-    if (i > 0 && i % kParaFetch == 0) {
-      // dsm_client_->PollRdmaCq(kParaFetch);
-      cq_cnt -= kParaFetch;
-      for (int k = 0; counter < max_cnt && k < kParaFetch; ++k) {
-        auto page = (LeafPage *)(range_buffer + k * kLeafPageSize);
-        for (int idx = 0; counter < max_cnt && idx < kNumGroup; ++idx) {
-          LeafEntryGroup *g = &page->groups[idx];
-          for (int j = 0; counter < max_cnt && j < kAssociativity; ++j) {
-            auto &r = g->front[j];
-            if (r.lv.val != kValueNull && r.key >= from && r.key < to) {
-              value_buffer[counter++] = r.lv.val;
-            }
-          }
-          for (int j = 0; counter < max_cnt && j < kAssociativity; ++j) {
-            auto &r = g->back[j];
-            if (r.lv.val != kValueNull && r.key >= from && r.key < to) {
-              value_buffer[counter++] = r.lv.val;
-            }
-          }
-          for (int j = 0; counter < max_cnt && j < kAssociativity; ++j) {
-            auto &r = g->overflow[j];
-            if (r.lv.val != kValueNull && r.key >= from && r.key < to) {
-              value_buffer[counter++] = r.lv.val;
-            }
-          }
-        }
-      }
+void Tree::RangeCursor::fetch() {
+  records.clear();
+  pos = 0;
+  while (records.size() < (size_t)fetch_size && counter < max_cnt) {
+    while (posted - decoded < kNumSlots &&
+           (next_leaf < leaves.size() || collect_leaves())) {
+      post_wave();
+    }
+    if (decoded == posted) {  // range exhausted
+      break;
     }
-    remote_read(range_buffer + kLeafPageSize * (i % kParaFetch),
-                     leaves[i], kLeafPageSize);
-    // transport->read(range_buffer + kLeafPageSize * (i % kParaFetch),
-    //                  leaves[i], kLeafPageSize);
-    // dsm_client_->Read(range_buffer + kLeafPageSize * (i % kParaFetch),
-    //                   leaves[i], kLeafPageSize, true);
-    cq_cnt++;
-  }
-
-  if (cq_cnt != 0) {
-    // dsm_client_->PollRdmaCq(cq_cnt);
-    for (int k = 0; counter < max_cnt && k < cq_cnt; ++k) {
-      auto page = (LeafPage *)(range_buffer + k * kLeafPageSize);
-      for (int idx = 0; counter < max_cnt && idx < kNumGroup; ++idx) {
-        LeafEntryGroup *g = &page->groups[idx];
-        for (int j = 0; counter < max_cnt && j < kAssociativity; ++j) {
-          LeafEntry &r = g->front[j];
-          if (r.lv.val != kValueNull && r.key >= from && r.key < to) {
-            value_buffer[counter++] = r.lv.val;
-          }
+    decode_wave();
+  }
+  // nothing stays in flight once the caller gets control
+  while (decoded < posted) {
+    decode_wave();
+  }
+}
+
+void Tree::RangeCursor::post_wave() {
+  auto &batch = batches[posted % kNumSlots];
+  char *slot = ring + (posted % kNumSlots) * kWaveSize * kLeafPageSize;
+  for (int i = 0;
+       i < kWaveSize && (next_leaf < leaves.size() || collect_leaves());
+       ++i, ++next_leaf) {
+    global_addr_t addr(leaves[next_leaf].nodeID, leaves[next_leaf].offset);
+    batch.read(slot + i * kLeafPageSize, addr, kLeafPageSize);
+  }
+  transport->post_batch_async(batch);
+  posted++;
+}
+
+void Tree::RangeCursor::decode_wave() {
+  auto &batch = batches[decoded % kNumSlots];
+  char *slot = ring + (decoded % kNumSlots) * kWaveSize * kLeafPageSize;
+  transport->wait_batch(batch);
+
+  size_t begin = records.size();
+  for (uint32_t k = 0; k < batch.size(); ++k) {
+    auto page = (LeafPage *)(slot + k * kLeafPageSize);
+    for (int idx = 0; idx < kNumGroup; ++idx) {
+      LeafEntryGroup *g = &page->groups[idx];
+      for (int j = 0; j < kAssociativity; ++j) {
+        auto &r = g->front[j];
+        if (r.lv.val != kValueNull && r.key >= from && r.key < to) {
+          records.emplace_back(Key(r.key), Value(r.lv.val));
         }
-        for (int j = 0; counter < max_cnt && j < kAssociativity; ++j) {
-          auto &r = g->back[j];
-          if (r.lv.val != kValueNull && r.key >= from && r.key < to) {
-            value_buffer[counter++] = r.lv.val;
-          }
+      }
+      for (int j = 0; j < kAssociativity; ++j) {
+        auto &r = g->back[j];
+        if (r.lv.val != kValueNull && r.key >= from && r.key < to) {
+          records.emplace_back(Key(r.key), Value(r.lv.val));
         }
-        for (int j = 0; counter < max_cnt && j < kAssociativity; ++j) {
-          auto &r = g->overflow[j];
-          if (r.lv.val != kValueNull && r.key >= from && r.key < to) {
-            value_buffer[counter++] = r.lv.val;
-          }
+      }
+      for (int j = 0; j < kAssociativity; ++j) {
+        auto &r = g->overflow[j];
+        if (r.lv.val != kValueNull && r.key >= from && r.key < to) {
+          records.emplace_back(Key(r.key), Value(r.lv.val));
         }
       }
     }
   }
+  batch.clear();
+  decoded++;
 
-  index_cache->thread_status->rcu_exit(GET_THD_ID);
-  return counter;
+  // leaves are read in key order, the entries of a leaf are not sorted
+  std::sort(records.begin() + begin, records.end());
+  size_t cnt = std::min<size_t>(records.size() - begin, max_cnt - counter);
+  records.resize(begin + cnt);
+  counter += cnt;
 }
 
 void Tree::del(const Key &k, CoroContext *ctx, int coro_id) {
@@ -1,12 +1,15 @@
 #pragma once
 #include "index/idx_wrapper.h"
 #include "index/onesided/deft/Common.h"
+#include "transport/transport.h"
 #include "utils/packetize.h"
 #include <atomic>
 #include <stddef.h>
 #include <city.h>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 #if !PARTITIONED
 namespace deft {
@@ -578,7 +581,7 @@ class Tree : public idx_wrapper_t<value_t> {
     return ret; }
   bool update(Key k, value_t v) { insert(k, v.val); return true; }
   bool remove(Key k) { del(k); return true; }
-  int scan(Key k, int range, value_t*& buffer) { return 0; } // TODO
+  int scan(Key k, int range, value_t*& buffer);
 
 
   int search_cache(Key k, UnstructuredBuffer& buffer) { return 0; }
@@ -595,6 +598,8 @@ class Tree : public idx_wrapper_t<value_t> {
 
   int range_query(const Key &from, const Key &to, Value *buffer, int max_cnt,
                   CoroContext *ctx = nullptr, int coro_id = 0);
+  // streaming range scan, consumed one record at a time
+  class RangeCursor;
 
 //   void run_coroutine(CoroFunc func, int id, int coro_cnt, bool lock_bench,
 //                      uint64_t total_ops);
@@ -727,5 +732,53 @@ class Tree : public idx_wrapper_t<value_t> {
   void remote_faa_dm_bound(char* buffer, global_addr_t addr, uint64_t val, uint64_t bound,
                            uint32_t size, bool async=false);
 };
+
+// Range scan over [from, to) that yields records in key order.
+// The leaves covering the range are found in the cached level-1 pages, one page
+// at a time as the waves need them, and read in waves of kWaveSize leaves, each
+// posted with one doorbell. A ring of kNumSlots waves keeps the next waves in
+// flight while the current one is decoded, and no wave is posted (nor page
+// searched) once max_cnt records have been decoded.
+// The cursor buffers about fetch_size records at a time and drains the ring
+// before next() returns, so the caller may issue other ops between calls.
+class Tree::RangeCursor {
+ public:
+  static constexpr int kNumSlots = 2;
+  static constexpr int kWaveSize = transport_t::wr_batch_t::MAX_WRS;
+  static constexpr int kFetchSize = 256;
+
+  RangeCursor(Tree *tree, const Key &from, const Key &to,
+              int max_cnt = std::numeric_limits<int>::max(),
+              int fetch_size = kFetchSize);
+
+  // false once the range or max_cnt is exhausted
+  bool next(Key &k, Value &v);
+
+ private:
+  void fetch();
+  bool collect_leaves();
+  void post_wave();
+  void decode_wave();
+
+  Key from;
+  Key to;
+  int max_cnt;
+  int fetch_size;
+  int counter;  // records decoded
+
+  IndexCache *cache;
+  Key next_key;    // first key whose cached page has not been collected
+  bool collected;  // the last page of the range has been collected
+
+  std::vector<global_addr_t> leaves;
+  size_t next_leaf;  // first leaf not posted (of the collected ones)
+  uint64_t posted;   // waves posted
+  uint64_t decoded;  // waves decoded
+  char *ring;
+  transport_t::wr_batch_t batches[kNumSlots];
+
+  std::vector<std::pair<Key, Value>> records;
+  size_t pos;
+};
 }
 #endif
\ No newline at end of file
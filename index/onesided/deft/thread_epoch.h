@@ -1,10 +1,13 @@
 #pragma once
 
 #include <memory>
+#include "utils/reclaim.h"
 
 #if !PARTITIONED
 namespace deft {
 // epoch & rcu
+// rcu_progress/rcu_exit enter and leave a reclaim guard (utils/reclaim.h), so the
+// pages the IndexCache retires are freed only after the readers have left
 class ThreadStatus {
  public:
   struct alignas(64) Status {
@@ -23,6 +26,7 @@ class ThreadStatus {
   }
 
   void rcu_progress(int worker_id) {
+    reclaim::enter();
     status_set[worker_id].running = true;
     status_set[worker_id].epoch = status_set[worker_id].epoch + 1;
     // mfence();
@@ -38,17 +42,7 @@ class ThreadStatus {
 
   void rcu_exit(int worker_id) {
     status_set[worker_id].running = false;
-  }
-
-  void rcu_barrier() {
-    uint64_t prev_status[num_threads];
-    for (int i = 0; i < num_threads; i++) {
-      prev_status[i] = status_set[i].epoch;
-    }
-    for (int i = 0; i < num_threads; i++) {
-      while (status_set[i].running && prev_status[i] == status_set[i].epoch)
-        ;
-    }
+    reclaim::exit(); // advances the epoch and reclaims past RECLAIM_THRESHOLD
   }
 
   uint64_t get_epoch(int worker_id) {
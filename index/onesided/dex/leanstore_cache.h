@@ -104,9 +104,11 @@ public:
 
   double get_rpc_ratio() {
     // return decision.pushdown_rate();
-    return 0;
+    return rpc_rate_;
   }
 
+  double get_admission_ratio() { return admission_rate_; }
+
   void set_rpc_ratio(double ratio) { rpc_rate_ = ratio; }
   void set_admission_ratio(double ratio) { admission_rate_ = ratio; }
 
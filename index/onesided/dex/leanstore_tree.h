@@ -2727,6 +2727,8 @@ public:
 
   double get_rpc_ratio() { return cache.get_rpc_ratio(); }
 
+  double get_admission_ratio() { return cache.get_admission_ratio(); }
+
   void clear_statistic() {}
 
 };
@@ -23,6 +23,10 @@ namespace sherman {
 // #define CONFIG_ENABLE_EMBEDDING_LOCK
 // #define CONFIG_ENABLE_CRC
 
+// read a page with one RDMA read and validate it with its versions (and CRC);
+// the lock-word/version reads around the page read are only issued on a retry
+#define CONFIG_ENABLE_SPECULATIVE_READ
+
 // #define LEARNED 1
 // #define PAGE_OFFSET 1
 
@@ -111,6 +115,8 @@ constexpr uint16_t kMaxCoro = 8;
 constexpr uint8_t kMaxHandOverTime = 8;
 
 constexpr int kIndexCacheSize = 512; // MB
+// level-1 pages sampled to pick an eviction victim of the index cache
+constexpr int kIndexCacheEvictSamples = 8;
 } // namespace define
 
 static inline unsigned long long asm_rdtsc(void) {
@@ -4,17 +4,21 @@
 #include "index/WRLock.h"
 #include "third_party/inlineskiplist.h"
 #include "utils/helper.h"
+#include "utils/reclaim.h"
 #include "system/global.h"
 #include "system/global_address.h"
 
 #include <atomic>
-#include <queue>
 #include <vector>
 #if !PARTITIONED
 namespace sherman {
 
 using CacheSkipList = InlineSkipList<CacheEntryComparator>;
 
+// Cache of internal pages within a budget of cache_size MB. Pages above level 1
+// are few and on the path of every miss, so they are pinned; level-1 pages are
+// evicted by their access counts, which decay (halve) each time a page is
+// sampled as an eviction candidate and kept.
 class IndexCache {
 
 public:
@@ -23,13 +27,21 @@ public:
   bool add_to_cache(InternalPage *page);
   const CacheEntry *search_from_cache(const Key &k, global_addr_t *addr,
                                       bool is_leader = false);
-
-  void search_range_from_cache(const Key &from, const Key &to,
-                               std::vector<InternalPage *> &result);
-
-  bool add_entry(const Key &from, const Key &to, InternalPage *ptr);
+  // on a miss of the level-1 pages: the lowest cached upper-level page
+  // covering k, addr is its child to descend to. The page may be stale, which
+  // costs sibling hops below it but never a wrong child (pages split rightwards)
+  const CacheEntry *search_upper_from_cache(const Key &k, global_addr_t *addr);
+
+  // the first cached level-1 page ending at or after from and starting at or
+  // before to, nullptr if there is none; page_to is the last key it covers.
+  // The page is valid while the caller stays inside a reclaim::guard_t
+  InternalPage *search_next_from_cache(const Key &from, const Key &to,
+                                       Key &page_to);
+
+  bool add_entry(const Key &from, const Key &to, InternalPage *ptr,
+                 int level = 1);
   const CacheEntry *find_entry(const Key &k);
-  const CacheEntry *find_entry(const Key &from, const Key &to);
+  const CacheEntry *find_entry(const Key &from, const Key &to, int level = 1);
 
   bool invalidate(const CacheEntry *entry);
 
@@ -45,44 +57,47 @@ private:
   std::atomic<int64_t> free_page_cnt;
   std::atomic<int64_t> skiplist_node_cnt;
   int64_t all_page_cnt;
+  std::atomic<uint64_t> key_bound; // level-1 pages cover keys below it
 
-  std::queue<std::pair<void *, uint64_t>> delay_free_list;
-  WRLock free_lock;
-
-  // SkipList
-  CacheSkipList *skiplist;
+  // SkipList, one per level (the pages of a level do not overlap)
+  CacheSkipList *skiplists[define::kMaxLevelOfTree];
   CacheEntryComparator cmp;
   Allocator alloc;
 
+  static void route(InternalPage *page, const Key &k, global_addr_t *addr);
   void evict_one();
 };
 
 inline IndexCache::IndexCache(uint32_t tree_id, uint64_t cache_size) : tree_id(tree_id), cache_size(cache_size) {
-  skiplist = new CacheSkipList(cmp, &alloc, 21);
+  skiplists[0] = nullptr;
+  for (size_t i = 1; i < define::kMaxLevelOfTree; ++i) {
+    skiplists[i] = new CacheSkipList(cmp, &alloc, i == 1 ? 21 : 12);
+  }
   uint64_t memory_size = cache_size * 1024 * 1024;
 
   all_page_cnt = memory_size / sizeof(InternalPage);
   free_page_cnt.store(all_page_cnt);
   skiplist_node_cnt.store(0);
+  key_bound.store(1);
 }
 
 // [from, to）
 inline bool IndexCache::add_entry(const Key &from, const Key &to,
-                                  InternalPage *ptr) {
+                                  InternalPage *ptr, int level) {
 
   // TODO memory leak
-  auto buf = skiplist->AllocateKey(sizeof(CacheEntry));
+  auto buf = skiplists[level]->AllocateKey(sizeof(CacheEntry));
   auto &e = *(CacheEntry *)buf;
   e.from = from;
   e.to = to - 1; // !IMPORTANT;
   e.ptr = ptr;
 
-  return skiplist->InsertConcurrently(buf);
+  return skiplists[level]->InsertConcurrently(buf);
 }
 
 inline const CacheEntry *IndexCache::find_entry(const Key &from,
-                                                const Key &to) {
-  CacheSkipList::Iterator iter(skiplist);
+                                                const Key &to, int level) {
+  CacheSkipList::Iterator iter(skiplists[level]);
 
   CacheEntry e;
   e.from = from;
@@ -101,11 +116,25 @@ inline const CacheEntry *IndexCache::find_entry(const Key &k) {
 }
 
 inline bool IndexCache::add_to_cache(InternalPage *page) {
+  int level = page->hdr.level;
+  assert(level >= 1 && level < (int)define::kMaxLevelOfTree);
+  reclaim::guard_t guard;
   auto new_page = (InternalPage *)malloc(kInternalPageSize);
   memcpy(new_page, page, kInternalPageSize);
   new_page->index_cache_freq = 0;
 
-  if (this->add_entry(page->hdr.lowest, page->hdr.highest, new_page)) {
+  if (level == 1) {
+    // the rightmost page is unbounded
+    Key bound = page->hdr.highest != kKeyMax ? page->hdr.highest
+                                             : page->hdr.lowest + 1;
+    auto old_bound = key_bound.load();
+    while (old_bound < bound &&
+           !key_bound.compare_exchange_weak(old_bound, bound))
+      ;
+  }
+
+  // pinned pages count towards the budget, but only level-1 pages are evicted
+  if (this->add_entry(page->hdr.lowest, page->hdr.highest, new_page, level)) {
     skiplist_node_cnt.fetch_add(1);
     auto v = free_page_cnt.fetch_add(-1);
     if (v <= 0) {
@@ -114,7 +143,7 @@ inline bool IndexCache::add_to_cache(InternalPage *page) {
 
     return true;
   } else { // conflicted
-    auto e = this->find_entry(page->hdr.lowest, page->hdr.highest);
+    auto e = this->find_entry(page->hdr.lowest, page->hdr.highest, level);
     if (e && e->from == page->hdr.lowest && e->to == page->hdr.highest - 1) {
       auto ptr = e->ptr;
       if (ptr == nullptr &&
@@ -135,20 +164,7 @@ inline bool IndexCache::add_to_cache(InternalPage *page) {
 inline const CacheEntry *IndexCache::search_from_cache(const Key &k,
                                                        global_addr_t *addr,
                                                        bool is_leader) {
-  // notice: please ensure the thread 0 can make progress
-  if (is_leader &&
-      !delay_free_list.empty()) { // try to free a page in the delay-free-list
-    auto p = delay_free_list.front();
-    if (asm_rdtsc() - p.second > 3000ull * 10) {
-      free(p.first);
-      free_page_cnt.fetch_add(1);
-
-      free_lock.wLock();
-      delay_free_list.pop();
-      free_lock.wUnlock();
-    }
-  }
-
+  reclaim::guard_t guard;
   auto entry = find_entry(k);
 
   InternalPage *page = entry ? entry->ptr : nullptr;
@@ -156,24 +172,7 @@ inline const CacheEntry *IndexCache::search_from_cache(const Key &k,
   if (page && entry->from <= k && entry->to >= k) {
 
     page->index_cache_freq++;
-
-    auto cnt = page->hdr.last_index + 1;
-    if (k < page->records[0].key) {
-      *addr = page->hdr.leftmost_ptr;
-    } else {
-
-      bool find = false;
-      for (int i = 1; i < cnt; ++i) {
-        if (k < page->records[i].key) {
-          find = true;
-          *addr = page->records[i - 1].ptr;
-          break;
-        }
-      }
-      if (!find) {
-        *addr = page->records[cnt - 1].ptr;
-      }
-    }
+    route(page, k, addr);
 
     compiler_barrier();
     if (entry->ptr) { // check if it is freed.
@@ -184,12 +183,51 @@ inline const CacheEntry *IndexCache::search_from_cache(const Key &k,
   return nullptr;
 }
 
-inline void
-IndexCache::search_range_from_cache(const Key &from, const Key &to,
-                                    std::vector<InternalPage *> &result) {
-  CacheSkipList::Iterator iter(skiplist);
+inline const CacheEntry *
+IndexCache::search_upper_from_cache(const Key &k, global_addr_t *addr) {
+  reclaim::guard_t guard;
+  for (int level = 2; level < (int)define::kMaxLevelOfTree; ++level) {
+    auto entry = find_entry(k, k + 1, level);
+    InternalPage *page = entry ? entry->ptr : nullptr;
+    if (page && entry->from <= k && entry->to >= k) {
+      route(page, k, addr);
+
+      compiler_barrier();
+      if (entry->ptr) {
+        return entry;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+inline void IndexCache::route(InternalPage *page, const Key &k,
+                              global_addr_t *addr) {
+  auto cnt = page->hdr.last_index + 1;
+  if (k < page->records[0].key) {
+    *addr = page->hdr.leftmost_ptr;
+  } else {
+
+    bool find = false;
+    for (int i = 1; i < cnt; ++i) {
+      if (k < page->records[i].key) {
+        find = true;
+        *addr = page->records[i - 1].ptr;
+        break;
+      }
+    }
+    if (!find) {
+      *addr = page->records[cnt - 1].ptr;
+    }
+  }
+}
+
+inline InternalPage *
+IndexCache::search_next_from_cache(const Key &from, const Key &to,
+                                   Key &page_to) {
+  CacheSkipList::Iterator iter(skiplists[1]);
 
-  result.clear();
   CacheEntry e;
   e.from = from;
   e.to = from;
@@ -197,14 +235,17 @@ IndexCache::search_range_from_cache(const Key &from, const Key &to,
 
   while (iter.Valid()) {
     auto val = (const CacheEntry *)iter.key();
-    if (val->ptr) {
-      if (val->from > to) {
-        return;
-      }
-      result.push_back(val->ptr);
+    if (val->from > to) {
+      return nullptr;
+    }
+    auto page = val->ptr;
+    if (page) {
+      page_to = val->to;
+      return page;
     }
     iter.Next();
   }
+  return nullptr;
 }
 
 inline bool IndexCache::invalidate(const CacheEntry *entry) {
@@ -215,47 +256,69 @@ inline bool IndexCache::invalidate(const CacheEntry *entry) {
   }
 
   if (__sync_bool_compare_and_swap(&(entry->ptr), ptr, 0)) {
-
-    free_lock.wLock();
-    delay_free_list.push(std::make_pair(ptr, asm_rdtsc()));
-    free_lock.wUnlock();
+    // readers may still hold the page; it returns to the cache budget once freed
+    reclaim::retire(ptr, kInternalPageSize, [](void *page, void *cache) {
+      free(page);
+      static_cast<IndexCache *>(cache)->free_page_cnt.fetch_add(1);
+    }, this);
     return true;
   }
 
   return false;
 }
 
+// a level-1 page covering a random key below key_bound, nullptr if the
+// sampled keys only hit invalidated entries
 inline const CacheEntry *IndexCache::get_a_random_entry(uint64_t &freq) {
-  uint32_t seed = asm_rdtsc();
-  global_addr_t tmp_addr;
-retry:
-  auto k = rand_r(&seed) % (1000ull * define::MB);
-  auto e = this->search_from_cache(k, &tmp_addr);
-  if (!e) {
-    goto retry;
-  }
-  auto ptr = e->ptr;
-  if (!ptr) {
-    goto retry;
-  }
-
-  freq = ptr->index_cache_freq;
-  if (e->ptr != ptr) {
-    goto retry;
+  reclaim::guard_t guard;
+  thread_local uint64_t seed = asm_rdtsc();
+  for (int i = 0; i < 16; ++i) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    auto k = (seed >> 16) % key_bound.load(std::memory_order_relaxed);
+    auto e = this->find_entry(k);
+    auto ptr = e ? e->ptr : nullptr;
+    if (!ptr || e->from > k || e->to < k) {
+      continue;
+    }
+    freq = ptr->index_cache_freq;
+    if (e->ptr == ptr) {
+      return e;
+    }
   }
-  return e;
+  return nullptr;
 }
 
 inline void IndexCache::evict_one() {
+  const CacheEntry *victim = nullptr;
+  uint64_t victim_freq = 0;
+  const CacheEntry *candidates[define::kIndexCacheEvictSamples];
+  int cnt = 0;
+
+  for (int i = 0; i < define::kIndexCacheEvictSamples; ++i) {
+    uint64_t freq;
+    auto e = get_a_random_entry(freq);
+    if (!e) {
+      continue;
+    }
+    candidates[cnt++] = e;
+    if (!victim || freq < victim_freq) {
+      victim = e;
+      victim_freq = freq;
+    }
+  }
 
-  uint64_t freq1, freq2;
-  auto e1 = get_a_random_entry(freq1);
-  auto e2 = get_a_random_entry(freq2);
+  // the spared candidates age, so that pages that turned cold lose their rank
+  reclaim::guard_t guard;
+  for (int i = 0; i < cnt; ++i) {
+    auto ptr = candidates[i]->ptr;
+    if (candidates[i] != victim && ptr) {
+      ptr->index_cache_freq >>= 1;
+    }
+  }
 
-  if (freq1 < freq2) {
-    invalidate(e1);
-  } else {
-    invalidate(e2);
+  // none found: the budget is overrun until a later admission evicts
+  if (victim) {
+    invalidate(victim);
   }
 }
 
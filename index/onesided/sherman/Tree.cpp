@@ -3,6 +3,7 @@
 #include "index/onesided/sherman/Timer.h"
 #include "client/transport.h"
 #include "system/workload.h"
+#include "system/stats.h"
 #include "utils/helper.h"
 
 #include <algorithm>
@@ -124,6 +125,7 @@ global_addr_t Tree::get_root_ptr(CoroContext *cxt, int coro_id) {
     char* page_buffer = transport->get_buffer();
     // debug_check_root("get_root_ptr before");
     transport->read(page_buffer, root_ptr_ptr, sizeof(global_addr_t));
+    INC_INT_STATS(num_index_round_trips, 1);
     // debug_check_root("get_root_ptr after");
     global_addr_t root_ptr = global_addr_t::null();
     memcpy(&root_ptr, page_buffer, sizeof(global_addr_t));
@@ -243,11 +245,18 @@ void Tree::print_and_check_tree(CoroContext *cxt, int coro_id) {
 //   // }
 }
 
+// if page_buffer is given, the page is read with the same doorbell as the lock CAS
 inline bool Tree::try_lock_addr(global_addr_t lock_addr, uint64_t tag,
-                                uint64_t *buf, CoroContext *cxt, int coro_id) {
+                                uint64_t *buf, CoroContext *cxt, int coro_id,
+                                char *page_buffer, global_addr_t page_addr,
+                                int page_size) {
 
   bool hand_over = acquire_local_lock(lock_addr, cxt, coro_id);
   if (hand_over) {
+    if (page_buffer != nullptr) {
+      transport->read(page_buffer, page_addr, page_size);
+      INC_INT_STATS(num_index_round_trips, 1);
+    }
     return true;
   }
 
@@ -270,16 +279,27 @@ inline bool Tree::try_lock_addr(global_addr_t lock_addr, uint64_t tag,
     // debug_check_root("try_lock_addr before cas_dm");
     assert(root_ptr_ptr != lock_addr);
     *buf = tag;
+    transport_t::wr_batch_t batch;
   #ifdef CONFIG_ENABLE_EMBEDDING_LOCK
-    bool res = transport->cas((char*)buf, lock_addr, 0, tag, 8);
+    batch.cas((char*)buf, lock_addr, 0, tag, 8);
   #else
     assert(lock_addr.addr < define::kLockChipMemSize);
-    bool res = transport->cas_dm((char*)buf, lock_addr, 0, tag, 8);
+    batch.cas_dm((char*)buf, lock_addr, 0, tag, 8);
   #endif
+    // the page read is wasted if the CAS fails, but saves a round trip otherwise
+    if (page_buffer != nullptr)
+      batch.read(page_buffer, page_addr, page_size);
+    transport->post_batch(batch);
+    INC_INT_STATS(num_index_round_trips, 1);
+    bool res = batch.cas_succeeded(0);
     // bool res = dsm->cas_dm_sync(lock_addr, 0, tag, buf, cxt);
     // debug_check_root("try_lock_addr after cas_dm");
 
     if (!res) {
+      // nothing to undo: the CAS left the lock as is and the page read is dropped
+      if (page_buffer != nullptr) {
+        INC_INT_STATS(num_speculative_misses, 1);
+      }
       conflict_tag = *buf - 1;
       if (conflict_tag != pre_tag) {
         retry_cnt = 0;
@@ -324,6 +344,7 @@ inline void Tree::unlock_addr(global_addr_t lock_addr, uint64_t tag,
     assert(lock_addr.addr < define::kLockChipMemSize);
     transport->write_dm((char *)buf, lock_addr, sizeof(uint64_t));
   #endif
+    INC_INT_STATS(num_index_round_trips, 1);
     // dsm->write_dm_sync((char *)cas_buf, lock_addr, sizeof(uint64_t), cxt);
   }
     // debug_check_root("unlock_addr after write_dm");
@@ -340,57 +361,28 @@ void Tree::write_page_and_unlock(char *page_buffer, global_addr_t page_addr,
   if (hand_over_other) {
     // debug_check_root("write_page_and_unlock before write");
     transport->write(page_buffer, page_addr, page_size);
+    INC_INT_STATS(num_index_round_trips, 1);
     // dsm->write_sync(page_buffer, page_addr, page_size, cxt);
     // debug_check_root("write_page_and_unlock after write");
     releases_local_lock(lock_addr);
     return;
   }
 
-  // RdmaOpRegion rs[2];
-  // rs[0].source = (uint64_t)page_buffer;
-  // rs[0].dest = page_addr;
-  // rs[0].size = page_size;
-  // rs[0].is_on_chip = false;
-
-  // rs[1].source = (uint64_t)dsm->get_rbuf(coro_id).get_cas_buffer();
-  // rs[1].dest = lock_addr;
-  // rs[1].size = sizeof(uint64_t);
-
-  // rs[1].is_on_chip = true;
-
-  // *(uint64_t *)rs[1].source = 0;
     assert(root_ptr_ptr != page_addr);
     assert(root_ptr_ptr != lock_addr);
-  if (async) {
-    // debug_check_root("write_page_and_unlock before write_batch write");
-    transport->write(page_buffer, page_addr, page_size, false);
-    // debug_check_root("write_page_and_unlock after write_batch write");
-    // transport->write(page_buffer, page_addr, page_size, false);
-  *cas_buffer = 0;
-  #ifdef CONFIG_ENABLE_EMBEDDING_LOCK
-    transport->write((char*)cas_buffer, lock_addr, sizeof(uint64_t));
-  #else
-    assert(lock_addr.addr < define::kLockChipMemSize);
-    transport->write_dm((char*)cas_buffer, lock_addr, sizeof(uint64_t));
-  #endif
-    // debug_check_root("write_page_and_unlock after write_batch write_dm");
-    // transport->write_dm((char*)cas_buffer, lock_addr, sizeof(uint64_t), false);
-    // dsm->write_batch(rs, 2, false);
-  } else {
-    // debug_check_root("write_page_and_unlock before write_batch write");
-    transport->write(page_buffer, page_addr, page_size, false);
-    // debug_check_root("write_page_and_unlock after write_batch write");
-    // transport->write(page_buffer, page_addr, page_size, false);
+  // write back the page and release the lock with one doorbell
+  // (the unlock is ordered after the page write on the same QP)
+  transport_t::wr_batch_t batch;
+  batch.write(page_buffer, page_addr, page_size);
   *cas_buffer = 0;
   #ifdef CONFIG_ENABLE_EMBEDDING_LOCK
-    transport->write((char*)cas_buffer, lock_addr, sizeof(uint64_t));
+  batch.write((char*)cas_buffer, lock_addr, sizeof(uint64_t));
   #else
-    assert(lock_addr.addr < define::kLockChipMemSize);
-    transport->write_dm((char*)cas_buffer, lock_addr, sizeof(uint64_t));
+  assert(lock_addr.addr < define::kLockChipMemSize);
+  batch.write_dm((char*)cas_buffer, lock_addr, sizeof(uint64_t));
   #endif
-    // debug_check_root("write_page_and_unlock after write_batch write_dm");
-    // dsm->write_batch_sync(rs, 2, cxt);
-  }
+  transport->post_batch(batch);
+  INC_INT_STATS(num_index_round_trips, 1);
 
   releases_local_lock(lock_addr);
 }
@@ -401,11 +393,8 @@ void Tree::lock_and_read_page(char *page_buffer, global_addr_t page_addr,
                               CoroContext *cxt, int coro_id) {
 
     assert(root_ptr_ptr != page_addr);
-  try_lock_addr(lock_addr, tag, cas_buffer, cxt, coro_id);
-    // debug_check_root("lock_and_read_page before read");
-  transport->read(page_buffer, page_addr, page_size);
-    // debug_check_root("lock_and_read_page after read");
-  // dsm->read_sync(page_buffer, page_addr, page_size, cxt);
+  try_lock_addr(lock_addr, tag, cas_buffer, cxt, coro_id, page_buffer,
+                page_addr, page_size);
 }
 
 // void Tree::lock_bench(const Key &k, CoroContext *cxt, int coro_id) {
@@ -459,6 +448,7 @@ next:
 void Tree::insert(const Key &k, const Value &v, CoroContext *cxt, int coro_id) {
   // assert(dsm->is_register());
 
+  INC_INT_STATS(num_index_ops, 1);
   before_operation(cxt, coro_id);
 
   // avoid index cache upon index building
@@ -515,13 +505,14 @@ next:
 bool Tree::search(const Key &k, Value &v, CoroContext *cxt, int coro_id) {
   // assert(dsm->is_register());
 
-  auto root = get_root_ptr(cxt, coro_id);
+  INC_INT_STATS(num_index_ops, 1);
   SearchResult result;
 
-  global_addr_t p = root;
+  global_addr_t p = global_addr_t::null();
 
   bool from_cache = false;
   const CacheEntry *entry = nullptr;
+  const CacheEntry *upper = nullptr;
   if (index_cache) {
     global_addr_t cache_addr;
     entry = index_cache->search_from_cache(k, &cache_addr,
@@ -535,6 +526,14 @@ bool Tree::search(const Key &k, Value &v, CoroContext *cxt, int coro_id) {
       cache_miss[GET_THD_ID][0]++;
     }
   }
+  // a cache hit goes straight to the leaf, a miss below the cached upper
+  // levels, the root is read only if they miss too
+  if (!from_cache && index_cache) {
+    upper = index_cache->search_upper_from_cache(k, &p);
+  }
+  if (!from_cache && !upper) {
+    p = get_root_ptr(cxt, coro_id);
+  }
 
 next:
   if (!page_search(p, k, result, cxt, coro_id, from_cache)) {
@@ -544,7 +543,7 @@ next:
       cache_miss[GET_THD_ID][0]++;
       from_cache = false;
 
-      p = root;
+      p = get_root_ptr(cxt, coro_id);
     } else {
       std::cout << "SEARCH WARNING search" << std::endl;
       sleep(1);
@@ -562,6 +561,11 @@ next:
     }
     return false; // not found
   } else {        // internal
+    if (upper && result.slibing != global_addr_t::null()) {
+      // the cached parent missed a split, re-read it on the next miss
+      index_cache->invalidate(upper);
+    }
+    upper = nullptr;
     p = result.slibing != global_addr_t::null() ? result.slibing
                                                 : result.next_level;
     goto next;
@@ -570,22 +574,59 @@ next:
 
 uint64_t Tree::range_query(const Key &from, const Key &to, Value *value_buffer,
                            CoroContext *cxt, int coro_id) {
+  RangeCursor cursor(this, from, to, std::numeric_limits<int>::max(),
+                     std::numeric_limits<int>::max());
+  uint64_t counter = 0;
+  Key k;
+  Value v;
+  while (cursor.next(k, v)) {
+    value_buffer[counter++] = v;
+  }
+  return counter;
+}
+
+int Tree::scan(Key k, int range, value_t *&buffer) {
+  RangeCursor cursor(this, k, kKeyMax, range, range);
+  int counter = 0;
+  Key key;
+  Value v;
+  while (cursor.next(key, v)) {
+    buffer[counter++].val = v;
+  }
+  return counter;
+}
 
-  const int kParaFetch = 32;
-  thread_local std::vector<InternalPage *> result;
-  thread_local std::vector<global_addr_t> leaves;
+Tree::RangeCursor::RangeCursor(Tree *tree, const Key &from, const Key &to,
+                               int max_cnt, int fetch_size)
+    : from(from), to(to), max_cnt(max_cnt), fetch_size(fetch_size),
+      counter(0), cache(tree->index_cache), next_key(from), collected(false),
+      next_leaf(0), posted(0), decoded(0), pos(0) {
+  static_assert(kNumSlots * kWaveSize * kLeafPageSize <= MAX_MESSAGE_SIZE,
+                "the ring must fit in the transport buffer");
+  ring = transport->get_buffer();
+  INC_INT_STATS(num_index_ops, 1);
+}
 
-  result.clear();
+// replaces the leaves with those of the next cached page in the range; false
+// once the range has no leaves left
+bool Tree::RangeCursor::collect_leaves() {
   leaves.clear();
-  index_cache->search_range_from_cache(from, to, result);
-  
-  // FIXME: here, we assume all innernal nodes are cached in compute node
-  if (result.empty()) {
-    return 0;
-  }
+  next_leaf = 0;
+  while (leaves.empty() && !collected) {
+    // the leaf addresses stay valid, the cached page only inside the guard
+    reclaim::guard_t guard;
+    Key page_to;
+    // FIXME: here, we assume all innernal nodes are cached in compute node
+    auto page = cache->search_next_from_cache(next_key, to, page_to);
+    if (page == nullptr || page_to >= to) {
+      collected = true;
+    } else {
+      next_key = page_to + 1;
+    }
+    if (page == nullptr) {
+      break;
+    }
 
-  uint64_t counter = 0;
-  for (auto page : result) {
     auto cnt = page->hdr.last_index + 1;
     auto addr = page->hdr.leftmost_ptr;
 
@@ -607,54 +648,85 @@ uint64_t Tree::range_query(const Key &from, const Key &to, Value *value_buffer,
       leaves.push_back(page->records[cnt - 1].ptr);
     }
   }
+  return !leaves.empty();
+}
 
-  int cq_cnt = 0;
-  char *range_buffer = transport->get_buffer();
-  // char *range_buffer = (dsm->get_rbuf(coro_id)).get_range_buffer();
-  for (size_t i = 0; i < leaves.size(); ++i) {
-    if (i > 0 && i % kParaFetch == 0) {
-      // dsm->poll_rdma_cq(kParaFetch);
-      cq_cnt -= kParaFetch;
-      for (int k = 0; k < kParaFetch; ++k) {
-        auto page = (LeafPage *)(range_buffer + k * kLeafPageSize);
-        for (int i = 0; i < kLeafCardinality; ++i) {
-          auto &r = page->records[i];
-          if (r.value != kValueNull && r.f_version == r.r_version) {
-            if (r.key >= from && r.key <= to) {
-              value_buffer[counter++] = r.value;
-            }
-          }
-        }
-      }
+bool Tree::RangeCursor::next(Key &k, Value &v) {
+  if (pos == records.size()) {
+    fetch();
+    if (records.empty()) {
+      return false;
     }
-    transport->read(range_buffer + kLeafPageSize * (i % kParaFetch), leaves[i],
-                    kLeafPageSize);
-    // dsm->read(range_buffer + kLeafPageSize * (i % kParaFetch), leaves[i],
-    //           kLeafPageSize, true);
-    cq_cnt++;
-  }
-
-  if (cq_cnt != 0) {
-    // dsm->poll_rdma_cq(cq_cnt);
-    for (int k = 0; k < cq_cnt; ++k) {
-      auto page = (LeafPage *)(range_buffer + k * kLeafPageSize);
-      for (int i = 0; i < kLeafCardinality; ++i) {
-        auto &r = page->records[i];
-        if (r.value != kValueNull && r.f_version == r.r_version) {
-          if (r.key >= from && r.key <= to) {
-            value_buffer[counter++] = r.value;
-          }
+  }
+  k = records[pos].first;
+  v = records[pos].second;
+  pos++;
+  return true;
+}
+
+void Tree::RangeCursor::fetch() {
+  records.clear();
+  pos = 0;
+  while (records.size() < (size_t)fetch_size && counter < max_cnt) {
+    while (posted - decoded < kNumSlots &&
+           (next_leaf < leaves.size() || collect_leaves())) {
+      post_wave();
+    }
+    if (decoded == posted) { // range exhausted
+      break;
+    }
+    decode_wave();
+  }
+  // nothing stays in flight once the caller gets control
+  while (decoded < posted) {
+    decode_wave();
+  }
+}
+
+void Tree::RangeCursor::post_wave() {
+  auto &batch = batches[posted % kNumSlots];
+  char *slot = ring + (posted % kNumSlots) * kWaveSize * kLeafPageSize;
+  for (int i = 0;
+       i < kWaveSize && (next_leaf < leaves.size() || collect_leaves());
+       ++i, ++next_leaf) {
+    batch.read(slot + i * kLeafPageSize, leaves[next_leaf], kLeafPageSize);
+  }
+  transport->post_batch_async(batch);
+  posted++;
+}
+
+void Tree::RangeCursor::decode_wave() {
+  auto &batch = batches[decoded % kNumSlots];
+  char *slot = ring + (decoded % kNumSlots) * kWaveSize * kLeafPageSize;
+  transport->wait_batch(batch);
+  INC_INT_STATS(num_index_round_trips, 1);
+
+  size_t begin = records.size();
+  for (uint32_t k = 0; k < batch.size(); ++k) {
+    auto page = (LeafPage *)(slot + k * kLeafPageSize);
+    for (int i = 0; i < kLeafCardinality; ++i) {
+      auto &r = page->records[i];
+      if (r.value != kValueNull && r.f_version == r.r_version) {
+        if (r.key >= from && r.key <= to) {
+          records.emplace_back(Key(r.key), Value(r.value));
         }
       }
     }
   }
-
-  return counter;
+  batch.clear();
+  decoded++;
+
+  // leaves are read in key order, the records of a leaf are not sorted
+  std::sort(records.begin() + begin, records.end());
+  size_t cnt = std::min<size_t>(records.size() - begin, max_cnt - counter);
+  records.resize(begin + cnt);
+  counter += cnt;
 }
 
 void Tree::del(const Key &k, CoroContext *cxt, int coro_id) {
   // assert(dsm->is_register());
 
+  INC_INT_STATS(num_index_ops, 1);
   before_operation(cxt, coro_id);
 
   if (index_cache) {
@@ -718,41 +790,65 @@ bool Tree::page_search(global_addr_t page_addr, const Key &k,
   }
   assert(page_addr.addr != 0);
   int counter = 0;
+#ifdef CONFIG_ENABLE_SPECULATIVE_READ
+  // speculative: a single read of the page, validated below by the page
+  // versions (and CRC); a retry falls back to the guarded reads
+  bool speculative = true;
+  transport->read(page_buffer, page_addr, kLeafPageSize);
+  INC_INT_STATS(num_index_round_trips, 1);
+#ifdef CONFIG_ENABLE_EMBEDDING_LOCK
+  if (*reinterpret_cast<uint64_t*>(page_buffer) != 0) { // locked
+    INC_INT_STATS(num_speculative_misses, 1);
+    goto re_read;
+  }
+#endif
+  goto validate;
+#endif
 re_read:
+#ifdef CONFIG_ENABLE_SPECULATIVE_READ
+  speculative = false;
+#endif
   if (++counter > 100) {
     printf("re read too many times\n");
     sleep(1);
   }
-    // debug_check_root("page_search before read1");
-  transport->read(page_buffer, page_addr, 16);
-    // debug_check_root("page_search after read1");
-
-  uint64_t embedding_lock = *reinterpret_cast<uint64_t*>(page_buffer);
-  if (embedding_lock != 0) {
-    // printf("embedding lock not 0 (%lu)\n", embedding_lock);
-    goto re_read;
-  }
-  uint8_t version_start = *reinterpret_cast<uint8_t*>(page_buffer + 8);
-
-    // debug_check_root("page_search before read2");
-  transport->read(page_buffer, page_addr, kLeafPageSize);
-    // debug_check_root("page_search after read2");
-
-    // debug_check_root("page_search before read3");
-  transport->read(page_buffer, page_addr, 16);
-    // debug_check_root("page_search after read3");
-  embedding_lock = *reinterpret_cast<uint64_t*>(page_buffer);
-  uint8_t version_end = *reinterpret_cast<uint8_t*>(page_buffer + 8);
-  // if (version_start != version_end) {
-  //   printf("version not match %u, %u\n", version_start, version_end);
-  //   goto re_read;
-  // }
-  if ((version_start != version_end) || (embedding_lock != 0)) {
-    // printf("v_start %u, v_end %u, embedding lock (%lu)\n", version_start, version_end, embedding_lock);
-    goto re_read;
+  {
+      // debug_check_root("page_search before read1");
+    transport->read(page_buffer, page_addr, 16);
+    INC_INT_STATS(num_index_round_trips, 1);
+      // debug_check_root("page_search after read1");
+
+    uint64_t embedding_lock = *reinterpret_cast<uint64_t*>(page_buffer);
+    if (embedding_lock != 0) {
+      // printf("embedding lock not 0 (%lu)\n", embedding_lock);
+      goto re_read;
+    }
+    uint8_t version_start = *reinterpret_cast<uint8_t*>(page_buffer + 8);
+
+      // debug_check_root("page_search before read2");
+    transport->read(page_buffer, page_addr, kLeafPageSize);
+      // debug_check_root("page_search after read2");
+
+      // debug_check_root("page_search before read3");
+    transport->read(page_buffer, page_addr, 16);
+    INC_INT_STATS(num_index_round_trips, 2);
+      // debug_check_root("page_search after read3");
+    embedding_lock = *reinterpret_cast<uint64_t*>(page_buffer);
+    uint8_t version_end = *reinterpret_cast<uint8_t*>(page_buffer + 8);
+    // if (version_start != version_end) {
+    //   printf("version not match %u, %u\n", version_start, version_end);
+    //   goto re_read;
+    // }
+    if ((version_start != version_end) || (embedding_lock != 0)) {
+      // printf("v_start %u, v_end %u, embedding lock (%lu)\n", version_start, version_end, embedding_lock);
+      goto re_read;
+    }
   }
   // dsm->read_sync(page_buffer, page_addr, kLeafPageSize, cxt);
 
+#ifdef CONFIG_ENABLE_SPECULATIVE_READ
+validate:
+#endif
   memset(&result, 0, sizeof(result));
   result.is_leaf = header->leftmost_ptr == global_addr_t::null();
   result.level = header->level;
@@ -763,6 +859,11 @@ re_read:
   if (result.is_leaf) {
     auto page = (LeafPage *)page_buffer;
     if (!page->check_consistent()) {
+#ifdef CONFIG_ENABLE_SPECULATIVE_READ
+      if (speculative) {
+        INC_INT_STATS(num_speculative_misses, 1);
+      }
+#endif
       goto re_read;
     }
 
@@ -789,10 +890,15 @@ re_read:
     auto page = (InternalPage *)page_buffer;
 
     if (!page->check_consistent()) {
+#ifdef CONFIG_ENABLE_SPECULATIVE_READ
+      if (speculative) {
+        INC_INT_STATS(num_speculative_misses, 1);
+      }
+#endif
       goto re_read;
     }
 
-    if (result.level == 1 && index_cache) {
+    if (index_cache) { // level 1 by hotness, the upper levels pinned
       index_cache->add_to_cache(page);
     }
 
@@ -973,6 +1079,7 @@ void Tree::internal_page_store(global_addr_t page_addr, const Key &k,
     sibling->set_consistent();
     // debug_check_root("internal_page_store before write sibling");
     transport->write(sibling_buf, sibling_addr, kInternalPageSize);
+    INC_INT_STATS(num_index_round_trips, 1);
     // dsm->write_sync(sibling_buf, sibling_addr, kInternalPageSize, cxt);
     // debug_check_root("internal_page_store after write sibling");
   }
@@ -1161,6 +1268,7 @@ bool Tree::leaf_page_store(global_addr_t page_addr, const Key &k,
     // debug_check_root("leaf_page_store before write sibling");
     assert(sibling_addr != root_ptr_ptr);
     transport->write(sibling_buf, sibling_addr, kLeafPageSize);
+    INC_INT_STATS(num_index_round_trips, 1);
     // dsm->write_sync(sibling_buf, sibling_addr, kLeafPageSize, cxt);
     // debug_check_root("leaf_page_store after write sibling");
   }
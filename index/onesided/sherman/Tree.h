@@ -3,11 +3,14 @@
 #include "index/onesided/sherman/Common.h"
 #include "system/global.h"
 #include "system/global_address.h"
+#include "transport/transport.h"
 #include "utils/packetize.h"
 #include <atomic>
 #include <city.h>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 #if !PARTITIONED
 namespace sherman {
@@ -56,7 +59,7 @@ public:
     v.val = val;
     return ret; }
   bool remove(Key k) { del(k); return true; }
-  int scan(Key k, int range, value_t*& buffer) { return 0; } // TODO
+  int scan(Key k, int range, value_t*& buffer);
 
   // dummy functions
   int search_cache(Key k, UnstructuredBuffer& buffer) { return 0; }
@@ -74,6 +77,8 @@ public:
 
   uint64_t range_query(const Key &from, const Key &to, Value *buffer,
                        CoroContext *cxt = nullptr, int coro_id = 0);
+  // streaming range scan, consumed one record at a time
+  class RangeCursor;
 
   void print_and_check_tree(CoroContext *cxt = nullptr, int coro_id = 0);
 
@@ -116,7 +121,10 @@ private:
                        int coro_id, int level);
 
   bool try_lock_addr(global_addr_t lock_addr, uint64_t tag, uint64_t *buf,
-                     CoroContext *cxt, int coro_id);
+                     CoroContext *cxt, int coro_id,
+                     char *page_buffer = nullptr,
+                     global_addr_t page_addr = global_addr_t::null(),
+                     int page_size = 0);
   void unlock_addr(global_addr_t lock_addr, uint64_t tag, uint64_t *buf,
                    CoroContext *cxt, int coro_id, bool async);
   void write_page_and_unlock(char *page_buffer, global_addr_t page_addr,
@@ -151,6 +159,54 @@ private:
   void debug_check_root(const char* location);
 };
 
+// Range scan over [from, to] that yields records in key order.
+// The leaves covering the range are found in the cached level-1 pages, one page
+// at a time as the waves need them, and read in waves of kWaveSize leaves, each
+// posted with one doorbell. A ring of kNumSlots waves keeps the next waves in
+// flight while the current one is decoded, and no wave is posted (nor page
+// searched) once max_cnt records have been decoded.
+// The cursor buffers about fetch_size records at a time and drains the ring
+// before next() returns, so the caller may issue other ops between calls.
+class Tree::RangeCursor {
+public:
+  static constexpr int kNumSlots = 2;
+  static constexpr int kWaveSize = transport_t::wr_batch_t::MAX_WRS;
+  static constexpr int kFetchSize = 256;
+
+  RangeCursor(Tree *tree, const Key &from, const Key &to,
+              int max_cnt = std::numeric_limits<int>::max(),
+              int fetch_size = kFetchSize);
+
+  // false once the range or max_cnt is exhausted
+  bool next(Key &k, Value &v);
+
+private:
+  void fetch();
+  bool collect_leaves();
+  void post_wave();
+  void decode_wave();
+
+  Key from;
+  Key to;
+  int max_cnt;
+  int fetch_size;
+  int counter; // records decoded
+
+  IndexCache *cache;
+  Key next_key;   // first key whose cached page has not been collected
+  bool collected; // the last page of the range has been collected
+
+  std::vector<global_addr_t> leaves;
+  size_t next_leaf; // first leaf not posted (of the collected ones)
+  uint64_t posted;  // waves posted
+  uint64_t decoded; // waves decoded
+  char *ring;
+  transport_t::wr_batch_t batches[kNumSlots];
+
+  std::vector<std::pair<Key, Value>> records;
+  size_t pos;
+};
+
 class Header {
 private:
   global_addr_t leftmost_ptr;
@@ -262,6 +318,22 @@ public:
     embedding_lock = 0;
   }
 
+  // a page of a tree image built offline (test/index_cache.cpp)
+  InternalPage(const Key &lowest, const Key &highest, global_addr_t left,
+               const std::vector<InternalEntry> &entries, uint32_t level)
+      : InternalPage(level) {
+    assert(entries.size() <= kInternalCardinality);
+    hdr.lowest = lowest;
+    hdr.highest = highest;
+    hdr.leftmost_ptr = left;
+    hdr.last_index = entries.size() - 1;
+    records[0].key = kKeyMax; // a single child
+    for (size_t i = 0; i < entries.size(); ++i) {
+      records[i] = entries[i];
+    }
+    set_consistent();
+  }
+
   void set_consistent() {
     front_version++;
     rear_version = front_version;
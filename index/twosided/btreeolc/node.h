@@ -1,6 +1,7 @@
 #pragma once
 
 #include "system/global.h"
+#include "utils/search.h"
 #include <atomic>
 #include <cstring>
 #include <iostream>
@@ -151,7 +152,11 @@ struct BTreeLeaf: public BTreeLeafBase{
 	}
 
     unsigned lowerBound(Key k){
+		#if SIMD_SEARCH
+		return search::lower_bound(data, count, k);
+		#else
 		return linearSearch(k);
+		#endif
     }
 
     unsigned binarySearch(Key k){
@@ -306,17 +311,15 @@ struct BTreeLeaf: public BTreeLeafBase{
 		return false;
     }
 
+    // appends the payloads from k on to v[cnt..num), returns how many were appended
     int scan(Key k, int num, Payload*& v, int cnt){
 		unsigned pos = lowerBound(k);
-		if(pos < count && k <= data[pos].first){
-			for(int i=pos; i<count; i++){
-				v[cnt++] = data[i].second;
-				if(cnt == num)
-					return i-pos+1;
-			}
-			return count-pos+1;
+		int appended = 0;
+		for(unsigned i=pos; i<count && cnt<num; i++){
+			v[cnt++] = data[i].second;
+			appended++;
 		}
-		return -1;
+		return appended;
     }
 
     bool rangeValid(Key k){
@@ -365,6 +368,8 @@ struct BTreeInner: public BTreeInnerBase{
     unsigned lowerBound(Key k){
 		#ifdef BINARY_SEARCH
 		return binarySearch(k);
+		#elif SIMD_SEARCH
+		return search::lower_bound(data, count, k);
 		#else
 		return linearSearch(k);
 		#endif
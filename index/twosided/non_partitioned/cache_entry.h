@@ -27,14 +27,28 @@ struct EntryLock {
 template <typename Payload>
 struct CacheEntry : public EntryLock {
     std::atomic<uint8_t> frequency;
+    std::atomic<uint32_t> clock_slot; // slot in the CLOCK ring of the cache (EVICT_CLOCK)
     uint64_t key;
     Payload data;
 
-    CacheEntry(): EntryLock(), frequency(0), key(0), data() {}
-    CacheEntry(Key k, Payload p): EntryLock(), frequency(0), key(k), data(p) {}
+    CacheEntry(): EntryLock(), frequency(0), clock_slot(UINT32_MAX), key(0), data() {}
+    CacheEntry(Key k, Payload p): EntryLock(), frequency(0), clock_slot(UINT32_MAX), key(k), data(p) {}
     void reset() { frequency.store(0); }
     uint8_t getFrequency() { return frequency.load(); }
     void incrementFrequency() { frequency.fetch_add(1); }
+    // marks a hit for the CLOCK hand without a read-modify-write
+    void reference() {
+        if (frequency.load(std::memory_order_relaxed) == 0)
+            frequency.store(1, std::memory_order_relaxed);
+    }
+    // halves the frequency when the CLOCK hand passes; false if it has already aged to zero
+    bool ageFrequency() {
+        auto freq = frequency.load();
+        if (freq == 0)
+            return false;
+        frequency.compare_exchange_strong(freq, freq >> 1);
+        return true;
+    }
 
     uint64_t getKey() { return key; }
     uint64_t* getKeyPtr() { return &key; }
@@ -3,6 +3,10 @@
 #include "system/global.h"
 #include "utils/helper.h"
 #include "utils/packetize.h"
+#include "utils/frequency_sketch.h"
+#include "utils/clock_ring.h"
+#include "utils/reclaim.h"
+#include "utils/object_pool.h"
 #include "index/idx_wrapper.h"
 #include "index/twosided/btreeolc/node.h"
 #include "index/twosided/btreeolc/tree.h"
@@ -15,9 +19,9 @@ class cache_manager_t: public idx_wrapper_t<Value>{
 public:
 	using ValueType = CacheEntry<Value>;
 
-	struct ThreadStruct {
+	struct alignas(64) ThreadStruct { // padded, as each client thread updates its own
 		uint32_t slots = 0;
-		std::vector<std::pair<ValueType*, uint64_t>> free_set;
+		uint64_t clock_hint = 0; // ring slot of the last victim, reused for the next entry
 	};
 
 	cache_manager_t(uint32_t index_id, uint64_t index_cache_size): _index_id(index_id) {
@@ -26,9 +30,21 @@ public:
 		thread_data.resize(g_num_client_threads);
 		page_offset.store(0);
 		page_num = (index_cache_size * 1024 * 1024) / sizeof(ValueType);
-		if (page_num > 0)
+		sketch = nullptr;
+		clock = nullptr;
+		pool = nullptr;
+		if (page_num > 0) {
 			index_cache = new BTree<ValueType*>();
-		admission_rate = static_cast<uint64_t>(g_admission_rate * 100);
+#if CACHE_ADMISSION == ADMIT_TINYLFU
+			sketch = new frequency_sketch_t(page_num);
+#endif
+#if CACHE_EVICTION == EVICT_CLOCK
+			clock = new clock_ring_t<ValueType>(page_num);
+#endif
+			// retired entries wait for reclamation on top of the cached ones
+			pool = new object_pool_t<ValueType>(page_num + page_num / 4, g_num_client_threads);
+		}
+		admission_rate.store(static_cast<uint64_t>(g_admission_rate * 100));
 	}
 
 	// index operations (dummy)
@@ -38,11 +54,17 @@ public:
 	bool lookup(Key k, Value& v) { assert(false); return false; }
 	int scan(Key k, int range, Value*& v) { assert(false); return 0; }
 
+	// only random admission has a rate; TinyLFU decides by frequency
+	void set_admission_ratio(double ratio) { if (CACHE_ADMISSION == ADMIT_RANDOM) admission_rate.store(static_cast<uint64_t>(ratio * 100)); }
+	double get_admission_ratio() { return CACHE_ADMISSION == ADMIT_RANDOM ? admission_rate.load() / 100.0 : -1; }
+
 	// cache operations
 	int search_cache(Key k, UnstructuredBuffer& entry) {
 		if (index_cache == nullptr) return 0; // no hint
 
+		reclaim::guard_t guard;
 		uint32_t repeat = 0;
+		record_access(k);
 		bool update_freq = update_frequency();
 	restart:
 		if (repeat++ > 10000000) {
@@ -66,12 +88,13 @@ public:
 				goto restart;
 			}
 
+			reference(ptr, update_freq);
 			// entry.put(&ptr);
 			entry.put(&value);
 			return 2; // cache hit
 		}
 		// cache miss
-		bool admit = admit_to_cache();
+		bool admit = admit_to_cache(k);
 		if (!admit)
 			return 0; // cache miss, but no cache admission
 		return 1; // cache miss, do admit the cache
@@ -79,35 +102,83 @@ public:
 
 	void invalidate(char* entry) {
 		assert(index_cache);
+		reclaim::guard_t guard;
 		invalidate(reinterpret_cast<ValueType*>(entry));
 	}
 
 	void add_to_cache(Key k, char* ptr) {
 		assert(index_cache);
-		get_slot();
+		reclaim::guard_t guard;
+		if (!get_slot()) // nothing could be evicted, skip the admission
+			return;
 		ValueType* temp = nullptr;
 		Value v(reinterpret_cast<row_t*>(ptr));
-		auto slot = new ValueType(k, v);
+		auto slot = pool->alloc(GET_THD_ID, k, v);
 		bool ret = index_cache->upsert(k, slot, temp);
-		if (ret) // replaced an existing item
-			set_local_slot(temp, false);
+		if (ret) // replaced an existing item, whose slot is free again
+			set_local_slot(temp);
+		track(slot);
 	}
 
 private:
-	void evict() {
+	// returns false if there was nothing to evict
+	bool evict() {
 	restart:
+		auto p = get_victim();
+		if (!p) // nothing to evict
+			return false;
+		if (!invalidate(p, false))
+			goto restart;
+		return true;
+	}
+
+	// the entry to evict (nullptr if the cache is empty, EVICT_CLOCK only)
+	ValueType* get_victim() {
+#if CACHE_EVICTION == EVICT_CLOCK
+		auto p = clock->next_victim();
+		if (p)
+			thread_data[GET_THD_ID].clock_hint = p->clock_slot.load();
+		return p;
+#else
 		auto p1 = sample_page();
 		auto p2 = sample_page();
-		auto p = p1->getFrequency() < p2->getFrequency() ? p1 : p2;
-		if (!invalidate(p))
-			goto restart;
+		return p1->getFrequency() < p2->getFrequency() ? p1 : p2;
+#endif
+	}
+
+	// a candidate victim for admission, without aging any entry (nullptr if there is none)
+	// with EVICT_CLOCK, the less frequently used of two random entries of the ring
+	// (the entry under the hand only changes on eviction, so it would reject every key that loses to it once)
+	ValueType* peek_victim() {
+#if CACHE_EVICTION == EVICT_CLOCK
+		static thread_local std::mt19937_64* gen = nullptr;
+		if (!gen) gen = new std::mt19937_64(asm_rdtsc() + pthread_self());
+		auto p1 = clock->peek((*gen)());
+		auto p2 = clock->peek((*gen)());
+		if (!p1 || !p2)
+			return p1 ? p1 : p2;
+#else
+		auto p1 = sample_page();
+		auto p2 = sample_page();
+#endif
+		return p1->getFrequency() < p2->getFrequency() ? p1 : p2;
+	}
+
+	// puts an entry that has been inserted into index_cache into the CLOCK ring
+	void track(ValueType* p) {
+		if (!clock)
+			return;
+		clock->add(p, thread_data[GET_THD_ID].clock_hint);
+		if (p->isObsolete(p->lock.load())) // invalidated before it was added
+			clock->remove(p);
 	}
 
-	bool invalidate(ValueType* v) {
+	// inc: the slot is kept for a later admission (false on eviction, where get_slot takes it)
+	bool invalidate(ValueType* v, bool inc=true) {
 		auto ret = index_cache->remove(v->getKey(), v);
 		if (!ret) // the item has been already removed by other threads
 			return false;
-		set_local_slot(v);
+		set_local_slot(v, inc);
 		return true;
 	}
 
@@ -145,37 +216,30 @@ private:
 		return false;
 	}
 
+	// retires an entry that has been unlinked from index_cache
 	void set_local_slot(ValueType* p, bool inc=true) {
-		free_slots();
 		p->setObsoleteState();
-		uint64_t cur_time = asm_rdtsc();
-		thread_data[GET_THD_ID].free_set.push_back(std::make_pair(p, cur_time));
+		if (clock)
+			clock->remove(p);
+		reclaim::retire(p, sizeof(ValueType), [](void* ptr, void* pool) {
+			static_cast<object_pool_t<ValueType>*>(pool)->free(GET_THD_ID, static_cast<ValueType*>(ptr));
+		}, pool);
 		if (inc) thread_data[GET_THD_ID].slots++;
 	}
 
-	void free_slots() {
-		auto& local_free_set = thread_data[GET_THD_ID].free_set;
-		if (local_free_set.size() == 0) return;
-
-		int cur_idx = 0;
-		uint64_t cur_time = asm_rdtsc();
-		for (; cur_idx<local_free_set.size(); cur_idx++) {
-			auto p = &local_free_set[cur_idx];
-			if (cur_time - p->second < 3000000ull)
-				break;
-			delete p->first;
-		}
-
-		if (cur_idx > 0)
-			local_free_set.erase(local_free_set.begin(), local_free_set.begin() + cur_idx);
-	}
-
-	void get_slot() {
+	// returns false if no slot is free and no entry could be evicted
+	bool get_slot() {
 		bool alloc = false;
 		do {
 			if (state.load() == 1) { // dynamic phase
-				if (!get_local_slot())
-					evict();
+				if (!get_local_slot()) {
+					uint64_t starttime = get_sys_clock();
+					bool evicted = evict();
+					INC_FLOAT_STATS(time_evict, get_sys_clock() - starttime);
+					if (!evicted)
+						return false;
+					INC_INT_STATS(num_cache_evictions, 1);
+				}
 				alloc = true;
 			}
 			else { // warmup phase
@@ -194,9 +258,25 @@ private:
 				}
 			}
 		} while (!alloc);
+		return true;
 	}
 
-	bool admit_to_cache() {
+	// records an access to the key for the admission filter
+	void record_access(Key k) {
+		if (sketch)
+			sketch->increment(k);
+	}
+
+	bool admit_to_cache(Key k) {
+#if CACHE_ADMISSION == ADMIT_TINYLFU
+		if (state.load() == 0) // the cache is still being filled
+			return true;
+		// the key replaces a victim (picked as in evict()) only if it is accessed more often
+		auto victim = peek_victim();
+		if (!victim)
+			return true;
+		return sketch->estimate(k) > sketch->estimate(victim->getKey());
+#else // ADMIT_RANDOM
 		static thread_local std::mt19937* gen = nullptr;
 		static thread_local std::uniform_int_distribution<uint64_t>* dist = nullptr;
 		if (!gen && !dist) {
@@ -204,7 +284,16 @@ private:
 			dist = new std::uniform_int_distribution<uint64_t>(0, 100);
 		}
 		uint64_t prob = (*dist)(*gen);
-		return prob < admission_rate;
+		return prob < admission_rate.load(std::memory_order_relaxed);
+#endif
+	}
+
+	// with EVICT_CLOCK every hit gives the entry a second chance, not only the ones that update the frequency
+	void reference(ValueType* p, bool update_freq) {
+#if CACHE_EVICTION == EVICT_CLOCK
+		if (!update_freq)
+			p->reference();
+#endif
 	}
 
 	bool update_frequency() {
@@ -219,7 +308,10 @@ private:
 	}
 
 	BTree<ValueType*>* index_cache;
-	uint64_t admission_rate;
+	frequency_sketch_t* sketch; // access frequencies for ADMIT_TINYLFU
+	clock_ring_t<ValueType>* clock; // cached entries for EVICT_CLOCK
+	object_pool_t<ValueType>* pool; // memory of the entries
+	std::atomic<uint64_t> admission_rate; // in percent, tuned at run time with ADAPTIVE_CACHE
 	uint32_t _index_id;
 	uint64_t page_num;
 	std::atomic<uint64_t> page_offset;
@@ -97,13 +97,14 @@ template <typename Payload>
 struct CacheEntry: public EntryLock {
 	bool dirty;
 	std::atomic<uint16_t> frequency;
+	std::atomic<uint32_t> clock_slot; // slot in the CLOCK ring of the cache (EVICT_CLOCK)
 	uint64_t key;
 	Payload data;
 
-	CacheEntry(): EntryLock(), dirty(false){ lock.store(0); frequency.store(0); }
-	CacheEntry(uint64_t k): dirty(false), key(k) { lock.store(0b100); frequency.store(0); }
-	CacheEntry(uint64_t k, Payload p): dirty(false), key(k), data(p) { lock.store(0); frequency.store(0); }
-	CacheEntry(uint64_t k, Payload p, bool dirty): dirty(dirty), key(k), data(p) { lock.store(0); frequency.store(0); }
+	CacheEntry(): EntryLock(), dirty(false){ lock.store(0); frequency.store(0); clock_slot.store(UINT32_MAX); }
+	CacheEntry(uint64_t k): dirty(false), key(k) { lock.store(0b100); frequency.store(0); clock_slot.store(UINT32_MAX); }
+	CacheEntry(uint64_t k, Payload p): dirty(false), key(k), data(p) { lock.store(0); frequency.store(0); clock_slot.store(UINT32_MAX); }
+	CacheEntry(uint64_t k, Payload p, bool dirty): dirty(dirty), key(k), data(p) { lock.store(0); frequency.store(0); clock_slot.store(UINT32_MAX); }
 	
 	bool isDirty() { return dirty; }
 	void setDirty() { dirty = true; }
@@ -111,6 +112,21 @@ struct CacheEntry: public EntryLock {
 	void reset() { dirty = false; frequency.store(0); resetLock(); }
 	uint8_t getFrequency() { return frequency.load(); }
 	void incrementFrequency() { frequency.fetch_add(1); }
+	// a hot entry (NUM_HOT_KEYS) survives as many CLOCK sweeps as its frequency has bits
+	void setHot() { frequency.store(UINT8_MAX); }
+	// marks a hit for the CLOCK hand without a read-modify-write
+	void reference() {
+		if (frequency.load(std::memory_order_relaxed) == 0)
+			frequency.store(1, std::memory_order_relaxed);
+	}
+	// halves the frequency when the CLOCK hand passes; false if it has already aged to zero
+	bool ageFrequency() {
+		auto freq = frequency.load();
+		if (freq == 0)
+			return false;
+		frequency.compare_exchange_strong(freq, freq >> 1);
+		return true;
+	}
 
 	bool validateKey(uint64_t k) { return (key == k); }
 	uint64_t getKey() { return key; }
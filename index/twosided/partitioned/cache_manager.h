@@ -3,6 +3,11 @@
 #include "system/global.h"
 #include "utils/helper.h"
 #include "utils/packetize.h"
+#include "utils/frequency_sketch.h"
+#include "utils/clock_ring.h"
+#include "utils/reclaim.h"
+#include "utils/object_pool.h"
+#include "utils/hot_keys.h"
 #include "index/idx_wrapper.h"
 #include "index/twosided/btreeolc/node.h"
 #include "index/twosided/btreeolc/tree.h"
@@ -20,9 +25,9 @@ class cache_manager_t: public idx_wrapper_t<Value>{
 public:
 	using ValueType = CacheEntry<Value>;
 
-	struct ThreadStruct {
+	struct alignas(64) ThreadStruct { // padded, as each client thread updates its own
 		uint32_t slots;
-		std::vector<std::pair<ValueType*, uint64_t>> free_set;
+		uint64_t clock_hint; // ring slot of the last victim, reused for the next entry
 	};
 
 	cache_manager_t(uint32_t index_id, uint64_t index_cache_size): index_id(index_id) {
@@ -32,9 +37,24 @@ public:
 		thread_data.resize(g_num_client_threads);
 		page_offset.store(0);
 		page_num = (index_cache_size * 1024 * 1024) / sizeof(ValueType);
-		if (page_num > 0)
+		sketch = nullptr;
+		clock = nullptr;
+		pool = nullptr;
+		hot_keys = nullptr;
+		if (page_num > 0) {
 			index_cache = new BTree<ValueType*>();
-		admission_rate = static_cast<uint64_t>(g_admission_rate * 100);
+#if CACHE_ADMISSION == ADMIT_TINYLFU
+			sketch = new frequency_sketch_t(page_num);
+#endif
+#if CACHE_EVICTION == EVICT_CLOCK
+			clock = new clock_ring_t<ValueType>(page_num);
+#endif
+			// retired entries wait for reclamation on top of the cached ones
+			pool = new object_pool_t<ValueType>(page_num + page_num / 4, g_num_client_threads);
+			if (NUM_HOT_KEYS > 0)
+				hot_keys = new hot_key_set_t(NUM_HOT_KEYS);
+		}
+		admission_rate.store(static_cast<uint64_t>(g_admission_rate * 100));
 	}
 
 	// index operations (dummy)
@@ -50,14 +70,20 @@ public:
 	void set_shared(std::vector<Key>& bound) { }
 	void bulk_load(Key* key, uint64_t num) { assert(false); }
 	void set_rpc_ratio(double ratio) { }
+	// only random admission has a rate; TinyLFU decides by frequency
+	void set_admission_ratio(double ratio) { if (CACHE_ADMISSION == ADMIT_RANDOM) admission_rate.store(static_cast<uint64_t>(ratio * 100)); }
+	double get_admission_ratio() { return CACHE_ADMISSION == ADMIT_RANDOM ? admission_rate.load() / 100.0 : -1; }
 	void get_newest_root() { }
 	void reset_buffer_pool(bool flush_dirty) { }
+	void set_hot(Key k) { if (hot_keys) hot_keys->insert(k); }
 
 	int insert(Key k, Value v, UnstructuredBuffer& evict){
 		// if no cache or is building the cache just rpc
 		if (!index_cache || !g_warmup_done)
 			return 0;
 
+		reclaim::guard_t guard;
+		record_access(k);
 		bool update_freq = update_frequency();
 	restart:
 		bool needRestart = false;
@@ -74,16 +100,20 @@ public:
 
 			ptr->update(v, update_freq);
 			ptr->writeUnlock();
+			reference(ptr, update_freq);
 			return 1; // cache hit
 		}
 
-		bool write_back = get_slot(evict);
-		auto slot = new ValueType(k, v, true);
+		bool write_back = false;
+		if (!get_slot(evict, write_back))
+			return 0; // nothing could be evicted, no admission (just rpc)
+		auto slot = pool->alloc(GET_THD_ID, k, v, true);
 		bool ret = index_cache->insert(k, slot);
 		if (!ret) { // insert failed, another thread inserted the same key
 			set_local_slot(slot);
 			goto restart;
 		}
+		track(slot);
 		return write_back ? 2 : 3;
 	}
 
@@ -91,6 +121,8 @@ public:
 		if (!index_cache) 
 			return 0;
 
+		reclaim::guard_t guard;
+		record_access(k);
 		bool update_freq = update_frequency();
 	restart:
 		bool needRestart = false;
@@ -107,21 +139,26 @@ public:
 
 			ptr->update(v, update_freq);
 			ptr->writeUnlock();
+			reference(ptr, update_freq);
 			return 1; // cache hit
 		}
 		// cache miss
-		bool admit = admit_to_cache();
+		bool admit = admit_to_cache(k);
 		if (!admit)
 			return 0; // no admission, just rpc
 
-		bool write_back = get_slot(buffer);
-		return write_back ? 2 : 3; 
+		bool write_back = false;
+		if (!get_slot(buffer, write_back))
+			return 0; // nothing could be evicted, no admission (just rpc)
+		return write_back ? 2 : 3;
 	}
 
 	int lookup(Key k, Value& v, UnstructuredBuffer& buffer){
 		if (!index_cache)
 			return 0;
 
+		reclaim::guard_t guard;
+		record_access(k);
 		bool update_freq = update_frequency();
 	restart:
 		bool needRestart = false;
@@ -142,14 +179,17 @@ public:
 			}
 
 			v = value;
+			reference(ptr, update_freq);
 			return 1; // cache hit
 		}
 		// cache miss
-		bool admit = admit_to_cache();
+		bool admit = admit_to_cache(k);
 		if (!admit)
 			return 0; // cache miss, but no cache admission (just rpc)
 
-		bool write_back = get_slot(buffer);
+		bool write_back = false;
+		if (!get_slot(buffer, write_back))
+			return 0; // nothing could be evicted, no admission (just rpc)
 		return write_back ? 2 : 3;
 	}
 		
@@ -157,6 +197,7 @@ public:
 		if (!index_cache)
 			return 0;
 
+		reclaim::guard_t guard;
 	restart:
 		bool needRestart = false;
 		ValueType* ptr = nullptr;
@@ -180,26 +221,34 @@ public:
 	}
 
 	void add_to_cache(Key k, Value v){
+		reclaim::guard_t guard;
 		ValueType* temp = nullptr;
-		auto slot = new ValueType(k, v);
+		auto slot = pool->alloc(GET_THD_ID, k, v);
+		if (hot_keys && hot_keys->contains(k))
+			slot->setHot();
 		bool ret = index_cache->upsert(k, slot, temp);
-		if (ret) // replaced an existing item
+		if (ret) // replaced an existing item, whose slot is free again
 			// delete temp;
-			set_local_slot(temp, false);
+			set_local_slot(temp);
+		track(slot);
 	}
 	
+	// v is the dirty entry evict() handed out; it may have been replaced (and retired) since,
+	// so it is only dereferenced once it has been found in index_cache
 	void invalidate(Key k, char* v){
 		assert(index_cache);
-		invalidate(reinterpret_cast<ValueType*>(v));
+		reclaim::guard_t guard;
+		invalidate(k, reinterpret_cast<ValueType*>(v));
 	}
 
 private:
-	bool evict(UnstructuredBuffer& evict_buffer) {
+	// returns false if there was nothing to evict; a dirty victim is put into evict_buffer for writeback
+	bool evict(UnstructuredBuffer& evict_buffer, bool& write_back) {
 	restart:
 	    bool needRestart = false;
-		auto p1 = sample_page();
-		auto p2 = sample_page();
-		auto p = p1->getFrequency() < p2->getFrequency() ? p1 : p2;
+		auto p = get_victim();
+		if (!p) // nothing to evict
+			return false;
 		auto version = p->readLockOrRestart(needRestart);
 		if (needRestart) goto restart;
 
@@ -217,16 +266,58 @@ private:
 			evict_buffer.put(&key);
 			evict_buffer.put(&value);
 			evict_buffer.put(&p);
-			return false;
+			write_back = true;
+			return true;
 		}
 		else {
-			bool ret = invalidate(p);
+			bool ret = invalidate(key, p);
 			assert(ret);
 		}
 
 		return true;		
 	}
 
+	// the entry to evict (nullptr if the cache is empty, EVICT_CLOCK only)
+	ValueType* get_victim() {
+#if CACHE_EVICTION == EVICT_CLOCK
+		auto p = clock->next_victim();
+		if (p)
+			thread_data[GET_THD_ID].clock_hint = p->clock_slot.load();
+		return p;
+#else
+		auto p1 = sample_page();
+		auto p2 = sample_page();
+		return p1->getFrequency() < p2->getFrequency() ? p1 : p2;
+#endif
+	}
+
+	// a candidate victim for admission, without aging any entry (nullptr if there is none)
+	// with EVICT_CLOCK, the less frequently used of two random entries of the ring
+	// (the entry under the hand only changes on eviction, so it would reject every key that loses to it once)
+	ValueType* peek_victim() {
+#if CACHE_EVICTION == EVICT_CLOCK
+		static thread_local std::mt19937_64* gen = nullptr;
+		if (!gen) gen = new std::mt19937_64(asm_rdtsc() + pthread_self());
+		auto p1 = clock->peek((*gen)());
+		auto p2 = clock->peek((*gen)());
+		if (!p1 || !p2)
+			return p1 ? p1 : p2;
+#else
+		auto p1 = sample_page();
+		auto p2 = sample_page();
+#endif
+		return p1->getFrequency() < p2->getFrequency() ? p1 : p2;
+	}
+
+	// puts an entry that has been inserted into index_cache into the CLOCK ring
+	void track(ValueType* p) {
+		if (!clock)
+			return;
+		clock->add(p, thread_data[GET_THD_ID].clock_hint);
+		if (p->isObsoleteState()) // invalidated before it was added
+			clock->remove(p);
+	}
+
 	ValueType* sample_page(){
 	    static thread_local std::mt19937* gen = nullptr;
 	    static thread_local std::uniform_int_distribution<Key> dist(from, to);
@@ -249,47 +340,38 @@ private:
 		return false;
 	}
 
-	bool invalidate(ValueType* v) {
-		auto ret = index_cache->remove(v->getKey(), v);
+	bool invalidate(Key k, ValueType* v) {
+		auto ret = index_cache->remove(k, v);
 		if (!ret) // the item has been already removed by other threads
 			return false;
-		set_local_slot(v);
+		set_local_slot(v, false); // entries are only invalidated on eviction, whose slot get_slot has handed out
 		return true;
 	}
 
+	// retires an entry that has been unlinked from index_cache (or has never been linked)
 	void set_local_slot(ValueType* p, bool inc=true) {
-		free_slots();
 		p->setObsoleteState();
-		uint64_t cur_time = asm_rdtsc();
-		thread_data[GET_THD_ID].free_set.push_back(std::make_pair(p, cur_time));
+		if (clock)
+			clock->remove(p);
+		reclaim::retire(p, sizeof(ValueType), [](void* ptr, void* pool) {
+			static_cast<object_pool_t<ValueType>*>(pool)->free(GET_THD_ID, static_cast<ValueType*>(ptr));
+		}, pool);
 		if (inc) thread_data[GET_THD_ID].slots++;
 	}
 
-	void free_slots() {
-		auto& local_free_set = thread_data[GET_THD_ID].free_set;
-		if (local_free_set.size() == 0) return;
-
-		int cur_idx = 0;
-		uint64_t cur_time = asm_rdtsc();
-		for (; cur_idx<local_free_set.size(); cur_idx++) {
-			auto p = &local_free_set[cur_idx];
-			if (cur_time - p->second < 3000000ull)
-				break;
-			delete p->first;
-		}
-
-		if (cur_idx > 0)
-			local_free_set.erase(local_free_set.begin(), local_free_set.begin() + cur_idx);
-	}
-
-	bool get_slot(UnstructuredBuffer& buffer){
-		bool write_back = false;
+	// returns false if no slot is free and no entry could be evicted;
+	// write_back is set if the evicted entry is dirty and needs a writeback
+	bool get_slot(UnstructuredBuffer& buffer, bool& write_back){
 		bool alloc = false;
 		do {
 			if (state.load() == 1) { // dynamic phase
 				if (!get_local_slot()) {
-					if (!evict(buffer))
-						write_back = true; // evicting a dirty entry, need writeback
+					uint64_t starttime = get_sys_clock();
+					bool evicted = evict(buffer, write_back);
+					INC_FLOAT_STATS(time_evict, get_sys_clock() - starttime);
+					if (!evicted)
+						return false;
+					INC_INT_STATS(num_cache_evictions, 1);
 				}
 				alloc = true;
 			}
@@ -309,10 +391,29 @@ private:
 				}
 			}
 		} while (!alloc);
-	    return write_back;
+		return true;
 	}
 
-	bool admit_to_cache() { 
+	// records an access to the key for the admission filter
+	void record_access(Key k) {
+		if (sketch)
+			sketch->increment(k);
+	}
+
+	bool admit_to_cache(Key k) {
+		if (hot_keys && hot_keys->contains(k)) { // replica of a hot key of the memory server
+			INC_INT_STATS(num_hot_admissions, 1);
+			return true;
+		}
+#if CACHE_ADMISSION == ADMIT_TINYLFU
+		if (state.load() == 0) // the cache is still being filled
+			return true;
+		// the key replaces a victim (picked as in evict()) only if it is accessed more often
+		auto victim = peek_victim();
+		if (!victim)
+			return true;
+		return sketch->estimate(k) > sketch->estimate(victim->getKey());
+#else // ADMIT_RANDOM
 		static thread_local std::mt19937* gen = nullptr;
 		static thread_local std::uniform_int_distribution<uint64_t>* dist = nullptr;
 		if (!gen && !dist) {
@@ -320,7 +421,16 @@ private:
 			dist = new std::uniform_int_distribution<uint64_t>(0, 100);
 		}
 		uint64_t prob = (*dist)(*gen);
-		return prob < admission_rate;
+		return prob < admission_rate.load(std::memory_order_relaxed);
+#endif
+	}
+
+	// with EVICT_CLOCK every hit gives the entry a second chance, not only the ones that update the frequency
+	void reference(ValueType* p, bool update_freq) {
+#if CACHE_EVICTION == EVICT_CLOCK
+		if (!update_freq)
+			p->reference();
+#endif
 	}
 
 	bool update_frequency() {
@@ -335,7 +445,11 @@ private:
 	}
 
 	BTree<ValueType*>* index_cache;
-	uint64_t admission_rate;
+	frequency_sketch_t* sketch; // access frequencies for ADMIT_TINYLFU
+	clock_ring_t<ValueType>* clock; // cached entries for EVICT_CLOCK
+	object_pool_t<ValueType>* pool; // memory of the entries
+	hot_key_set_t* hot_keys; // keys the memory server has reported as hot
+	std::atomic<uint64_t> admission_rate; // in percent, tuned at run time with ADAPTIVE_CACHE
 	uint32_t index_id; 
 	uint64_t page_num;
 	std::atomic<uint64_t> page_offset;
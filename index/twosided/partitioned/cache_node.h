@@ -10,6 +10,7 @@
 #include <utility>
 #include <functional>
 #include "system/global.h"
+#include "utils/search.h"
 
 #if PARTITIONED
 namespace partitioned{
@@ -229,6 +230,8 @@ struct BTreeLeaf: public BTreeLeafBase{
     unsigned lowerBound(Key k){
 		#ifdef BINARY_SEARCH
 		return binarySearch(k);
+		#elif SIMD_SEARCH
+		return search::lower_bound(data, count, k);
 		#else
 		return linearSearch(k);
 		#endif
@@ -239,6 +242,8 @@ struct BTreeLeaf: public BTreeLeafBase{
 			return false;
 		#ifdef BINARY_SEARCH
 		unsigned idx = binarySearch(k);
+		#elif SIMD_SEARCH
+		unsigned idx = search::lower_bound(data, count, k);
 		#else
 		unsigned idx = linearSearch(k);
 		#endif
@@ -399,6 +404,8 @@ struct BTreeInner: public BTreeInnerBase{
     unsigned lowerBound(Key k){
 		#ifdef BINARY_SEARCH
 		return binarySearch(k);
+		#elif SIMD_SEARCH
+		return search::lower_bound(data, count, k);
 		#else
 		return linearSearch(k);
 		#endif
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "system/global.h"
+#include "utils/helper.h"
 #include "index/idx_wrapper.h"
+#include "utils/hot_keys.h"
 #include "index/twosided/btreeolc/node.h"
 #include "index/twosided/btreeolc/tree.h"
 
@@ -11,7 +13,10 @@ namespace partitioned{
 template <typename Value>
 class idx_t: public idx_wrapper_t<Value>{
 public:
-	idx_t(uint32_t index_id): _index_id(index_id) { index = new BTree<Value>(); }
+	idx_t(uint32_t index_id): _index_id(index_id) {
+		index = new BTree<Value>();
+		hot_keys = NUM_HOT_KEYS > 0 ? new hot_key_detector_t(NUM_HOT_KEYS, g_total_num_threads) : nullptr;
+	}
 
 	// index operations
 	void insert(Key k, Value v){ index->insert(k, v); }
@@ -26,6 +31,9 @@ public:
 	    }
 	}
 
+	// hot-key replication
+	bool access_hot(Key k) { return hot_keys && hot_keys->access(k, GET_THD_ID); }
+
 	// DEX functions (dummy)
 	void set_bound(Key left, Key right) { }
 	void set_shared(std::vector<Key>& bound) { }
@@ -43,6 +51,7 @@ public:
 
 private:
 	BTree<Value>* index;
+	hot_key_detector_t* hot_keys; // keys this server serves most often
 	uint32_t _index_id;
 };
 
@@ -21,6 +21,35 @@
 server_txn_manager_t::server_txn_manager_t(thread_t* thread)
 	: txn_manager_t(thread) { }
 
+server_txn_manager_t::~server_txn_manager_t() {
+	for (auto txn : _stored_procedure_pool)
+		delete txn;
+	for (auto txn : _interactive_pool)
+		delete txn;
+}
+
+txn_t* server_txn_manager_t::alloc_txn(message_t* msg, txn_id_t txn_id) {
+	bool stored_procedure = (msg->get_type() == message_t::type_t::REQUEST_STORED_PROCEDURE);
+	auto& pool = stored_procedure ? _stored_procedure_pool : _interactive_pool;
+	if (pool.empty()) {
+		if (stored_procedure)
+			return GET_WORKLOAD->create_stored_procedure(txn_id);
+		return GET_WORKLOAD->create_interactive(txn_id);
+	}
+	auto txn = pool.back();
+	pool.pop_back();
+	txn->reset(txn_id);
+	return txn;
+}
+
+void server_txn_manager_t::free_txn(txn_t* txn) {
+	auto& pool = dynamic_cast<stored_procedure_t*>(txn) ? _stored_procedure_pool : _interactive_pool;
+	if (pool.size() < MAX_NUM_ACTIVE_TXNS)
+		pool.push_back(txn);
+	else
+		delete txn;
+}
+
 RC server_txn_manager_t::process_msg(message_t* msg) {
 	if (msg->is_system_txn()) // system txn for one-sided RDMA operations
 		return process_system_txn(msg);
@@ -243,7 +272,7 @@ void server_txn_manager_t::check_wait_buffer() {
 				it = _wait_buffer.erase(it);
 			else if(rc == ABORT) {
 				it = _wait_buffer.erase(it);
-				delete txn;
+				free_txn(txn);
 				INC_INT_STATS(num_aborts, 1);
 			}
 			else {
@@ -256,7 +285,7 @@ void server_txn_manager_t::check_wait_buffer() {
 			// txn has been wounded by another txn 
 			it = _wait_buffer.erase(it);
 			process_abort(txn);
-			delete txn;
+			free_txn(txn);
 			INC_INT_STATS(num_aborts, 1);
 		}
 		else {
@@ -275,7 +304,7 @@ void server_txn_manager_t::remove_wait_buffer(txn_t* txn) {
 		auto it = std::find(_wait_buffer.begin(), _wait_buffer.end(), txn);
 		if (it != _wait_buffer.end()) {
 			_wait_buffer.erase(it);
-			delete txn; // native txn for this thread
+			free_txn(txn); // native txn for this thread
 		}
 	}
 }
@@ -350,9 +379,8 @@ RC server_txn_manager_t::process_batch_msg(message_t* recv_msg, uint32_t node_id
 		if (cur_recv_msg->is_regular_txn()) { // client access requests
 			txn = txn_table->find(txn_id);
 			if (cur_recv_msg_type == message_t::type_t::REQUEST_STORED_PROCEDURE) {
-				assert(txn == nullptr);
-				if (!txn) {
-					txn = GET_WORKLOAD->create_stored_procedure(txn_id);
+				if (!txn) { // found if a range scan continues on a node the txn has visited
+					txn = alloc_txn(cur_recv_msg, txn_id);
 					txn_table->insert(txn_id, txn);
 				}
 				// printf("    TXN %lu begins batch (ts %lu)\n", txn->get_id().to_uint64(), txn->get_ts());
@@ -360,7 +388,7 @@ RC server_txn_manager_t::process_batch_msg(message_t* recv_msg, uint32_t node_id
 			}
 			else if (cur_recv_msg_type == message_t::type_t::REQUEST_INTERACTIVE) {
 				if (!txn) {
-					txn = GET_WORKLOAD->create_interactive(txn_id);
+					txn = alloc_txn(cur_recv_msg, txn_id);
 					txn_table->insert(txn_id, txn);
 				}
 				// printf("    TXN %lu begins batch (ts %lu)\n", txn->get_id().to_uint64(), txn->get_ts());
@@ -374,7 +402,7 @@ RC server_txn_manager_t::process_batch_msg(message_t* recv_msg, uint32_t node_id
 			assert(rc == RCOK);
 			assert(cur_send_size > 0);
 			txn_table->remove(txn_id);
-			delete txn;
+			free_txn(txn);
 			cur_send_msg->set_data_size(cur_send_size);
 #else
 			if (rc == ABORT) {
@@ -382,7 +410,7 @@ RC server_txn_manager_t::process_batch_msg(message_t* recv_msg, uint32_t node_id
 				txn_table->remove(txn_id);
 				// printf("    TXN %lu aborts1 batch (ts %lu)\n", txn->get_id().to_uint64(), txn->get_ts());
 				// fflush(stdout);
-				delete txn;
+				free_txn(txn);
 				INC_INT_STATS(num_aborts, 1);
 			}
 			else if (rc == WAIT) {
@@ -396,6 +424,8 @@ RC server_txn_manager_t::process_batch_msg(message_t* recv_msg, uint32_t node_id
 				assert(rc == RCOK);
 				assert(cur_send_size > 0);
 				cur_send_msg->set_data_size(cur_send_size);
+				if (txn->is_snapshot()) // read-only txn holds no locks, finish it right away
+					finish_snapshot(txn);
 			}
 #endif
 		}
@@ -409,12 +439,19 @@ RC server_txn_manager_t::process_batch_msg(message_t* recv_msg, uint32_t node_id
 				// printf("    TXN %lu aborts2 batch (ts %lu)\n", txn->get_id().to_uint64(), txn->get_ts());
 				// fflush(stdout);
 					txn_table->remove(txn_id);
-					delete txn;
+					free_txn(txn);
 					INC_INT_STATS(num_aborts, 1);
 					cur_send_msg->set_type(message_t::type_t::RESPONSE_ABORT);
 				}
-				else
+				else {
 					cur_send_msg->set_type(message_t::type_t::RESPONSE_PREPARE);
+#if SNAPSHOT_READ
+					uint64_t bound = txn->get_commit_ts();
+					memcpy(cur_send_data, &bound, sizeof(bound));
+					cur_send_size = sizeof(bound);
+					cur_send_msg->set_data_size(cur_send_size);
+#endif
+				}
 			}
 			else if (cur_recv_msg_type == message_t::type_t::REQUEST_ABORT) {
 				if (txn) {
@@ -439,7 +476,7 @@ RC server_txn_manager_t::process_batch_msg(message_t* recv_msg, uint32_t node_id
 					INC_INT_STATS(num_aborts, 1);
 				}
 				txn_table->remove(txn_id);
-				delete txn;
+				free_txn(txn);
 			}
 			else {
 				debug::notify_error("Unknown message type %d: %s", cur_recv_msg_type, cur_recv_msg->get_name().c_str());
@@ -482,9 +519,8 @@ RC server_txn_manager_t::process_txn(message_t* recv_msg) {
 	if (recv_msg->is_regular_txn()) {  // client access requests
 		txn = txn_table->find(txn_id);
 		if (msg_type == message_t::type_t::REQUEST_STORED_PROCEDURE) {
-			assert(txn == nullptr);
-			if (!txn) {
-				txn = GET_WORKLOAD->create_stored_procedure(txn_id);
+			if (!txn) { // found if a range scan continues on a node the txn has visited
+				txn = alloc_txn(recv_msg, txn_id);
 				txn_table->insert(txn_id, txn);
 				// printf("    TXN %lu begins\n", txn->get_id().to_uint64());
 				// fflush(stdout);
@@ -492,7 +528,7 @@ RC server_txn_manager_t::process_txn(message_t* recv_msg) {
 		}
 		else if (msg_type == message_t::type_t::REQUEST_INTERACTIVE) {
 			if (!txn) {
-				txn = GET_WORKLOAD->create_interactive(txn_id);
+				txn = alloc_txn(recv_msg, txn_id);
 				txn_table->insert(txn_id, txn);
 				// printf("    TXN %lu begins\n", txn->get_id().to_uint64());
 				// fflush(stdout);
@@ -507,7 +543,7 @@ RC server_txn_manager_t::process_txn(message_t* recv_msg) {
 		assert(rc == RCOK);
 		assert(resp_size > 0);
 		txn_table->remove(txn_id);
-		delete txn;
+		free_txn(txn);
 		send_msg->set_data_size(resp_size);
 #else
 		if (rc == ABORT) {
@@ -515,7 +551,7 @@ RC server_txn_manager_t::process_txn(message_t* recv_msg) {
 			txn_table->remove(txn_id);
 			// printf("    TXN %lu aborts1 (ts %lu)\n", txn->get_id().to_uint64(), txn->get_ts());
 			// fflush(stdout);
-			delete txn;
+			free_txn(txn);
 			INC_INT_STATS(num_aborts, 1);
 		}
 		else if (rc == WAIT) {
@@ -530,6 +566,8 @@ RC server_txn_manager_t::process_txn(message_t* recv_msg) {
 			assert(rc == RCOK);
 			assert(resp_size > 0);
 			send_msg->set_data_size(resp_size);
+			if (txn->is_snapshot()) // read-only txn holds no locks, finish it right away
+				finish_snapshot(txn);
 		}
 #endif
 	}
@@ -544,12 +582,19 @@ RC server_txn_manager_t::process_txn(message_t* recv_msg) {
 				// printf("    TXN %lu aborts2 (ts %lu)\n", txn->get_id().to_uint64(), txn->get_ts());
 				// fflush(stdout);
 				txn_table->remove(txn_id);
-				delete txn;
+				free_txn(txn);
 				INC_INT_STATS(num_aborts, 1);
 				response_type = message_t::type_t::RESPONSE_ABORT;
 			}
-			else 
+			else {
 				response_type = message_t::type_t::RESPONSE_PREPARE;
+#if SNAPSHOT_READ
+				uint64_t bound = txn->get_commit_ts(); // lower bound of the commit timestamp
+				memcpy(resp_data, &bound, sizeof(bound));
+				resp_size = sizeof(bound);
+				send_msg->set_data_size(resp_size);
+#endif
+			}
 			// txn will be removed after commit/abort (2PC)
 		}
 		else if (msg_type == message_t::type_t::REQUEST_ABORT) {
@@ -577,7 +622,7 @@ RC server_txn_manager_t::process_txn(message_t* recv_msg) {
 			}
 			// fflush(stdout);
 			txn_table->remove(txn_id);
-			delete txn;
+			free_txn(txn);
 		}
 		else {
 			debug::notify_error("Unknown message type %d: %s", msg_type, recv_msg->get_name().c_str()); 
@@ -600,6 +645,14 @@ RC server_txn_manager_t::process_txn(message_t* recv_msg) {
 	return rc;
 }
 
+void server_txn_manager_t::finish_snapshot(txn_t* txn) {
+	RC rc = txn->process_commit(nullptr, 0);
+	assert(rc == COMMIT);
+	txn_table->remove(txn->get_id());
+	free_txn(txn);
+	INC_INT_STATS(num_commits, 1);
+}
+
 void server_txn_manager_t::process_abort(txn_t* txn) {
 	assert(txn != nullptr);
 	txn->process_abort();
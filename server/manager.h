@@ -2,6 +2,7 @@
 
 #include "system/global.h"
 #include "txn/manager.h"
+#include "txn/id.h"
 #include <vector>
 
 class thread_t;
@@ -12,7 +13,7 @@ class txn_t;
 class server_txn_manager_t: public txn_manager_t {
 public:
 	server_txn_manager_t(thread_t* thread);
-	~server_txn_manager_t() = default;
+	~server_txn_manager_t();
 
 	RC   execute() { assert(false); return ERROR; }
 	RC   process_msg(message_t* msg);
@@ -25,6 +26,7 @@ private:
 	RC   continue_execute(txn_t* txn);
 	RC   process_txn(message_t* msg);
 	void process_abort(txn_t* txn);
+	void finish_snapshot(txn_t* txn); // commits a read-only txn after its reads (SNAPSHOT_READ)
 
 	RC   rpc_alloc(message_t* msg);
 	RC   idx_update_root(message_t* msg);
@@ -36,5 +38,12 @@ private:
 
 	void remove_wait_buffer(txn_t* txn);
 
+	// txns are reused through per-thread pools instead of being allocated for every request
+	// (a txn may be freed by another server thread than the one that allocated it; it then joins that pool)
+	txn_t* alloc_txn(message_t* msg, txn_id_t txn_id);
+	void   free_txn(txn_t* txn);
+
 	std::vector<txn_t*> _wait_buffer; // txns waiting for the lock
+	std::vector<txn_t*> _stored_procedure_pool;
+	std::vector<txn_t*> _interactive_pool;
 };
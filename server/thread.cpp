@@ -4,6 +4,7 @@
 #include "transport/message.h"
 #include "system/manager.h"
 #include "utils/helper.h"
+#include "utils/numa.h"
 #include "batch/table.h"
 #include "txn/txn.h"
 
@@ -12,7 +13,11 @@ server_thread_t::server_thread_t(uint32_t tid)
 
 RC server_thread_t::run() {
 	// this assumes running clients and servers in the same machine
+#if NUMA_AWARE
+	numa::bind_thread(get_tid(), g_num_server_threads); // spread over the sockets like the partition
+#else
 	bind_core(g_num_client_threads + get_tid()); // bind to the core after client threads
+#endif
 	// bind_core(g_num_client_threads + g_num_batch_threads + get_tid()); // bind to the core after client threads
 	global_manager->init_rand(get_tid());
 	global_manager->set_tid(get_tid());
@@ -24,7 +29,7 @@ RC server_thread_t::run() {
 	uint32_t node_id, qp_id;
 
 	auto txn_man = new server_txn_manager_t(this); // execute system txns (e.g., micro-operations)
-	auto transport = static_cast<server_transport_t*>(GET_TRANSPORT); 
+	auto transport = GET_TRANSPORT;
 	assert(transport != nullptr);
 	
 	// int batch_msg_size = 4;
@@ -33,7 +38,7 @@ RC server_thread_t::run() {
 	// int batch_msg_size = g_num_client_threads / g_num_server_threads;
 	int batch_msg_size = g_num_client_threads / (batch_table_t::MAX_GROUP_SIZE) / g_num_server_threads;
 	#else
-	int batch_msg_size = g_num_client_threads / g_num_server_threads;
+	int batch_msg_size = g_num_client_qps / g_num_server_threads;
 	#endif
 	if (batch_msg_size == 0) batch_msg_size = 1;
     struct ibv_wc wc[batch_msg_size];
@@ -63,10 +68,10 @@ RC server_thread_t::run() {
 				assert(wc[i].opcode == IBV_WC_RECV);
 				uint64_t wr_id = wc[i].wr_id;
 				transport->deserialize_node_info(wr_id, node_id, qp_id);
-				if (qp_id >= g_num_client_threads) { // this is a batch_request
-					assert(qp_id < g_num_client_threads + g_num_batch_threads);
+				if (qp_id >= g_num_client_qps) { // this is a batch_request
+					assert(qp_id < g_num_client_qps + g_num_batch_threads);
 					// printf("[node %u, tid %u] received batch message from node %u, qp_id %u\n", g_node_id, GET_THD_ID, node_id, qp_id);
-					qp_id -= g_num_client_threads; // adjust qp_id
+					qp_id -= g_num_client_qps; // adjust qp_id
 					char* recv_buffer = transport->get_recv_batch_buffer(node_id, qp_id);
 					auto batch_msg = reinterpret_cast<message_t*>(recv_buffer);
 					assert(batch_msg->get_node_id() == node_id);
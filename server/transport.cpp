@@ -8,12 +8,12 @@
 
 server_transport_t::server_transport_t()
     : transport_t() {
-    if(!init()) exit(0);
-	if(!connect()) exit(0);
+    if(!init()) exit(EXIT_FAILURE);
+	if(!connect()) exit(EXIT_FAILURE);
 
 	// all the setup is complete, prepost RECVs for all client nodes
 	for(uint32_t i=0; i<g_num_client_nodes; i++) {
-		for (uint32_t j=0; j<g_num_client_threads; j++) {
+		for (uint32_t j=0; j<g_num_client_qps; j++) {
 			auto recv_ptr = get_recv_buffer(i, j);
 			post_recv(recv_ptr, i, j, MAX_MESSAGE_SIZE);
 		}
@@ -37,8 +37,8 @@ bool server_transport_t::init() {
 		return cleanup();
 
     // create send CQs for client connection
-	_send_cqs = new ibv_cq*[g_num_client_threads];
-	for (uint32_t i=0; i<g_num_client_threads; i++) {
+	_send_cqs = new ibv_cq*[g_num_client_qps];
+	for (uint32_t i=0; i<g_num_client_qps; i++) {
 		_send_cqs[i] = create_cq(_context.ctx);
 		if (!_send_cqs[i])
 			return cleanup();
@@ -59,8 +59,8 @@ bool server_transport_t::init() {
     // create QPs for each client connection
 	_qps = new ibv_qp**[g_num_client_nodes];
 	for (uint32_t i=0; i<g_num_client_nodes; i++) {
-		_qps[i] = new ibv_qp*[g_num_client_threads];
-		for (uint32_t j=0; j<g_num_client_threads; j++) {
+		_qps[i] = new ibv_qp*[g_num_client_qps];
+		for (uint32_t j=0; j<g_num_client_qps; j++) {
 			_qps[i][j] = create_qp(_context.pd, _send_cqs[j], _recv_cq);
 			if (!_qps[i][j]) return cleanup();
 			if (!modify_qp_state_to_init(_qps[i][j])) return cleanup();
@@ -144,7 +144,7 @@ bool server_transport_t::cleanup(){
 	if (_qps) {
 		for (uint32_t i=0; i<g_num_client_nodes; i++) {
 			if(_qps[i]) {
-				for (uint32_t j=0; j<g_num_client_threads; j++) 
+				for (uint32_t j=0; j<g_num_client_qps; j++) 
 					if(_qps[i][j]) ibv_destroy_qp(_qps[i][j]);
 				delete[] _qps[i];
 			}
@@ -153,7 +153,7 @@ bool server_transport_t::cleanup(){
 	}
 	
 	if (_send_cqs) {
-		for (uint32_t i=0; i<g_num_client_threads; i++)
+		for (uint32_t i=0; i<g_num_client_qps; i++)
 			if (_send_cqs[i])
 				ibv_destroy_cq(_send_cqs[i]);
 		delete[] _send_cqs;
@@ -172,6 +172,7 @@ bool server_transport_t::connect() {
 	local.gid_idx = _context.gid_idx;
 	memcpy(&local.gid, &_context.gid, sizeof(union ibv_gid));
 	local.lid = _context.port_attr.lid;
+	local.num_qps = g_num_client_qps;
 #if TRANSPORT == ONE_SIDED
 	local.rkey = _alloc_mr->rkey;
 	local.dm_rkey = _dm_mr->rkey;
@@ -183,7 +184,7 @@ bool server_transport_t::connect() {
 
 	// exchange QP information with clients
 	for (uint32_t i=0; i<g_num_client_nodes; i++) {
-		for (uint32_t j=0; j<g_num_client_threads; j++) 
+		for (uint32_t j=0; j<g_num_client_qps; j++) 
 			local.qpn[j] = _qps[i][j]->qp_num;
 		for (uint32_t j=0; j<g_num_batch_threads; j++) 
 			local.batch_qpn[j] = _batch_qps[i][j]->qp_num;
@@ -205,8 +206,13 @@ bool server_transport_t::connect() {
 		uint32_t node_id = recv_msg->get_node_id();
 		char* qp_info = recv_msg->get_data();
 		memcpy(&_meta[node_id], qp_info, data_size);
+		if (_meta[node_id].num_qps != g_num_client_qps) {
+			debug::notify_error("Client node %u runs %u QPs, this server expects %u (client threads x coroutines)",
+								node_id, _meta[node_id].num_qps, g_num_client_qps);
+			return cleanup();
+		}
 		// modify QP states
-		for (uint32_t j=0; j<g_num_client_threads; j++) {
+		for (uint32_t j=0; j<g_num_client_qps; j++) {
 			if(!modify_qp_state_to_rtr(_qps[node_id][j], _meta[node_id].gid, _meta[node_id].gid_idx, _meta[node_id].lid, _meta[node_id].qpn[j])){
 				debug::notify_error("Failed to modify qp state to RTR");
 				return cleanup();
@@ -250,5 +256,5 @@ void server_transport_t::send_batch(char* ptr, uint32_t node_id, uint32_t qp_id,
 }
 
 void server_transport_t::post_recv_batch(char* ptr, uint32_t node_id, uint32_t qp_id, uint32_t size) {
-	rdma_recv_prepost(_batch_qps[node_id][qp_id], ptr, size, _mr->lkey, serialize_node_info(node_id, qp_id + g_num_client_threads));
+	rdma_recv_prepost(_batch_qps[node_id][qp_id], ptr, size, _mr->lkey, serialize_node_info(node_id, qp_id + g_num_client_qps));
 }
@@ -47,6 +47,11 @@ class server_transport_t : public transport_t {
 		void faa_dm(char* src, global_addr_t dest, uint64_t add, uint32_t size, bool signaled = true) { assert(false); }
 		void faa_dm_bound(char* src, global_addr_t dest, uint64_t add, uint64_t boundary, uint32_t size, bool signaled = true) { assert(false); }
 
+		// one-sided RDMA batch
+		void post_batch(wr_batch_t& batch) { assert(false); }
+		void post_batch_async(wr_batch_t& batch) { assert(false); }
+		void wait_batch(wr_batch_t& batch) { assert(false); }
+
 	private:
 		bool cleanup();
 		bool connect();
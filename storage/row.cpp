@@ -6,6 +6,7 @@
 #include "concurrency/twosided/nowait.h"
 #include "concurrency/twosided/waitdie.h"
 #include "concurrency/twosided/woundwait.h"
+#include "concurrency/twosided/lockword.h"
 
 row_t::row_t() { 
     init_manager();
@@ -1,6 +1,7 @@
 #pragma once
 #include "system/global.h"
 #include "system/global_address.h"
+#include "storage/version.h"
 
 class table_t;
 class catalog_t;
@@ -42,5 +43,12 @@ public:
 
 	ROW_MAN*    manager;
 	char        padding[8]; // for one-sided RDMA timestamp alignment
-	char        data[DEFAULT_ROW_SIZE];
+#if TRANSPORT == TWO_SIDED && SNAPSHOT_READ
+	row_version_t versions;
+#endif
+#if TRANSPORT == ONE_SIDED
+	char        data[DEFAULT_ROW_SIZE]; // rows in remote memory have a fixed size
+#else // TWO_SIDED
+	char        data[];                 // tuple size of the table (see table_t::get_new_row)
+#endif
 };
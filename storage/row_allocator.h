@@ -0,0 +1,97 @@
+#pragma once
+#include "system/global.h"
+#include "utils/debug.h"
+#include "utils/huge_page.h"
+#include "utils/numa.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+// slab allocator for the rows of a table (TWO_SIDED)
+// rows are sized to the tuple size of the table and carved out of hugepage slabs with a single atomic add,
+// so that parallel loaders do not serialize on malloc; rows are never freed (like the rest of the tables)
+// with NUMA_AWARE, each socket has its own slabs, which are first touched by the threads of that socket
+
+class row_allocator_t {
+public:
+    row_allocator_t(uint64_t row_size)
+        : _row_size((row_size + 7) & ~7ULL), _footprint(0), _slabs(numa::get_num_sockets()) {
+        for (auto& slab : _slabs)
+            slab.store(nullptr);
+    }
+
+    ~row_allocator_t() {
+        for (auto& slab : _slab_list) {
+            munmap(slab->base, slab->size);
+            delete slab;
+        }
+    }
+
+    // returns cnt contiguous rows of get_row_size() bytes each
+    char* alloc(uint64_t cnt) {
+        uint64_t size = cnt * _row_size;
+#if NUMA_AWARE
+        auto& cur_slab = _slabs[numa::get_thread_socket()];
+#else
+        auto& cur_slab = _slabs[0];
+#endif
+        if (size > ROW_SLAB_SIZE / 4) // large bulk allocations get their own slab
+            return new_slab(size)->base;
+
+        while (true) {
+            auto slab = cur_slab.load();
+            if (slab != nullptr) {
+                uint64_t offset = slab->cur.fetch_add(size);
+                if (offset + size <= slab->size)
+                    return slab->base + offset;
+            }
+            // the slab is full; the tail of it is left unused
+            std::lock_guard<std::mutex> guard(_latch);
+            if (cur_slab.load() == slab)
+                cur_slab.store(new_slab(ROW_SLAB_SIZE, false));
+        }
+    }
+
+    uint64_t get_row_size()  { return _row_size; }
+    uint64_t get_footprint() { return _footprint.load(); }
+
+private:
+    static constexpr uint64_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    struct slab_t {
+        char*                 base;
+        uint64_t              size;
+        std::atomic<uint64_t> cur;
+    };
+
+    slab_t* new_slab(uint64_t size, bool lock=true) {
+        size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        auto slab = new slab_t;
+        // fall back to transparent huge pages when no huge pages are reserved (the memory region takes them)
+        void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr == MAP_FAILED) {
+            addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (addr != MAP_FAILED)
+                madvise(addr, size, MADV_HUGEPAGE);
+        }
+        slab->base = reinterpret_cast<char*>(addr);
+        if (addr == MAP_FAILED) {
+            debug::notify_error("Server runs out of memory for rows !");
+            assert(false);
+            exit(1);
+        }
+        slab->size = size;
+        slab->cur.store(0);
+        _footprint += size;
+        if (lock) _latch.lock();
+        _slab_list.push_back(slab);
+        if (lock) _latch.unlock();
+        return slab;
+    }
+
+    uint64_t                          _row_size;
+    std::atomic<uint64_t>             _footprint;
+    std::mutex                        _latch;
+    std::vector<std::atomic<slab_t*>> _slabs;     // current slab of each socket
+    std::vector<slab_t*>              _slab_list; // all slabs
+};
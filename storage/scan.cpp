@@ -0,0 +1,48 @@
+#include "storage/scan.h"
+#include "storage/catalog.h"
+#include "storage/row.h"
+
+uint32_t scan_spec_t::get_entry_size(catalog_t* schema) {
+    assert(schema->get_field_cnt() <= 64);
+    if (columns == 0)
+        return sizeof(uint64_t) + schema->get_tuple_size();
+    uint32_t size = sizeof(uint64_t);
+    for (int fid=0; fid<schema->get_field_cnt(); fid++) {
+        if (columns & (1ULL << fid))
+            size += schema->get_field_size(fid);
+    }
+    return size;
+}
+
+bool scan_spec_t::match(catalog_t* schema, char* data) {
+    if (pred_op == NONE)
+        return true;
+    uint64_t value = 0;
+    uint32_t size = std::min<uint32_t>(schema->get_field_size(pred_field), sizeof(uint64_t));
+    memcpy(&value, row_t::get_value_v(schema, pred_field, data), size);
+    switch (pred_op) {
+        case EQ: return value == pred_operand;
+        case NE: return value != pred_operand;
+        case LT: return value <  pred_operand;
+        case LE: return value <= pred_operand;
+        case GT: return value >  pred_operand;
+        case GE: return value >= pred_operand;
+        default: assert(false); return false;
+    }
+}
+
+uint32_t scan_spec_t::project(catalog_t* schema, uint64_t key, char* data, char* dst) {
+    memcpy(dst, &key, sizeof(key));
+    uint32_t size = sizeof(key);
+    if (columns == 0) {
+        memcpy(dst + size, data, schema->get_tuple_size());
+        return size + schema->get_tuple_size();
+    }
+    for (int fid=0; fid<schema->get_field_cnt(); fid++) {
+        if (columns & (1ULL << fid)) {
+            memcpy(dst + size, row_t::get_value_v(schema, fid, data), schema->get_field_size(fid));
+            size += schema->get_field_size(fid);
+        }
+    }
+    return size;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "system/global.h"
+
+class catalog_t;
+
+// Range scan executed by the memory server (lock manager, TWO_SIDED).
+// A SCAN access whose cache field is RANGE carries this spec. The server walks the index leaf chain from the access
+// key up to end_key, visiting at most limit rows; it locks the rows it visits like reads, filters them with the
+// predicate and returns only the projected columns:
+//   [ rows | next key | ( key | projected columns ) * rows ]
+// A response holds at most one message; next key is the key to resume from if it filled up, or the first key of the
+// next partition if the range continues there, 0 otherwise. The client resumes the scan from next key, on the node of
+// that key, until it has received limit rows.
+struct __attribute__((packed)) scan_spec_t {
+    enum op_t : uint8_t { NONE, EQ, NE, LT, LE, GT, GE };
+
+    // cache field of a SCAN access followed by a spec (0 and 1 are cache hints, the rest row pointers)
+    static constexpr uint64_t RANGE = UINT64_MAX;
+    static constexpr uint32_t HEADER_SIZE = sizeof(uint32_t) + sizeof(uint64_t);
+
+    uint64_t end_key;      // inclusive
+    uint32_t limit;        // rows visited at most
+    uint64_t columns;      // bit i projects field i of the catalog; 0 projects every field
+    uint32_t pred_field;   // predicate: field <op> operand, on the first 8 bytes of the field
+    op_t     pred_op;
+    uint64_t pred_operand;
+
+    uint32_t get_entry_size(catalog_t* schema);
+    uint32_t get_result_size(catalog_t* schema) { return HEADER_SIZE + limit * get_entry_size(schema); }
+    bool     match(catalog_t* schema, char* data);
+    // key to resume from on the next partition, which starts after partition_end, once a partition has visited rows
+    // of the scan without reaching limit; 0 if the scan is complete
+    uint64_t get_next_key(uint32_t visited, uint64_t partition_end) {
+        return (visited < limit && end_key > partition_end) ? partition_end + 1 : 0;
+    }
+    // writes key and projected columns of a row into dst, returns the bytes written
+    uint32_t project(catalog_t* schema, uint64_t key, char* data, char* dst);
+};
@@ -1,10 +1,15 @@
 #include "storage/table.h"
 #include "storage/catalog.h"
 #include "storage/row.h"
+#include "storage/row_allocator.h"
+#include <new>
 
 table_t::table_t(catalog_t* schema){
     this->schema = schema;
     table_name = schema->table_name;
+#if TRANSPORT == TWO_SIDED
+    row_allocator = new row_allocator_t(get_row_size());
+#endif
 }
 
 uint64_t table_t::get_tuple_size(){
@@ -19,7 +24,36 @@ catalog_t* table_t::get_schema(){
     return schema;
 }
 
+uint64_t table_t::get_row_size(){
+#if TRANSPORT == ONE_SIDED
+    return sizeof(row_t);
+#else // TWO_SIDED
+    return offsetof(row_t, data) + get_tuple_size();
+#endif
+}
+
+uint64_t table_t::get_memory_footprint(){
+#if TRANSPORT == ONE_SIDED
+    return 0; // rows are in remote memory
+#else // TWO_SIDED
+    return row_allocator->get_footprint();
+#endif
+}
+
 RC table_t::get_new_row(row_t *& row) {
-    row = new row_t();
+    return get_new_rows(&row, 1);
+}
+
+RC table_t::get_new_rows(row_t** rows, uint64_t cnt) {
+#if TRANSPORT == ONE_SIDED
+    for (uint64_t i=0; i<cnt; i++)
+        rows[i] = new row_t();
+#else // TWO_SIDED
+    char* ptr = row_allocator->alloc(cnt);
+    for (uint64_t i=0; i<cnt; i++) {
+        rows[i] = new (ptr) row_t();
+        ptr += row_allocator->get_row_size();
+    }
+#endif
     return RCOK;
 }
@@ -3,11 +3,16 @@
 
 class catalog_t;
 class row_t;
+class row_allocator_t;
 class table_t{
 public:
 	table_t(catalog_t* schema);
 
 	RC get_new_row(row_t*& row);
+	// allocates cnt rows at once (e.g., for bulk loading)
+	RC get_new_rows(row_t** rows, uint64_t cnt);
+	uint64_t get_row_size();
+	uint64_t get_memory_footprint();
 	uint64_t get_tuple_size();
 	uint64_t get_field_cnt();
 	catalog_t* get_schema();
@@ -23,4 +28,7 @@ private:
 	char* table_name;
 	uint64_t cur_tab_size;
 	uint32_t table_id;
+#if TRANSPORT == TWO_SIDED
+	row_allocator_t* row_allocator;
+#endif
 };
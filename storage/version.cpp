@@ -0,0 +1,92 @@
+#include "storage/version.h"
+#include "utils/helper.h"
+#include "utils/reclaim.h"
+#include <algorithm>
+
+row_version_t::~row_version_t() {
+    auto version = _head.load();
+    while (version) {
+        auto next = version->next.load();
+        delete[] reinterpret_cast<char*>(version);
+        version = next;
+    }
+}
+
+void row_version_t::raise_rts(uint64_t ts) {
+    uint64_t rts = _rts.load();
+    while (rts < ts && !_rts.compare_exchange_weak(rts, ts)) { }
+}
+
+uint64_t row_version_t::prepare_write() {
+    uint64_t word = _word.load();
+    assert(get_state(word) == COMMITTED);
+    _bound.store(0);
+    _word.store(word | PENDING);
+    // a snapshot that raises rts after this point sees PENDING, one that raised it before is below the bound
+    uint64_t bound = std::max(get_wts(word), _rts.load()) + 1;
+    _bound.store(bound);
+    return bound;
+}
+
+void row_version_t::commit_write(uint64_t commit_ts, char* data, char* new_data, uint32_t size) {
+    uint64_t word = _word.load();
+    assert(get_state(word) == PENDING);
+    assert(commit_ts >= _bound.load());
+    uint64_t wts = get_wts(word);
+    _word.store((wts << STATE_BITS) | INSTALLING);
+
+    if (MAX_VERSIONS > 0) {
+        auto version = reinterpret_cast<version_t*>(new char[sizeof(version_t) + size]);
+        version->ts = wts;
+        version->next.store(_head.load());
+        memcpy(version->data, data, size);
+        _head.store(version);
+
+        // keep MAX_VERSIONS versions; readers may still walk the trimmed ones
+        auto last = version;
+        for (uint32_t i=1; i<MAX_VERSIONS && last; i++)
+            last = last->next.load();
+        auto trimmed = last ? last->next.exchange(nullptr) : nullptr;
+        while (trimmed) {
+            auto next = trimmed->next.load();
+            reclaim::retire(trimmed, sizeof(version_t) + size, [](void* ptr, void*) { delete[] static_cast<char*>(ptr); });
+            trimmed = next;
+        }
+    }
+
+    memcpy(data, new_data, size);
+    _word.store(commit_ts << STATE_BITS);
+}
+
+void row_version_t::abort_write() {
+    uint64_t word = _word.load();
+    assert(get_state(word) == PENDING);
+    _word.store(word & ~STATE_MASK);
+}
+
+bool row_version_t::read(uint64_t snapshot_ts, char* data, char* dst, uint32_t size) {
+    raise_rts(snapshot_ts);
+    for (uint32_t i=0; i<MAX_RETRIES; i++) {
+        uint64_t word = _word.load();
+        uint64_t state = get_state(word);
+        if (state == INSTALLING || (state == PENDING && _bound.load() <= snapshot_ts)) {
+            PAUSE
+            continue;
+        }
+        if (get_wts(word) <= snapshot_ts) {
+            memcpy(dst, data, size);
+            if (_word.load() == word) // not replaced meanwhile
+                return true;
+            continue;
+        }
+        reclaim::guard_t guard;
+        for (auto version = _head.load(); version; version = version->next.load()) {
+            if (version->ts <= snapshot_ts) {
+                memcpy(dst, version->data, size);
+                return true;
+            }
+        }
+        return false;
+    }
+    return false;
+}
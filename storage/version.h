@@ -0,0 +1,54 @@
+#pragma once
+#include "system/global.h"
+#include <atomic>
+#include <cstdint>
+
+// Committed versions of a row for snapshot reads (SNAPSHOT_READ, TWO_SIDED).
+// The row keeps its newest data in place, stamped with the commit timestamp of its writer (wts); up to MAX_VERSIONS
+// older versions hang off it, newest first. A read-only txn copies the newest version that is not younger than its
+// snapshot timestamp without taking the row lock, and raises the read timestamp (rts) of the row.
+// Update txns keep 2PL. When one prepares, the rows it writes become PENDING with a lower bound for its commit
+// timestamp above wts and rts, so a commit never lands under a snapshot that has already read the previous version.
+// A snapshot at or above the bound of a PENDING row cannot tell yet whether the write belongs to it.
+class row_version_t {
+public:
+    row_version_t() : _word(0), _bound(0), _rts(0), _head(nullptr) { }
+    ~row_version_t();
+
+    // update txn holding the row lock: lower bounds of its commit timestamp
+    uint64_t prepare_read()  { return get_wts(_word.load()) + 1; }
+    uint64_t prepare_write();
+
+    // update txn holding the row lock: stamps the access with the commit timestamp
+    void     commit_read(uint64_t commit_ts) { raise_rts(commit_ts); }
+    void     commit_write(uint64_t commit_ts, char* data, char* new_data, uint32_t size);
+    void     abort_write();
+
+    // read-only txn: copies the version visible at the snapshot into dst;
+    // false if that version has been trimmed or a pending write keeps it undecided
+    bool     read(uint64_t snapshot_ts, char* data, char* dst, uint32_t size);
+
+private:
+    struct version_t {
+        uint64_t                ts;
+        std::atomic<version_t*> next;
+        char                    data[];
+    };
+
+    // _word: [ wts (62) | state (2) ]
+    static constexpr uint64_t COMMITTED   = 0;
+    static constexpr uint64_t PENDING     = 1; // prepared, the write may commit at _bound or later
+    static constexpr uint64_t INSTALLING  = 2; // the data is being replaced
+    static constexpr uint64_t STATE_MASK  = 0x3;
+    static constexpr uint32_t STATE_BITS  = 2;
+    static constexpr uint32_t MAX_RETRIES = 1000;
+
+    static uint64_t get_wts(uint64_t word)   { return word >> STATE_BITS; }
+    static uint64_t get_state(uint64_t word) { return word & STATE_MASK; }
+    void            raise_rts(uint64_t ts);
+
+    std::atomic<uint64_t>   _word;
+    std::atomic<uint64_t>   _bound; // of the PENDING write; 0 while it is computed
+    std::atomic<uint64_t>   _rts;
+    std::atomic<version_t*> _head;
+};
@@ -1,7 +1,10 @@
 #include "system/cc_manager.h"
 #include "concurrency/lock_manager.h"
 #include "concurrency/idx_manager.h"
+#include "system/manager.h"
+#include "system/workload.h"
 #include "txn/txn.h"
+#include "utils/numa.h"
 
 cc_manager_t* cc_manager_t::create(txn_t* txn) {
     return new CC_MAN(txn);
@@ -15,4 +18,15 @@ cc_manager_t::cc_manager_t(txn_t* txn)
 void cc_manager_t::clear() {
     _inserts.clear();
     _deletes.clear();
-}
\ No newline at end of file
+}
+void cc_manager_t::count_socket_access(RowAccess* access) {
+    auto socket = GET_WORKLOAD->get_socket_by_key(access->key, access->index_id);
+    if (socket >= numa::get_num_sockets()) // the key does not tell where its row is
+        return;
+    if (socket == numa::get_thread_socket()) {
+        INC_INT_STATS(num_local_accesses, 1);
+    }
+    else {
+        INC_INT_STATS(num_remote_accesses, 1);
+    }
+}
@@ -3,9 +3,12 @@
 #include "system/global.h"
 #include "system/global_address.h"
 #include "utils/helper.h"
+#include "utils/inline_vector.h"
+#include "utils/node_set.h"
 
 class txn_t;
 class UnstructuredBuffer;
+struct scan_spec_t;
 
 class cc_manager_t {
 public:
@@ -14,6 +17,9 @@ public:
     cc_manager_t(txn_t* txn);
     virtual ~cc_manager_t() = default;
 
+    // accesses kept inline in the access set of a txn (more spill to the heap)
+    static constexpr uint32_t INLINE_ACCESSES = 16;
+
     struct RowAccess {
         RowAccess() : processed(false), value(), data_size(0), cache(0), 
                       data(nullptr), cache_data(nullptr) {  }
@@ -31,6 +37,8 @@ public:
         char*    cache_data;
 
         bool waiting = false;
+        bool hot = false; // reported hot by the memory server (NUM_HOT_KEYS)
+        scan_spec_t* scan = nullptr; // range scan (storage/scan.h); the server registers the rows it visits after it
     };
 
     struct IndexAccess {
@@ -57,8 +65,44 @@ public:
         uint64_t key;
     };
 
+    // Wire layouts of an access in request/response messages, written into the send buffer and read from
+    // the receive buffer in place (UnstructuredBuffer::put_ptr/get_ptr) instead of field by field.
+    struct __attribute__((packed)) AccessTuple { // lock manager request
+        access_t type;
+        uint64_t key;
+        uint32_t index_id;
+        uint32_t table_id;
+        uint64_t cache; // cache hint
+    };
+    static_assert(sizeof(AccessTuple) == sizeof(access_t) + 2 * sizeof(uint64_t) + 2 * sizeof(uint32_t), "AccessTuple is packed");
+
+    struct __attribute__((packed)) IndexTuple { // index manager request, followed by an EvictTuple if cache_op is 2
+        uint64_t cache_op;
+        access_t type;
+        uint64_t key;
+        uint32_t index_id;
+        uint32_t table_id;
+        uint64_t value;
+    };
+    static_assert(sizeof(IndexTuple) == sizeof(access_t) + 3 * sizeof(uint64_t) + 2 * sizeof(uint32_t), "IndexTuple is packed");
+
+    struct __attribute__((packed)) EvictTuple {
+        uint64_t key;
+        uint64_t value;
+    };
+
+    struct __attribute__((packed)) IndexResult { // index manager response
+        uint64_t value;
+#if NUM_HOT_KEYS > 0
+        uint8_t  hot;
+#endif
+    };
+
     virtual void       register_access(uint32_t node_id, access_t type, uint64_t key, uint32_t table_id, uint32_t index_id, uint64_t value=0) = 0; 
     virtual void       register_access(access_t type, uint64_t key, uint32_t table_id, uint32_t index_id, uint64_t cache, uint64_t value=0, uint64_t evict_key=0, uint64_t evict_value=0) = 0;
+    // range scan from key (lock manager, TWO_SIDED); data of the access holds the scan result
+    virtual void       register_scan(uint32_t node_id, uint64_t key, uint32_t table_id, uint32_t index_id, const scan_spec_t& spec) { assert(false); }
+    virtual void       register_scan(uint64_t key, uint32_t table_id, uint32_t index_id, const scan_spec_t& spec) { assert(false); }
     virtual RowAccess* get_last_access() = 0;
     virtual int        get_last_access_idx() = 0;
 
@@ -92,6 +136,8 @@ public:
     virtual void       clear_nodes_involved(std::vector<uint32_t>& nodes_aborted) = 0;
     virtual void       abort() = 0;
     virtual char*      get_data(uint64_t key, uint32_t table_id) = 0;
+    // resets the manager for the next txn (e.g., when a server txn is reused)
+    virtual void       clear();
 
     
 
@@ -100,7 +146,8 @@ protected:
     // For now, just ignore index concurrency control.
     // Since this is not a problem for YCSB and TPCC.
     virtual void     commit_insdel() = 0;
-    virtual void     clear();
+    // counts whether the accessed key is on the socket of this server thread (NUMA_AWARE)
+    void             count_socket_access(RowAccess* access);
 
     txn_t*           _txn;
     vector<InsertOp> _inserts;
@@ -70,6 +70,8 @@ uint32_t g_init_parallelism   = INIT_PARALLELISM;
 uint32_t g_total_num_threads  = 0;
 uint32_t g_num_batch_threads  = 0;
 uint32_t g_num_client_threads = NUM_CLIENT_THREADS;
+uint32_t g_num_client_coros   = NUM_CLIENT_COROS;
+uint32_t g_num_client_qps     = NUM_CLIENT_THREADS * NUM_CLIENT_COROS;
 uint32_t g_num_server_threads = NUM_SERVER_THREADS;
 uint32_t g_max_num_waits      = MAX_NUM_WAITS;
 uint32_t g_num_nodes          = 0;
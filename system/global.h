@@ -141,6 +141,7 @@ namespace twosided {
 class nowait_t;
 class waitdie_t;
 class woundwait_t;
+template <uint32_t ALG> class lockword_t;
 }
 
 #ifndef CC_ALG // just in case
@@ -153,7 +154,9 @@ using CC_MAN = idx_manager_t;
 using CC_MAN = lock_manager_t;
 #endif
 
-#if CC_ALG == NO_WAIT
+#if TRANSPORT == TWO_SIDED && ROW_LOCK == LOCK_WORD
+using ROW_MAN = lockword_t<CC_ALG>;
+#elif CC_ALG == NO_WAIT
 using ROW_MAN = nowait_t;
 #elif CC_ALG == WAIT_DIE
 using ROW_MAN = waitdie_t;
@@ -231,6 +234,8 @@ extern uint32_t g_init_parallelism;
 extern uint32_t g_total_num_threads;
 extern uint32_t g_num_batch_threads;
 extern uint32_t g_num_client_threads;
+extern uint32_t g_num_client_coros;
+extern uint32_t g_num_client_qps; // g_num_client_threads * g_num_client_coros
 extern uint32_t g_num_server_threads;
 extern uint32_t g_num_nodes; // for clients, number of servers; for servers, number of clients
 extern uint32_t g_num_client_nodes;
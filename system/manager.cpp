@@ -3,9 +3,12 @@
 #include "transport/transport.h"
 #include "batch/table.h"
 #include "batch/manager.h"
+#include "txn/manager.h"
 
 thread_local drand48_data manager_t::_buffer;
 thread_local uint32_t manager_t::_thread_id;
+thread_local uint32_t manager_t::_qp_id;
+thread_local txn_manager_t* manager_t::_txn_manager = nullptr;
 thread_local batch_manager_t* manager_t::_batch_manager = nullptr;
 
 manager_t::manager_t() {
@@ -50,6 +53,16 @@ double manager_t::rand_double() {
     return r;
 }
 
+void manager_t::yield() {
+    if (_txn_manager)
+        _txn_manager->yield();
+}
+
+void manager_t::yield_on_completion() {
+    if (_txn_manager)
+        _txn_manager->yield_on_completion();
+}
+
 void manager_t::worker_thread_done() {
     _num_finished_threads.fetch_add(1);
 }
@@ -9,6 +9,7 @@ class row_t;
 class workload_t;
 class transport_t;
 class batch_table_t;
+class txn_manager_t;
 
 
 // Global Manager shared by all the threads.
@@ -33,9 +34,19 @@ class manager_t {
         uint32_t        get_node_id() { return _node_id; }
 
         // thread id
-        void            set_tid(uint64_t thread_id) { _thread_id = thread_id; }
+        void            set_tid(uint64_t thread_id) { _thread_id = thread_id; _qp_id = thread_id; }
         uint64_t        get_tid() { return _thread_id; }
 
+        // qp id; differs from the thread id when a client thread runs multiple coroutines
+        void            set_qp_id(uint32_t qp_id) { _qp_id = qp_id; }
+        uint32_t        get_qp_id() { return _qp_id; }
+
+        // txn manager of the running coroutine; yield() gives up the thread while waiting for responses
+        void            set_txn_manager(txn_manager_t* txn_man) { _txn_manager = txn_man; }
+        txn_manager_t*  get_txn_manager() { return _txn_manager; }
+        void            yield();
+        void            yield_on_completion(); // see txn_manager_t::yield_scope_t
+
         // workload
         void            set_workload(workload_t* wl) { _wl = wl; }
         workload_t*     get_workload() { return _wl; }
@@ -75,6 +86,8 @@ class manager_t {
         uint32_t        _node_id; 
         // thread id
         static thread_local uint32_t _thread_id;
+        static thread_local uint32_t _qp_id;
+        static thread_local txn_manager_t* _txn_manager;
 
         // workload
         workload_t*     _wl;
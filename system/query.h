@@ -8,6 +8,8 @@ public:
     virtual ~base_query_t() = default;
 
     virtual void gen_requests() = 0; 
+    // the txn writes nothing, it may read a snapshot (SNAPSHOT_READ)
+    virtual bool is_read_only() { return false; }
     uint64_t     get_ts() { return _txn_ts; }
     void         set_ts(uint64_t ts) { _txn_ts = ts; }
 
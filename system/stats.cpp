@@ -3,16 +3,25 @@
 #include "utils/helper.h"
 #include "batch/table.h"
 #include "transport/message.h"
+#include "utils/numa.h"
 #include <algorithm>
 #include <iomanip>
 
-stats_thd_t::stats_thd_t() {
+stats_thd_t::stats_thd_t(bool collect_latency) {
     _float_stats = new double [NUM_FLOAT_STATS];
     _int_stats = new uint64_t [NUM_INT_STATS];
     _batch_stats = new uint64_t [batch_table_t::MAX_GROUP_SIZE];
+    _latency_stats = collect_latency ? new latency_hist_t [NUM_LATENCY_STATS] : nullptr;
     clear();
 }
 
+stats_thd_t::~stats_thd_t() {
+    delete[] _float_stats;
+    delete[] _int_stats;
+    delete[] _batch_stats;
+    delete[] _latency_stats;
+}
+
 void stats_thd_t::init(uint32_t tid) {
     clear();
 }
@@ -21,7 +30,10 @@ void stats_thd_t::clear() {
     memset(_float_stats, 0, sizeof(double) * NUM_FLOAT_STATS);
     memset(_int_stats, 0, sizeof(uint64_t) * NUM_INT_STATS);
     memset(_batch_stats, 0, sizeof(uint64_t) * batch_table_t::MAX_GROUP_SIZE);
-    all_latency.clear();
+    if (_latency_stats) {
+        for (uint32_t i=0; i<NUM_LATENCY_STATS; i++)
+            _latency_stats[i].clear();
+    }
 }
 
 void stats_thd_t::copy_from(stats_thd_t* stats_thd) {
@@ -33,11 +45,15 @@ void stats_thd_t::copy_from(stats_thd_t* stats_thd) {
 ////////////////////////////////////////////////
 // class stats_t
 ////////////////////////////////////////////////
-stats_t::stats_t() {
+stats_t::stats_t(bool checkpoint) {
     _num_checkpoints = 0;
     _stats = new stats_thd_t* [g_total_num_threads];
+    // checkpoints only keep the window percentiles, not the histograms
     for (uint32_t i = 0; i < g_total_num_threads; i++)
-        _stats[i] = new stats_thd_t();
+        _stats[i] = new stats_thd_t(COLLECT_LATENCY && !checkpoint);
+    _aggregate_latency = nullptr;
+    _last_cp_latency = nullptr;
+    memset(_cp_latency, 0, sizeof(_cp_latency));
 }
 
 
@@ -108,6 +124,14 @@ void stats_t::output(std::ostream* os) {
         std::cout << ')' << std::endl;
     }
 
+    uint64_t num_index_ops = 0, num_index_round_trips = 0;
+    for (uint32_t tid=0; tid<g_total_num_threads; tid++) {
+        num_index_ops += _stats[tid]->_int_stats[STAT_num_index_ops];
+        num_index_round_trips += _stats[tid]->_int_stats[STAT_num_index_round_trips];
+    }
+    if (num_index_ops > 0)
+        std::cout << "    " << std::setw(30) << std::left << "round_trips_per_index_op:" << (double)num_index_round_trips / num_index_ops << std::endl;
+
     // print batch stats
     for (uint32_t i=0; i<batch_table_t::MAX_GROUP_SIZE; i++) {
         uint64_t total = 0;
@@ -116,24 +140,38 @@ void stats_t::output(std::ostream* os) {
         std::cout << "    " << std::setw(30) << std::left << ("batch_num_" + std::to_string(i + 1) + ':') << total << std::endl;
     }
 
+#if NUMA_AWARE
+    if (g_is_server)
+        output_sockets(os);
+#endif
+
 #if COLLECT_LATENCY
-    if (!g_is_server) {
-        double avg_latency = 0;
-        uint64_t total_latency_count = _aggregate_latency.size();
-        for (uint32_t tid=0; tid<g_total_num_threads; tid++)
-            avg_latency += _stats[tid]->_float_stats[STAT_txn_latency];
-        avg_latency /= total_latency_count;
-
-        std::cout << "    " << std::setw(30) << std::left << "average_latency:" << avg_latency / BILLION << std::endl;
-        // print latency distribution
-        std::cout << "    " << std::setw(30) << std::left << "90%_latency:"
-                << _aggregate_latency[(uint64_t)(total_latency_count * 0.90)] / BILLION << std::endl;
-        std::cout << "    " << std::setw(30) << std::left << "95%_latency:"
-                << _aggregate_latency[(uint64_t)(total_latency_count * 0.95)] / BILLION << std::endl;
-        std::cout << "    " << std::setw(30) << std::left << "99%_latency:"
-                << _aggregate_latency[(uint64_t)(total_latency_count * 0.99)] / BILLION << std::endl;
-        std::cout << "    " << std::setw(30) << std::left << "max_latency:"
-                << _aggregate_latency[total_latency_count - 1] / BILLION << std::endl;
+    if (_aggregate_latency) {
+        auto& txn_latency = _aggregate_latency[LAT_txn_latency];
+        if (!g_is_server && txn_latency.get_total() > 0) {
+            double avg_latency = 0;
+            for (uint32_t tid=0; tid<g_total_num_threads; tid++)
+                avg_latency += _stats[tid]->_float_stats[STAT_txn_latency];
+            avg_latency /= txn_latency.get_total();
+
+            std::cout << "    " << std::setw(30) << std::left << "average_latency:" << avg_latency / BILLION << std::endl;
+            // print latency distribution
+            std::cout << "    " << std::setw(30) << std::left << "50%_latency:"
+                    << txn_latency.get_percentile(0.50) / (double)BILLION << std::endl;
+            std::cout << "    " << std::setw(30) << std::left << "90%_latency:"
+                    << txn_latency.get_percentile(0.90) / (double)BILLION << std::endl;
+            std::cout << "    " << std::setw(30) << std::left << "95%_latency:"
+                    << txn_latency.get_percentile(0.95) / (double)BILLION << std::endl;
+            std::cout << "    " << std::setw(30) << std::left << "99%_latency:"
+                    << txn_latency.get_percentile(0.99) / (double)BILLION << std::endl;
+            std::cout << "    " << std::setw(30) << std::left << "99.9%_latency:"
+                    << txn_latency.get_percentile(0.999) / (double)BILLION << std::endl;
+            std::cout << "    " << std::setw(30) << std::left << "max_latency:"
+                    << txn_latency.get_max() / (double)BILLION << std::endl;
+        }
+        // per-phase latency distribution
+        for (uint32_t n=LAT_txn_latency + 1; n<NUM_LATENCY_STATS; n++)
+            output_latency(os, n, &_aggregate_latency[n]);
 
         std::cout << std::endl;
     }
@@ -147,6 +185,21 @@ void stats_t::output(std::ostream* os) {
             std::cout << stats_int_name[i] << ',';
         for (uint32_t i=0; i<NUM_FLOAT_STATS; i++)
             std::cout << stats_float_name[i] << ',';
+#if COLLECT_LATENCY
+        // latency percentiles of each window (in us)
+        for (uint32_t i=0; i<NUM_LATENCY_STATS; i++) {
+            std::cout << stats_latency_name[i] << "_p50," << stats_latency_name[i] << "_p99,"
+                      << stats_latency_name[i] << "_p999," << stats_latency_name[i] << "_max,";
+        }
+#endif
+#if NUMA_AWARE
+        if (g_is_server) {
+            for (uint32_t socket=0; socket<numa::get_num_sockets(); socket++)
+                std::cout << "socket" << socket << "_thr,";
+        }
+#endif
+        for (auto& name: _knob_names)
+            std::cout << name << ',';
         std::cout << std::endl;
     }
 
@@ -178,10 +231,82 @@ void stats_t::output(std::ostream* os) {
             }
             std::cout << value / BILLION << ',';
         }
+#if COLLECT_LATENCY
+        for (uint32_t n=0; n<NUM_LATENCY_STATS; n++) {
+            for (uint32_t p=0; p<NUM_PERCENTILES; p++)
+                std::cout << _checkpoints[i]->_cp_latency[n][p] / 1000.0 << ',';
+        }
+#endif
+#if NUMA_AWARE
+        if (g_is_server) {
+            for (uint32_t socket=0; socket<numa::get_num_sockets(); socket++) {
+                uint64_t num_accesses = _checkpoints[i]->get_socket_accesses(socket)
+                                      - _checkpoints[i - 1]->get_socket_accesses(socket);
+                std::cout << 1.0 * num_accesses / STATS_CP_INTERVAL * 1000 << ',';
+            }
+        }
+#endif
+        for (auto ratio: _checkpoints[i]->_cp_knobs)
+            std::cout << ratio << ',';
         std::cout << std::endl;
     }
 }
 
+void stats_t::output_latency(std::ostream* os, uint32_t lat, latency_hist_t* hist) {
+    if (hist->get_total() == 0)
+        return;
+    std::cout << "    " << std::setw(30) << std::left << stats_latency_name[lat] + " (in us):"
+              << "p50 " << hist->get_percentile(0.5) / 1000.0
+              << ", p99 " << hist->get_percentile(0.99) / 1000.0
+              << ", p99.9 " << hist->get_percentile(0.999) / 1000.0
+              << ", max " << hist->get_max() / 1000.0
+              << " (" << hist->get_total() << " samples)" << std::endl;
+}
+
+// server threads are spread over the sockets in the same way as they are bound (NUMA_AWARE)
+uint64_t stats_t::get_socket_stats(uint32_t socket, uint32_t stat) {
+    uint64_t total = 0;
+    for (uint32_t tid=0; tid<g_num_server_threads; tid++) {
+        if (numa::get_socket_of(tid, g_num_server_threads) == socket)
+            total += _stats[tid]->_int_stats[stat];
+    }
+    return total;
+}
+
+uint64_t stats_t::get_socket_accesses(uint32_t socket) {
+    return get_socket_stats(socket, STAT_num_local_accesses) + get_socket_stats(socket, STAT_num_remote_accesses);
+}
+
+// throughput of a socket is the number of row/index accesses its server threads serve per second
+void stats_t::output_sockets(std::ostream* os) {
+    // server threads do not record their run time; measure over the checkpointed period instead
+    double thr_elapsed = 0;
+    if (_checkpoints.size() > 1)
+        thr_elapsed = (_checkpoints.size() - 1) * STATS_CP_INTERVAL / 1000.0;
+    for (uint32_t socket=0; socket<numa::get_num_sockets(); socket++) {
+        uint64_t num_local = get_socket_stats(socket, STAT_num_local_accesses);
+        uint64_t num_remote = get_socket_stats(socket, STAT_num_remote_accesses);
+        double thr = 0;
+        if (thr_elapsed > 0)
+            thr = (_checkpoints.back()->get_socket_accesses(socket) - _checkpoints[0]->get_socket_accesses(socket)) / thr_elapsed;
+        std::cout << "    " << std::setw(30) << std::left << ("socket" + std::to_string(socket) + ':')
+                  << "throughput " << thr
+                  << ", local_accesses " << num_local
+                  << ", remote_accesses " << num_remote
+                  << " (" << (num_local + num_remote > 0 ? 100.0 * num_local / (num_local + num_remote) : 0) << "% local)" << std::endl;
+    }
+}
+
+void stats_t::merge_latency(latency_hist_t* hist) {
+    for (uint32_t n=0; n<NUM_LATENCY_STATS; n++) {
+        hist[n].clear();
+        for (uint32_t tid=0; tid<g_total_num_threads; tid++) {
+            if (_stats[tid]->_latency_stats)
+                hist[n].merge(_stats[tid]->_latency_stats[n]);
+        }
+    }
+}
+
 void stats_t::print() {
     std::ofstream file;
     bool write_to_file = false;
@@ -191,23 +316,9 @@ void stats_t::print() {
     }
     // compute the latency distribution
 #if COLLECT_LATENCY
-    if (!g_is_server) {
-        for (uint32_t tid=0; tid<g_total_num_threads; tid++) {
-            _aggregate_latency.insert(_aggregate_latency.end(),
-                                    _stats[tid]->all_latency.begin(),
-                                    _stats[tid]->all_latency.end());
-        }
-        if (_aggregate_latency.size() > 1000000) {
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::vector<double> sampled_latency;
-            sampled_latency.reserve(1000000);
-            std::sample(_aggregate_latency.begin(), _aggregate_latency.end(),
-                        std::back_inserter(sampled_latency), 1000000, gen);
-            _aggregate_latency = std::move(sampled_latency);
-        }
-        std::sort(_aggregate_latency.begin(), _aggregate_latency.end());
-    }
+    if (_aggregate_latency == nullptr)
+        _aggregate_latency = new latency_hist_t [NUM_LATENCY_STATS];
+    merge_latency(_aggregate_latency);
 #endif
     output(&cout);
     if (write_to_file) {
@@ -227,21 +338,63 @@ void stats_t::output_cdf() {
         std::ofstream file;
         file.open ("cdf.txt");
         file << std::fixed << std::setprecision(6);
-        for (uint32_t i=0; i<_aggregate_latency.size(); i++) // in us
-            file << _aggregate_latency[i] / 1000 << std::endl;
+        // one line per non-empty bucket: latency (in us), cumulative fraction
+        auto& txn_latency = _aggregate_latency[LAT_txn_latency];
+        uint64_t cnt = 0;
+        for (uint32_t i=0; i<latency_hist_t::NUM_BUCKETS; i++) {
+            if (txn_latency.get_count(i) == 0)
+                continue;
+            cnt += txn_latency.get_count(i);
+            file << latency_hist_t::get_value(i) / 1000.0 << ' ' << 1.0 * cnt / txn_latency.get_total() << std::endl;
+        }
         file.close();
     }
 #endif
 }
 
 void stats_t::checkpoint() {
-    stats_t* stats = new stats_t();
+    stats_t* stats = new stats_t(true);
     stats->copy_from(this);
+#if COLLECT_LATENCY
+    // percentiles of the window since the last checkpoint
+    if (_last_cp_latency == nullptr)
+        _last_cp_latency = new latency_hist_t [NUM_LATENCY_STATS];
+    auto window = new latency_hist_t [NUM_LATENCY_STATS];
+    merge_latency(window);
+    for (uint32_t n=0; n<NUM_LATENCY_STATS; n++) {
+        latency_hist_t current = window[n];
+        window[n].subtract(_last_cp_latency[n]);
+        _last_cp_latency[n] = current;
+        for (uint32_t p=0; p<NUM_PERCENTILES; p++)
+            stats->_cp_latency[n][p] = window[n].get_percentile(PERCENTILES[p]);
+    }
+    delete[] window;
+#endif
     _checkpoints.push_back(stats);
     COMPILER_BARRIER
     _num_checkpoints++;
 }
 
+void stats_t::rebase_checkpoints() {
+    for (auto cp: _checkpoints) {
+        for (uint32_t i=0; i<g_total_num_threads; i++)
+            delete cp->_stats[i];
+        delete[] cp->_stats;
+        delete cp;
+    }
+    _checkpoints.clear();
+    // the latency windows restart from the cleared histograms as well
+    delete[] _last_cp_latency;
+    _last_cp_latency = nullptr;
+    checkpoint();
+}
+
+void stats_t::record_knobs(std::vector<std::string>& names, std::vector<double>& ratios) {
+    assert(!_checkpoints.empty());
+    _knob_names = names;
+    _checkpoints.back()->_cp_knobs = ratios;
+}
+
 void stats_t::copy_from(stats_t* stats) {
     for (uint32_t i=0; i<g_total_num_threads; i++)
         _stats[i]->copy_from(stats->_stats[i]);
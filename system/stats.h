@@ -1,6 +1,7 @@
 #pragma once
 #include "system/global.h"
 #include "utils/helper.h"
+#include "utils/histogram.h"
 
 enum stats_float_t {
     // txn
@@ -19,6 +20,9 @@ enum stats_float_t {
     STAT_time_prepare,
     STAT_time_commit,
 
+    // compute-side index cache
+    STAT_time_evict,
+
     NUM_FLOAT_STATS
 };
 
@@ -27,6 +31,9 @@ enum stats_int_t {
     STAT_num_commits,
     STAT_num_aborts,
     STAT_num_waits,
+    STAT_num_snapshot_reads,  // rows read by read-only txns without locks (SNAPSHOT_READ)
+    STAT_num_snapshot_aborts, // read-only txns whose snapshot version was trimmed or undecided
+    STAT_num_scan_rows,       // rows returned by range scans on the memory server
 
     // network 
     STAT_bytes_sent,
@@ -45,13 +52,40 @@ enum stats_int_t {
     STAT_num_cache_hits,
     STAT_num_cache_misses,
     STAT_num_cache_evictions,
+    STAT_max_retired_bytes, // largest footprint of evicted entries waiting for reclamation (per thread)
+    STAT_bytes_reclaimed,   // evicted entries freed by the reclamation (utils/reclaim.h)
+    STAT_max_reclaim_lag,   // longest wait of an evicted entry between its retirement and its reclamation (in us, per thread)
+    STAT_num_hot_admissions, // misses admitted to the cache because the memory server reported the key as hot
+
+    // one-sided index (Sherman)
+    STAT_num_index_ops,          // lookups, inserts, deletes and scans
+    STAT_num_index_round_trips,  // dependent RDMA round trips spent by them
+    STAT_num_speculative_misses, // speculative page reads that were discarded (inconsistent page or failed lock CAS)
+
+    // NUMA (server)
+    STAT_num_local_accesses,  // rows/index entries on the socket of the server thread
+    STAT_num_remote_accesses, // rows/index entries on another socket
 
     NUM_INT_STATS
 };
 
+// latencies recorded in histograms (COLLECT_LATENCY)
+enum stats_latency_t {
+    LAT_txn_latency,
+
+    LAT_time_index,
+    LAT_time_lock,
+    LAT_time_prepare,
+    LAT_time_commit,
+    LAT_time_wait,
+
+    NUM_LATENCY_STATS
+};
+
 class stats_thd_t {
 public:
-    stats_thd_t();
+    stats_thd_t(bool collect_latency=COLLECT_LATENCY);
+    ~stats_thd_t();
     void copy_from(stats_thd_t* stats_thd);
 
     void init(uint32_t tid);
@@ -60,12 +94,12 @@ public:
     double*   _float_stats;
     uint64_t* _int_stats;
     uint64_t* _batch_stats;
-    std::vector<double> all_latency;
+    latency_hist_t* _latency_stats; // nullptr if latencies are not collected
 };
 
 class stats_t {
 public:
-    stats_t();
+    stats_t(bool checkpoint=false);
     // PER THREAD statistics
     stats_thd_t** _stats;
 
@@ -77,10 +111,16 @@ public:
     void print_lat_distr();
 
     void checkpoint();
+    // drops the checkpoints taken before the threads cleared their stats (warmup) and takes a new first one
+    void rebase_checkpoints();
+    // ratios of the compute-side caches the window of the last checkpoint ran with (ADAPTIVE_CACHE)
+    void record_knobs(std::vector<std::string>& names, std::vector<double>& ratios);
     void copy_from(stats_t* stats);
 
     void output(std::ostream* os);
     void output_cdf();
+    void output_latency(std::ostream* os, uint32_t lat, latency_hist_t* hist);
+    void output_sockets(std::ostream* os);
 
     std::string stats_float_name[NUM_FLOAT_STATS] = {
         // worker thread
@@ -97,12 +137,17 @@ public:
         "time_lock",
         "time_prepare",
         "time_commit",
+
+        "time_evict",
     };
 
     std::string stats_int_name[NUM_INT_STATS] = {
         "num_commits",
         "num_aborts",
         "num_waits",
+        "num_snapshot_reads",
+        "num_snapshot_aborts",
+        "num_scan_rows",
 
         "bytes_sent",
         "bytes_received",
@@ -118,9 +163,42 @@ public:
         "num_cache_hits",
         "num_cache_misses",
         "num_cache_evictions",
+        "max_retired_bytes",
+        "bytes_reclaimed",
+        "max_reclaim_lag",
+        "num_hot_admissions",
+
+        "num_index_ops",
+        "num_index_round_trips",
+        "num_speculative_misses",
+
+        "num_local_accesses",
+        "num_remote_accesses",
+    };
+
+    std::string stats_latency_name[NUM_LATENCY_STATS] = {
+        "txn_latency",
+
+        "time_index",
+        "time_lock",
+        "time_prepare",
+        "time_commit",
+        "time_wait",
     };
 private:
-    std::vector<double>   _aggregate_latency;
+    void merge_latency(latency_hist_t* hist);
+    uint64_t get_socket_stats(uint32_t socket, uint32_t stat);
+    uint64_t get_socket_accesses(uint32_t socket);
+
+    // percentiles reported for each latency (per checkpoint window and for the whole run)
+    static constexpr uint32_t NUM_PERCENTILES = 4;
+    static constexpr double   PERCENTILES[NUM_PERCENTILES] = {0.5, 0.99, 0.999, 1.0};
+
+    latency_hist_t*       _aggregate_latency; // merged over all threads at print()
+    latency_hist_t*       _last_cp_latency;   // merged over all threads at the last checkpoint
+    uint64_t              _cp_latency[NUM_LATENCY_STATS][NUM_PERCENTILES]; // window of a checkpoint
     std::vector<stats_t*> _checkpoints;
+    std::vector<std::string> _knob_names;
+    std::vector<double>   _cp_knobs; // window of a checkpoint
     uint32_t              _num_checkpoints;
 };
@@ -11,6 +11,7 @@
 #include "index/twosided/non_partitioned/idx.h"
 #include "index/twosided/partitioned/cache_manager.h"
 #include "index/twosided/non_partitioned/cache_manager.h"
+#include "utils/numa.h"
 
 RC workload_t::init() {
     return RCOK;
@@ -275,6 +276,22 @@ uint32_t workload_t::get_partition_by_node(uint32_t node_id, uint32_t table_id)
     return partition[node_id];
 }
 
+uint64_t workload_t::get_memory_footprint() {
+    uint64_t footprint = 0;
+    for (auto table : _tables)
+        footprint += table->get_memory_footprint();
+    return footprint;
+}
+
+uint32_t workload_t::get_socket_of_loader(uint64_t idx, uint64_t num) {
+    // each loader takes num / g_init_parallelism units, the last one also takes the remainder
+    uint64_t per_thread = num / g_init_parallelism;
+    uint64_t tid = g_init_parallelism - 1;
+    if (per_thread > 0)
+        tid = std::min(idx / per_thread, tid);
+    return numa::get_socket_of(tid, g_init_parallelism);
+}
+
 void workload_t::index_insert(INDEX* index, uint64_t key, value_t value) {
 #if TRANSPORT == ONE_SIDED
     index->insert(key, value);
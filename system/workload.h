@@ -30,10 +30,17 @@ public:
     virtual uint64_t        get_index_key(row_t* row, uint32_t index_id) = 0;
     
     virtual INDEX*          get_index(uint32_t index_id) { return nullptr; }
+    uint32_t                get_num_indexes() { return _indexes.size(); }
     virtual table_t*        get_table(uint32_t table_id) { return nullptr; }
+    // bytes allocated for the rows of all tables on this node
+    uint64_t                get_memory_footprint();
 
     uint32_t                get_partition_by_key(uint64_t key, uint32_t table_id = 0);
     uint32_t                get_partition_by_node(uint32_t node_id, uint32_t table_id = 0);
+    // socket of this memory node that holds the row of an index key (NUMA_AWARE); rows are first
+    // touched by the loader thread that inserted them, so the socket follows the workload's load split.
+    // Returns numa::get_num_sockets() if the key does not tell its row (e.g., a non-unique secondary key)
+    virtual uint32_t        get_socket_by_key(uint64_t key, uint32_t index_id = 0) = 0;
     virtual void            set_partition(uint32_t table_id = 0) = 0;
 
     uint64_t                rpc_alloc_chunk(uint32_t node_id, uint64_t size);
@@ -49,6 +56,8 @@ public:
 protected:
     INDEX*                  create_index(uint32_t index_id);
     void                    index_insert(INDEX* index, uint64_t key, value_t value);
+    // socket of the loader thread that inserted the idx-th of the num load units (keys or warehouses) of this node
+    uint32_t                get_socket_of_loader(uint64_t idx, uint64_t num);
     // tables
     std::vector<table_t*>             _tables;
 
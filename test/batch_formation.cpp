@@ -0,0 +1,98 @@
+#include "system/global.h"
+#include "batch/group.h"
+#include "batch/table.h"
+#include "utils/helper.h"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+// Measures the batch formation latency of a batch group against its size: in every round, each of
+// numMembers threads publishes a request to the same node, and the leader (member 0) claims requests
+// until it holds all of them. The publication list (batch_group_t::claim) is compared with rescanning
+// every slot of the group, as leaders did before.
+enum scheme_t { PUBLICATION_LIST, SLOT_SCAN };
+
+// spins for a while, then lets other threads run (members may outnumber the cores)
+template <typename PRED>
+void wait_until(PRED pred){
+    for(uint32_t i=0; !pred(); i++){
+        if(i < 1000)
+            PAUSE
+        else
+            std::this_thread::yield();
+    }
+}
+
+void collect(scheme_t scheme, batch_group_t& group, uint32_t numMembers, std::vector<std::pair<uint32_t, uint32_t>>& result){
+    for(uint32_t pass=0; result.size() < numMembers; pass++){
+        if(scheme == PUBLICATION_LIST){
+            uint32_t seq = group.get_seq(0);
+            group.claim(0, result);
+            if(result.size() < numMembers)
+                wait_until([&](){ return group.get_seq(0) != seq; });
+        }
+        else{
+            for(uint32_t i=0; i<numMembers; i++){
+                auto& slot = group.get_slot(i, 0);
+                int size = slot.load();
+                if(size > 0 && slot.compare_exchange_strong(size, batch_group_t::CLAIMED))
+                    result.push_back({group.get_member_id(i), static_cast<uint32_t>(size)});
+            }
+            // same backoff as wait_until between two scans
+            if(pass < 1000)
+                PAUSE
+            else
+                std::this_thread::yield();
+        }
+    }
+}
+
+// average latency (in us) from the start of a round until the leader holds the whole batch
+double run(scheme_t scheme, uint32_t numMembers, uint32_t numRounds){
+    batch_group_t group(0);
+    std::atomic<uint32_t> round(0);
+    uint64_t total = 0;
+
+    auto member = [&](uint32_t id){
+        auto& slot = group.get_slot(id, 0);
+        for(uint32_t r=1; r<=numRounds; r++){
+            wait_until([&](){ return round.load() >= r; });
+            group.publish(id, 0, 64);
+            // the leader hands the response over through the own slot
+            wait_until([&](){ return slot.load() == batch_group_t::IDLE; });
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(uint32_t i=1; i<numMembers; i++)
+        threads.push_back(std::thread(member, i));
+
+    std::vector<std::pair<uint32_t, uint32_t>> result;
+    for(uint32_t r=1; r<=numRounds; r++){
+        result.clear();
+        auto start = std::chrono::steady_clock::now();
+        round.store(r);
+        group.publish(0, 0, 64);
+        collect(scheme, group, numMembers, result);
+        total += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        for(auto& entry: result)
+            group.get_slot(entry.first % batch_table_t::MAX_GROUP_SIZE, 0).store(batch_group_t::IDLE);
+    }
+    for(auto& t: threads) t.join();
+    return total / 1000.0 / numRounds;
+}
+
+int main(int argc, char* argv[]){
+    uint32_t numRounds = argc > 1 ? atoi(argv[1]) : 100000;
+    g_num_server_nodes = 1;
+
+    std::cout << "rounds " << numRounds << ", cores " << std::thread::hardware_concurrency() << std::endl;
+    for(uint32_t numMembers=1; numMembers<=batch_table_t::MAX_GROUP_SIZE; numMembers++){
+        double list = run(PUBLICATION_LIST, numMembers, numRounds);
+        double scan = run(SLOT_SCAN, numMembers, numRounds);
+        std::cout << "members " << numMembers << "\tpublication list: " << list << " us\tslot scan: " << scan << " us" << std::endl;
+    }
+    return 0;
+}
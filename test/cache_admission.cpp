@@ -0,0 +1,86 @@
+#include "utils/frequency_sketch.h"
+#include "benchmarks/ycsb/zipf.h"
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <random>
+
+// Replays a zipfian key stream against a model of the compute-side index cache
+// (sampled 2-choice LFU eviction, frequency bumped on 10% of the hits)
+// and reports the hit rate of random admission and of TinyLFU admission.
+struct entry_t {
+    uint64_t key;
+    uint16_t freq;
+};
+
+enum policy_t { RANDOM, TINYLFU };
+
+double run(policy_t policy, int numKeys, int numOps, int cacheSize, double theta, double admissionRate){
+    std::vector<entry_t> entries;
+    std::unordered_map<uint64_t, uint32_t> slots; // key -> position in entries
+    entries.reserve(cacheSize);
+    frequency_sketch_t sketch(cacheSize);
+    std::mt19937_64 rng(0);
+    std::uniform_real_distribution<double> dice(0.0, 1.0);
+    zipf_gen_state state;
+    mehcached_zipf_init(&state, numKeys, theta, 1);
+
+    auto sample = [&](){ return std::uniform_int_distribution<uint32_t>(0, entries.size() - 1)(rng); };
+
+    uint64_t hits = 0;
+    for(int i=0; i<numOps; i++){
+        uint64_t key = mehcached_zipf_next(&state);
+        if(policy == TINYLFU)
+            sketch.increment(key);
+
+        auto it = slots.find(key);
+        if(it != slots.end()){
+            hits++;
+            if(dice(rng) < 0.1)
+                entries[it->second].freq++;
+            continue;
+        }
+
+        if((int)entries.size() < cacheSize){ // warmup, everything is admitted
+            slots[key] = entries.size();
+            entries.push_back({key, 0});
+            continue;
+        }
+
+        uint32_t p1 = sample(), p2 = sample();
+        uint32_t victim = entries[p1].freq < entries[p2].freq ? p1 : p2;
+        bool admit;
+        if(policy == TINYLFU)
+            admit = sketch.estimate(key) > sketch.estimate(entries[victim].key);
+        else
+            admit = dice(rng) < admissionRate;
+        if(!admit)
+            continue;
+
+        slots.erase(entries[victim].key);
+        entries[victim] = {key, 0};
+        slots[key] = victim;
+    }
+    return hits / (double)numOps;
+}
+
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        std::cerr << "Usage: " << argv[0] << " numKeys numOps [cacheSize] [admissionRate]" << std::endl;
+        exit(0);
+    }
+
+    int numKeys = atoi(argv[1]);
+    int numOps = atoi(argv[2]);
+    int cacheSize = argc > 3 ? atoi(argv[3]) : numKeys / 100;
+    double admissionRate = argc > 4 ? atof(argv[4]) : 0.5; // CACHE_ADMISSION_RATE
+
+    double thetas[] = {0.5, 0.7, 0.8, 0.9, 0.99};
+    std::cout << "keys " << numKeys << ", cache entries " << cacheSize << ", random admission rate " << admissionRate << std::endl;
+    for(auto theta: thetas){
+        double random = run(RANDOM, numKeys, numOps, cacheSize, theta, admissionRate);
+        double tinylfu = run(TINYLFU, numKeys, numOps, cacheSize, theta, admissionRate);
+        std::cout << "theta " << theta << "\trandom hit rate: " << random << "\ttinylfu hit rate: " << tinylfu << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "utils/frequency_sketch.h"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <random>
+
+// Hammers a few hot keys of a sketch from many threads and compares every counter with
+// a sketch that recorded the same keys from a single thread: the counters of the hot keys
+// must saturate at 15 and no other counter (e.g., the neighbour of a saturated one) may change.
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        std::cerr << "Usage: " << argv[0] << " numOps numThreads [numKeys]" << std::endl;
+        exit(0);
+    }
+
+    int numOps = atoi(argv[1]);
+    int numThreads = atoi(argv[2]);
+    int numKeys = argc > 3 ? atoi(argv[3]) : 16;
+    // large enough that the hot keys never trigger aging
+    uint64_t capacity = 1024;
+
+    std::vector<uint64_t> keys;
+    std::mt19937_64 rng(0);
+    for(int i=0; i<numKeys; i++)
+        keys.push_back(rng());
+
+    frequency_sketch_t expected(capacity);
+    for(int i=0; i<16; i++)
+        for(auto key: keys)
+            expected.increment(key);
+
+    frequency_sketch_t sketch(capacity);
+    std::vector<std::thread> threads;
+    for(int t=0; t<numThreads; t++){
+        threads.push_back(std::thread([&, t](){
+            int ops = numOps / numThreads;
+            for(int i=0; i<ops; i++)
+                sketch.increment(keys[(i + t) % numKeys]);
+        }));
+    }
+    for(auto& t: threads) t.join();
+
+    uint64_t mismatches = 0;
+    for(uint64_t i=0; i<sketch.get_num_words(); i++){
+        uint64_t word = sketch.get_word(i);
+        uint64_t expected_word = expected.get_word(i);
+        for(uint32_t offset=0; offset<64; offset+=4){
+            if(((word >> offset) & 0xf) != ((expected_word >> offset) & 0xf))
+                mismatches++;
+        }
+    }
+    for(auto key: keys){
+        if(sketch.estimate(key) != 15)
+            mismatches++;
+    }
+
+    std::cout << "keys: " << numKeys << ", threads: " << numThreads << ", ops: " << numOps << std::endl;
+    std::cout << "mismatching counters: " << mismatches << std::endl;
+    if(mismatches){
+        std::cerr << "saturated counters have overflowed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "index/onesided/sherman/IndexCache.h"
+#include "benchmarks/ycsb/zipf.h"
+#include <iostream>
+#include <vector>
+
+// Replays zipfian lookups against the Sherman index cache over a prebuilt tree image: full leaves
+// and internal pages over keys 0..numKeys-1, kept in local memory. A lookup walks the image like
+// Tree::search (level-1 hit: read the leaf; miss: descend from the lowest cached upper-level page,
+// or from the root) and admits every internal page it reads. Reports the level-1 hit rate and the
+// page reads per lookup, which would each be a round trip to the memory server.
+#if !PARTITIONED
+using namespace sherman;
+
+struct image_t {
+    std::vector<std::vector<InternalPage*>> levels; // levels[l][i]: page i of level l (level 0 unused)
+    std::vector<uint64_t> spans;                    // keys below a page of level l
+    int height;                                     // level of the root
+
+    // page i of level l lives at node l+1, offset (i+1) pages
+    static global_addr_t addr_of(int level, uint64_t idx) { return global_addr_t(level + 1, (idx + 1) * kInternalPageSize); }
+    static int level_of(global_addr_t addr) { return addr.node_id - 1; }
+    static uint64_t index_of(global_addr_t addr) { return addr.addr / kInternalPageSize - 1; }
+
+    image_t(uint64_t numKeys){
+        uint64_t fanout = kInternalCardinality;
+        spans.push_back(kLeafCardinality);
+        uint64_t cnt = (numKeys + kLeafCardinality - 1) / kLeafCardinality; // pages of the level below
+        levels.emplace_back();
+        for(int level=1; level==1 || cnt>1; level++){
+            uint64_t span = spans.back() * fanout;
+            uint64_t num = (cnt + fanout - 1) / fanout;
+            levels.emplace_back();
+            for(uint64_t i=0; i<num; i++){
+                std::vector<InternalEntry> entries;
+                for(uint64_t c=i*fanout+1; c<std::min(cnt, (i+1)*fanout); c++){
+                    InternalEntry entry;
+                    entry.key = c * spans.back();
+                    entry.ptr = addr_of(level - 1, c);
+                    entries.push_back(entry);
+                }
+                Key highest = i + 1 < num ? (i + 1) * span : kKeyMax;
+                levels.back().push_back(new InternalPage(i * span, highest, addr_of(level - 1, i * fanout), entries, level));
+            }
+            spans.push_back(span);
+            cnt = num;
+        }
+        height = levels.size() - 1;
+    }
+
+    ~image_t(){
+        for(auto& level: levels)
+            for(auto page: level)
+                delete page;
+    }
+};
+
+// returns the page reads of a lookup
+int lookup(image_t& image, IndexCache& cache, uint64_t key, uint64_t& hits){
+    global_addr_t addr;
+    if(cache.search_from_cache(key, &addr)){
+        hits++;
+        return 1;
+    }
+    int reads = 0;
+    int level = image.height;
+    if(cache.search_upper_from_cache(key, &addr))
+        level = image_t::level_of(addr);
+    for(; level>=1; level--){
+        reads++;
+        cache.add_to_cache(image.levels[level][key / image.spans[level]]);
+    }
+    return reads + 1; // the leaf
+}
+
+void run(image_t& image, uint64_t numKeys, uint64_t numOps, uint64_t cacheSize, double theta){
+    IndexCache cache(0, cacheSize);
+    zipf_gen_state state;
+    mehcached_zipf_init(&state, numKeys, theta, 1);
+    // warms up with as many lookups as measured
+    uint64_t hits = 0, reads = 0;
+    for(uint64_t i=0; i<2*numOps; i++){
+        // scatters the popular keys over the key space (murmur3 finalizer)
+        uint64_t key = mehcached_zipf_next(&state);
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key %= numKeys;
+        if(i == numOps)
+            hits = reads = 0;
+        reads += lookup(image, cache, key, hits);
+    }
+    std::cout << "theta " << theta << "\tlevel-1 hit rate: " << hits / (double)numOps
+              << "\treads per lookup: " << reads / (double)numOps << std::endl;
+}
+
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        std::cerr << "Usage: " << argv[0] << " numKeys numOps [cacheSize (MB)]" << std::endl;
+        exit(0);
+    }
+
+    uint64_t numKeys = atol(argv[1]);
+    uint64_t numOps = atol(argv[2]);
+    uint64_t cacheSize = argc > 3 ? atol(argv[3]) : 1;
+
+    image_t image(numKeys);
+    std::cout << "keys " << numKeys << ", height " << image.height << ", level-1 pages " << image.levels[1].size()
+              << " (" << image.levels[1].size() * kInternalPageSize / (1024 * 1024) << " MB), cache " << cacheSize << " MB" << std::endl;
+    double thetas[] = {0.5, 0.7, 0.8, 0.9, 0.99};
+    for(auto theta: thetas)
+        run(image, numKeys, numOps, cacheSize, theta);
+    return 0;
+}
+#else
+int main(){
+    std::cerr << "the Sherman index cache is built without PARTITIONED" << std::endl;
+    return 0;
+}
+#endif
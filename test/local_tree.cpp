@@ -1,4 +1,5 @@
 #include "index/twosided/btreeolc/tree.h"
+#include "utils/search.h"
 #include <iostream>
 #include <vector>
 #include <thread>
@@ -153,7 +154,20 @@ int main(int argc, char* argv[]){
     tree = new BTree<Value>();
 
     load(numData, numThreads);
+#if SIMD_SEARCH
+    // lookups with the scalar and the SIMD key search of the nodes
+    search::isa_t isas[] = {search::SCALAR, search::AVX2, search::AVX512};
+    for(auto isa: isas){
+        if(search::set_isa(isa) != isa) // not supported by this CPU
+            continue;
+        std::cout << "[" << search::get_isa_name(isa) << " key search]" << std::endl;
+        find(numData, numThreads);
+    }
+#else
+    // the nodes search their keys linearly; set SIMD_SEARCH to compare the SIMD kernels
+    std::cout << "[linear key search, SIMD_SEARCH is compiled out]" << std::endl;
     find(numData, numThreads);
+#endif
     //update(numData, numThreads);
     //remove(numData, numThreads);
     //find(numData, numThreads);
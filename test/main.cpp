@@ -5,6 +5,7 @@
 #include "client/transport.h"
 #include "server/thread.h"
 #include "server/transport.h"
+#include "transport/shm_transport.h"
 #include "utils/options.h"
 #include "txn/table.h"
 #include "utils/debug.h"
@@ -34,16 +35,24 @@ void run() {
     debug::notify_info("Initializing transport ...");
     if (g_is_server) { // server initialization
         assert(g_total_num_threads == g_num_server_threads);
+#if TRANSPORT_BACKEND == SHM
+        transport = new shm_transport_t();
+#else
         transport = new server_transport_t();
-        g_txn_table_size = g_num_client_nodes * g_num_client_threads;
+#endif
+        g_txn_table_size = g_num_client_nodes * g_num_client_qps;
         threads = new thread_t* [g_num_server_threads];
         for (uint32_t i=0; i<g_num_server_threads; i++)
             threads[i] = new server_thread_t(i);
     }
     else { // client initialization
         assert(g_total_num_threads == g_num_client_threads);
+#if TRANSPORT_BACKEND == SHM
+        transport = new shm_transport_t();
+#else
         transport = new client_transport_t();
-        g_txn_table_size = g_num_client_threads;
+#endif
+        g_txn_table_size = g_num_client_qps;
         threads = new thread_t* [g_num_client_threads];
         for (uint32_t i=0; i<g_num_client_threads; i++)
             threads[i] = new client_thread_t(i);
@@ -63,7 +72,11 @@ void run() {
     debug::notify_info("Loading the database ...");
     if (WORKLOAD == YCSB)
         ycsb_query_t::preprocess();
+    uint64_t load_start = get_sys_clock();
     workload->init();
+    if (g_is_server && TRANSPORT == TWO_SIDED)
+        debug::notify_info("Loaded in %.2f sec (row slabs: %lu MB)", (get_sys_clock() - load_start) / 1000000000.0,
+                           workload->get_memory_footprint() / 1024 / 1024);
 
     debug::notify_info("Executing the workload ...");
     // execution
@@ -0,0 +1,105 @@
+#include "index/twosided/btreeolc/tree.h"
+#include "storage/scan.h"
+#include <iostream>
+#include <vector>
+#include <limits>
+
+using Key = uint64_t;
+using Value = uint64_t;
+
+// Range-partitioned keys as in YCSB: node i holds the keys in (bounds[i], bounds[i+1]], each in its own index.
+std::vector<BTree<Value>*> trees;
+std::vector<Key> bounds;
+
+uint32_t get_node(Key key){
+    uint32_t node = 0;
+    while(key > bounds[node + 1])
+        node++;
+    return node;
+}
+
+// what the memory server of a node does for a scan (lock_manager_t::register_scan): visits at most limit rows up to
+// end_key and returns them with the key to resume from
+uint64_t scan_node(uint32_t node, Key key, scan_spec_t spec, std::vector<Key>& rows){
+    std::vector<Value> values(spec.limit);
+    Value* ptr = values.data();
+    Key start = key;
+    int num = trees[node]->scan(start, spec.limit, ptr);
+    uint32_t visited = 0;
+    for(int i=0; i<num; i++){
+        if(values[i] > spec.end_key)
+            break;
+        rows.push_back(values[i]);
+        visited++;
+    }
+    return spec.get_next_key(visited, bounds[node + 1]);
+}
+
+// what the client does (ycsb_stored_procedure_t): resumes the scan on the node of next key until it has count rows;
+// returns the number of nodes visited
+uint32_t scan(Key key, uint32_t count, std::vector<Key>& rows){
+    uint32_t nodes = 0;
+    Key end_key = key + count - 1;
+    while(key != 0 && rows.size() < count){
+        scan_spec_t spec = {end_key, static_cast<uint32_t>(count - rows.size()), 0, 0, scan_spec_t::NONE, 0};
+        key = scan_node(get_node(key), key, spec, rows);
+        nodes++;
+    }
+    return nodes;
+}
+
+// Scans from every key around the partition bounds and checks that each scan returns the keys of its range, also
+// those past the bound of the node it started on.
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        std::cerr << "Usage: " << argv[0] << " numNodes partitionSize [maxCount]" << std::endl;
+        exit(0);
+    }
+
+    uint32_t numNodes = atoi(argv[1]);
+    uint64_t partitionSize = atoi(argv[2]);
+    uint32_t maxCount = argc > 3 ? atoi(argv[3]) : 10;
+    uint64_t tableSize = numNodes * partitionSize;
+
+    bounds.push_back(std::numeric_limits<Key>::min());
+    for(uint32_t i=0; i<numNodes-1; i++)
+        bounds.push_back(partitionSize + bounds[i]);
+    bounds.push_back(std::numeric_limits<Key>::max());
+    for(uint32_t i=0; i<numNodes; i++){
+        trees.push_back(new BTree<Value>());
+        for(Key key=partitionSize*i+1; key<=partitionSize*(i+1); key++)
+            trees[i]->insert(key, key);
+    }
+
+    uint64_t scans = 0, crossing = 0, failures = 0;
+    for(uint32_t i=0; i<numNodes; i++){
+        Key bound = partitionSize * (i + 1);
+        Key from = bound > maxCount ? bound - maxCount : 1;
+        for(Key key=from; key<=bound; key++){
+            for(uint32_t count=1; count<=maxCount; count++){
+                std::vector<Key> rows;
+                uint32_t nodes = scan(key, count, rows);
+                uint64_t expected = std::min<uint64_t>(count, tableSize - key + 1);
+                bool correct = (rows.size() == expected);
+                for(uint32_t j=0; correct && j<rows.size(); j++)
+                    correct = (rows[j] == key + j);
+                if(!correct){
+                    std::cerr << "scan from " << key << " for " << count << " rows returned " << rows.size() << " rows" << std::endl;
+                    failures++;
+                }
+                scans++;
+                if(nodes > 1) crossing++;
+            }
+        }
+    }
+
+    std::cout << "nodes: " << numNodes << ", partition size: " << partitionSize << std::endl;
+    std::cout << "scans: " << scans << " (" << crossing << " across partitions), failures: " << failures << std::endl;
+    for(auto tree: trees)
+        delete tree;
+    if(failures || (numNodes > 1 && crossing == 0)){
+        std::cerr << "scans did not continue on the next partition" << std::endl;
+        return 1;
+    }
+    return 0;
+}
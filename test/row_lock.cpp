@@ -0,0 +1,135 @@
+#include "system/global.h"
+#include "txn/txn.h"
+#include "utils/helper.h"
+#include "concurrency/twosided/nowait.h"
+#include "concurrency/twosided/waitdie.h"
+#include "concurrency/twosided/woundwait.h"
+#include "concurrency/twosided/lockword.h"
+#include <iostream>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <random>
+
+#if TRANSPORT == TWO_SIDED
+using namespace twosided;
+
+// a txn that only acquires and releases row locks
+class bench_txn_t : public txn_t {
+public:
+    bench_txn_t(uint32_t tid): txn_t(txn_id_t(0, tid)) { }
+    RC execute() { return RCOK; }
+    RC process_request() { return RCOK; }
+};
+
+// holders of a row, checked while the lock is held
+struct holders_t {
+    std::atomic<int> readers{0};
+    std::atomic<int> writers{0};
+};
+
+// returns the number of mutual exclusion violations
+template <typename LOCK>
+uint64_t run(const char* name, int numOps, int numThreads, int numRows, double readRatio){
+    auto locks = new LOCK[numRows];
+    auto holders = new holders_t[numRows];
+    std::vector<uint64_t> aborts(numThreads, 0);
+    std::atomic<uint64_t> violations(0);
+    auto func = [&](int tid){
+        bench_txn_t txn(tid);
+        std::mt19937_64 rng(tid + 1);
+        std::uniform_int_distribution<int> row(0, numRows - 1);
+        std::uniform_real_distribution<double> dice(0.0, 1.0);
+        int ops = numOps / numThreads;
+        for(int i=0; i<ops; i++){
+            int r = row(rng);
+            auto lock = &locks[r];
+            auto type = dice(rng) < readRatio ? LOCK_SH : LOCK_EX;
+            txn.set_ts(get_priority());
+            txn.set_state(txn_t::RUNNING);
+            RC rc = lock->lock_get(type, &txn);
+            if(rc == WAIT){ // the lock is handed over by the owner on release
+                while(txn.get_state() == txn_t::WAITING)
+                    std::this_thread::yield();
+                if(txn.get_state() == txn_t::ABORTING)
+                    rc = ABORT;
+            }
+            if(rc == ABORT || txn.get_state() == txn_t::ABORTING)
+                aborts[tid]++;
+            else{ // granted: EX excludes everyone, SH excludes writers
+                auto& h = holders[r];
+                if(type == LOCK_EX){
+                    if(h.writers.fetch_add(1) != 0 || h.readers.load() != 0)
+                        violations++;
+                    std::this_thread::yield();
+                    h.writers.fetch_sub(1);
+                }
+                else{
+                    h.readers.fetch_add(1);
+                    if(h.writers.load() != 0)
+                        violations++;
+                    std::this_thread::yield();
+                    h.readers.fetch_sub(1);
+                }
+            }
+            lock->lock_release(type, &txn);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(int i=0; i<numThreads; i++)
+        threads.push_back(std::thread(func, i));
+    for(auto& t: threads) t.join();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    uint64_t abort_cnt = 0;
+    for(int i=0; i<numThreads; i++)
+        abort_cnt += aborts[i];
+
+    uint64_t elapsed = end.tv_nsec - start.tv_nsec + (end.tv_sec - start.tv_sec)*1000000000;
+    std::cout << name << " (read ratio " << readRatio << ")" << std::endl;
+    std::cout << "elapsed time: " << elapsed/1000000000.0 << " sec" << std::endl;
+    std::cout << "throughput: " << numOps / (double)(elapsed/1000000000.0) / 1000000 << " mops/sec" << std::endl;
+    std::cout << "abort rate: " << abort_cnt / (double)numOps << std::endl;
+    if(violations)
+        std::cout << "mutual exclusion violations: " << violations << std::endl;
+    delete[] holders;
+    delete[] locks;
+    return violations;
+}
+
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        std::cerr << "Usage: " << argv[0] << " numOps numThreads [numRows]" << std::endl;
+        exit(0);
+    }
+
+    int numOps = atoi(argv[1]);
+    int numThreads = atoi(argv[2]);
+    int numRows = argc > 3 ? atoi(argv[3]) : 16;
+    g_is_server = true;
+
+    uint64_t violations = 0;
+    double readRatios[] = {1.0, 0.9, 0.5, 0.0};
+    for(auto ratio: readRatios){
+        violations += run<nowait_t>("nowait_t", numOps, numThreads, numRows, ratio);
+        violations += run<lockword_t<NO_WAIT>>("lockword_t<NO_WAIT>", numOps, numThreads, numRows, ratio);
+        violations += run<waitdie_t>("waitdie_t", numOps, numThreads, numRows, ratio);
+        violations += run<lockword_t<WAIT_DIE>>("lockword_t<WAIT_DIE>", numOps, numThreads, numRows, ratio);
+        violations += run<woundwait_t>("woundwait_t", numOps, numThreads, numRows, ratio);
+        violations += run<lockword_t<WOUND_WAIT>>("lockword_t<WOUND_WAIT>", numOps, numThreads, numRows, ratio);
+    }
+    if(violations){
+        std::cerr << "row locks are not mutually exclusive" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+#else
+int main(int argc, char* argv[]){
+    std::cerr << "row lock managers are only used with TWO_SIDED transport" << std::endl;
+    return 0;
+}
+#endif
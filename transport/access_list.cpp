@@ -0,0 +1,57 @@
+#include "transport/access_list.h"
+#include <algorithm>
+
+void access_list_t::encode(std::vector<cc_manager_t::RowAccess*>& accesses, UnstructuredBuffer& buffer, uint32_t flags) {
+    // stable: accesses of a txn to the same key keep their order
+    std::stable_sort(accesses.begin(), accesses.end(), [](cc_manager_t::RowAccess* a, cc_manager_t::RowAccess* b) {
+        if (a->index_id != b->index_id) return a->index_id < b->index_id;
+        if (a->table_id != b->table_id) return a->table_id < b->table_id;
+        return a->key < b->key;
+    });
+
+    uint32_t num = accesses.size() | COMPACT | flags;
+    buffer.put(&num);
+    for (uint32_t begin=0, end=0; begin<accesses.size(); begin=end) {
+        auto first = accesses[begin];
+        end = begin + 1;
+        while (end < accesses.size() && accesses[end]->index_id == first->index_id && accesses[end]->table_id == first->table_id)
+            end++;
+        buffer.put_varint(end - begin);
+        buffer.put_varint(first->index_id);
+        buffer.put_varint(first->table_id);
+
+        uint64_t prev_key = 0;
+        for (uint32_t i=begin; i<end; i++) {
+            auto access = accesses[i];
+            uint8_t flags = access->type;
+#if PARTITIONED
+            assert(access->cache <= CACHE_MASK);
+            flags |= access->cache << CACHE_SHIFT;
+            if (access->value.val != 0)
+                flags |= HAS_VALUE;
+#else
+            if (access->scan)
+                flags |= HAS_SCAN;
+            else
+                flags |= std::min<uint64_t>(access->cache, CACHE_HINT) << CACHE_SHIFT;
+#endif
+            buffer.put(&flags);
+            buffer.put_varint(access->key - prev_key);
+            prev_key = access->key;
+#if PARTITIONED
+            if (flags & HAS_VALUE)
+                buffer.put_varint(access->value.val);
+            if (access->cache == 2) { // cache admission + eviction
+                auto evict = reinterpret_cast<cc_manager_t::EvictTuple*>(access->cache_data);
+                buffer.put_varint(evict->key);
+                buffer.put_varint(evict->value);
+            }
+#else
+            if (access->scan)
+                *buffer.put_ptr<scan_spec_t>() = *access->scan;
+            else if (access->cache >= CACHE_HINT)
+                buffer.put_varint(access->cache);
+#endif
+        }
+    }
+}
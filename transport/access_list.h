@@ -0,0 +1,96 @@
+#pragma once
+
+#include "system/global.h"
+#include "system/cc_manager.h"
+#include "transport/message.h"
+#include "utils/packetize.h"
+#include "storage/scan.h"
+#include <vector>
+
+// Compact encoding of the access list of a request (COMPACT_ACCESS_LIST).
+// Accesses are sorted by (index_id, table_id, key) and grouped by index and table; a group shares one header
+// and its keys are delta-coded varints. Access type and cache hint are bit-packed into one byte per access.
+//   [ num | COMPACT ] ( [ count | index_id | table_id ] ( flags | key delta | hint | value | evict key | evict value | scan spec ) * count ) *
+// All integers are varints; the fields after the key delta are present depending on the flags. The fixed-size
+// tuples of cc_manager_t remain the default format, and the receiver tells the two apart by the COMPACT bit of
+// the access count.
+class access_list_t {
+public:
+    // flags in the access count of a request
+    static constexpr uint32_t COMPACT    = 1u << 31;
+    static constexpr uint32_t SNAPSHOT   = 1u << 30; // read-only txn reading a snapshot (SNAPSHOT_READ)
+    static constexpr uint32_t COUNT_MASK = SNAPSHOT - 1;
+
+    struct entry_t {
+        access_t type;
+        uint64_t key;
+        uint32_t index_id;
+        uint32_t table_id;
+        uint64_t cache;        // cache hint (lock manager) or cache operation (index manager)
+        uint64_t value;        // index manager
+        uint64_t evict_key;    // index manager, cache operation 2
+        uint64_t evict_value;
+        scan_spec_t* scan;     // lock manager, range scan (points into the buffer)
+    };
+
+    // whether requests of this type are sent compactly
+    static bool is_compact(message_t::type_t type) { return (COMPACT_ACCESS_LIST >> type) & 1; }
+
+    // encodes the accesses after sorting them; the server answers in the sorted order
+    static void encode(std::vector<cc_manager_t::RowAccess*>& accesses, UnstructuredBuffer& buffer, uint32_t flags=0);
+
+    // decodes num accesses (the count without flags) and passes each to func, in the encoded order
+    template <typename FUNC>
+    static void decode(uint32_t num, UnstructuredBuffer& buffer, FUNC func);
+
+private:
+    // flags: [ scan (1) | value (1) | cache (2) | access type (3) ]
+    static constexpr uint8_t TYPE_BITS   = 3;
+    static constexpr uint8_t TYPE_MASK   = (1 << TYPE_BITS) - 1;
+    static constexpr uint8_t CACHE_SHIFT = TYPE_BITS;
+    static constexpr uint8_t CACHE_MASK  = 0x3;
+    static constexpr uint8_t CACHE_HINT  = 2;  // lock manager: a cache hint other than 0 or 1 follows
+    static constexpr uint8_t HAS_VALUE   = 1 << 5;
+    static constexpr uint8_t HAS_SCAN    = 1 << 6; // lock manager: a scan_spec_t follows, the cache field is RANGE
+    static_assert(INDEX_CACHE <= TYPE_MASK, "access types are packed into 3 bits");
+};
+
+template <typename FUNC>
+void access_list_t::decode(uint32_t num, UnstructuredBuffer& buffer, FUNC func) {
+    entry_t entry;
+    while (num > 0) {
+        uint32_t count = buffer.get_varint();
+        entry.index_id = buffer.get_varint();
+        entry.table_id = buffer.get_varint();
+        entry.key = 0;
+        assert(count > 0 && count <= num);
+        num -= count;
+        for (uint32_t i=0; i<count; i++) {
+            uint8_t flags = 0;
+            buffer.get(&flags);
+            entry.type = static_cast<access_t>(flags & TYPE_MASK);
+            entry.key += buffer.get_varint();
+            entry.cache = (flags >> CACHE_SHIFT) & CACHE_MASK;
+#if PARTITIONED
+            entry.value = (flags & HAS_VALUE) ? buffer.get_varint() : 0;
+            if (entry.cache == 2) { // cache admission + eviction
+                entry.evict_key = buffer.get_varint();
+                entry.evict_value = buffer.get_varint();
+            }
+            else
+                entry.evict_key = entry.evict_value = 0;
+            entry.scan = nullptr;
+#else
+            if (entry.cache == CACHE_HINT)
+                entry.cache = buffer.get_varint();
+            entry.value = entry.evict_key = entry.evict_value = 0;
+            entry.scan = nullptr;
+            if (flags & HAS_SCAN) {
+                entry.cache = scan_spec_t::RANGE;
+                entry.scan = buffer.get_ptr<scan_spec_t>();
+            }
+#endif
+            func(entry);
+        }
+    }
+}
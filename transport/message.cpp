@@ -3,9 +3,9 @@
 #include "utils/helper.h"
 #include "system/manager.h"
 
-message_t::message_t(): _type(ACK),_node_id(g_node_id), _qp_id(GET_THD_ID), _data_size(0) { }
-message_t::message_t(type_t type): _type(type), _node_id(g_node_id), _qp_id(GET_THD_ID), _data_size(0) { }
-message_t::message_t(type_t type, uint32_t data_size): _type(type), _node_id(g_node_id), _qp_id(GET_THD_ID), _data_size(data_size) { }
+message_t::message_t(): _type(ACK),_node_id(g_node_id), _qp_id(GET_QP_ID), _data_size(0) { }
+message_t::message_t(type_t type): _type(type), _node_id(g_node_id), _qp_id(GET_QP_ID), _data_size(0) { }
+message_t::message_t(type_t type, uint32_t data_size): _type(type), _node_id(g_node_id), _qp_id(GET_QP_ID), _data_size(data_size) { }
 message_t::message_t(type_t type, uint32_t qp_id, uint32_t data_size): _type(type), _node_id(g_node_id), _qp_id(qp_id), _data_size(data_size) { }
 message_t::message_t(type_t type, uint32_t qp_id, uint32_t data_size, char* data): _type(type), _node_id(g_node_id), _qp_id(qp_id), _data_size(data_size) { 
     _data = new char[_data_size];
@@ -0,0 +1,615 @@
+#include "transport/shm_transport.h"
+
+#if TRANSPORT_BACKEND == SHM
+
+#include "transport/message.h"
+#include "system/manager.h"
+#include "system/memory_allocator.h"
+#include "system/cache_allocator.h"
+#include "system/memory_region.h"
+#include "system/workload.h"
+#include "utils/helper.h"
+#include "batch/table.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SHM_MAGIC 0x4c4f5455534d454dULL
+#define SHM_HEADER_SIZE 4096
+
+shm_transport_t::shm_transport_t()
+    : transport_t() {
+    if (!init()) {
+        // the failing step has reported its cause
+        debug::notify_error("Failed to set up the shared-memory transport of %s node %u",
+                            g_is_server ? "memory" : "compute", g_node_id);
+        exit(EXIT_FAILURE);
+    }
+
+    // all the setup is complete, prepost RECVs for all remote nodes
+    for (uint32_t i=0; i<g_num_nodes; i++) {
+        for (uint32_t j=0; j<g_num_client_qps; j++) {
+            auto recv_ptr = get_recv_buffer(i, j);
+            post_recv(recv_ptr, i, j, MAX_MESSAGE_SIZE);
+        }
+        for (uint32_t j=0; j<g_num_batch_threads; j++) {
+            auto recv_ptr = get_recv_batch_buffer(i, j);
+            post_recv_batch(recv_ptr, i, j, MAX_MESSAGE_SIZE * batch_table_t::MAX_GROUP_SIZE);
+        }
+    }
+
+#if TRANSPORT == ONE_SIDED
+    if (!g_is_server) {
+        g_cache_allocators = new cache_allocator_t*[g_num_server_nodes];
+        for (uint32_t i=0; i<g_num_server_nodes; i++)
+            g_cache_allocators[i] = new cache_allocator_t();
+    }
+#endif
+}
+
+shm_transport_t::~shm_transport_t() {
+    cleanup();
+}
+
+bool shm_transport_t::init() {
+    // node ids cannot be derived from the hostname as all nodes share the same host
+    // g_node_id is given as a command line option instead
+    assert(g_node_id != (uint32_t)-1);
+    if (g_is_server) {
+        assert(g_node_id < g_num_server_nodes);
+        g_num_nodes = g_num_client_nodes;
+    }
+    else {
+        assert(g_node_id < g_num_client_nodes);
+        g_num_nodes = g_num_server_nodes;
+    }
+    printf("NodeID: %u, \tTransport: shared-memory loopback\n", g_node_id);
+    global_manager->set_node_id(g_node_id);
+
+    // no TCP connections and no RDMA device
+    _sockets = nullptr;
+    _send_buffer = nullptr;
+    _recv_buffer = nullptr;
+    _recv_buffer_lower = nullptr;
+    _recv_buffer_upper = nullptr;
+    _meta = nullptr;
+    memset(&_context, 0, sizeof(struct rdma_ctx));
+
+    _segments = nullptr;
+    _mr_bases = nullptr;
+    _remote_mr_bases = nullptr;
+    _mr_size = 0;
+
+    if (!init_buffers())
+        return cleanup();
+
+    const char* prefix = getenv("SHM_PREFIX");
+    _name_prefix = std::string("/") + (prefix ? prefix : "lotus");
+
+    _segments = new char*[g_num_server_nodes];
+    _mr_bases = new char*[g_num_server_nodes];
+    _remote_mr_bases = new uint64_t[g_num_server_nodes];
+    memset(_segments, 0, sizeof(char*) * g_num_server_nodes);
+    memset(_mr_bases, 0, sizeof(char*) * g_num_server_nodes);
+    memset(_remote_mr_bases, 0, sizeof(uint64_t) * g_num_server_nodes);
+
+    if (g_is_server)
+        return create_segment();
+
+    for (uint32_t i=0; i<g_num_server_nodes; i++) {
+        if (!attach_segment(i))
+            return cleanup();
+    }
+    printf("Client attached to %d server nodes ...\n", g_num_server_nodes);
+    return true;
+}
+
+bool shm_transport_t::cleanup() {
+    if (_segments) {
+        for (uint32_t i=0; i<g_num_server_nodes; i++) {
+            if (_segments[i]) munmap(_segments[i], segment_size());
+            if (_mr_bases[i]) munmap(_mr_bases[i], _mr_size);
+        }
+        if (g_is_server) {
+            shm_unlink((_name_prefix + "_" + std::to_string(g_node_id)).c_str());
+            shm_unlink((_name_prefix + "_mr_" + std::to_string(g_node_id)).c_str());
+        }
+        delete[] _segments;
+        delete[] _mr_bases;
+        delete[] _remote_mr_bases;
+        _segments = nullptr;
+        _mr_bases = nullptr;
+        _remote_mr_bases = nullptr;
+    }
+    return transport_t::cleanup();
+}
+
+char* shm_transport_t::map_segment(const std::string& name, uint64_t size, bool create) {
+    int fd = -1;
+    if (create) {
+        shm_unlink(name.c_str()); // remove leftovers of a previous run
+        fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0666);
+        if (fd < 0 || ftruncate(fd, size) != 0) {
+            debug::notify_error("Failed to create shared memory segment %s: %s", name.c_str(), strerror(errno));
+            if (fd >= 0) ::close(fd);
+            return nullptr;
+        }
+    }
+    else {
+        // the memory node may not be up yet
+        struct stat st;
+        do {
+            fd = shm_open(name.c_str(), O_RDWR, 0666);
+            if (fd < 0) { usleep(1000); continue; }
+            do {
+                fstat(fd, &st);
+                PAUSE
+            } while ((uint64_t)st.st_size < size);
+        } while (fd < 0);
+    }
+
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        debug::notify_error("Failed to mmap shared memory segment %s: %s", name.c_str(), strerror(errno));
+        return nullptr;
+    }
+    return reinterpret_cast<char*>(addr);
+}
+
+bool shm_transport_t::create_segment() {
+    char* base = map_segment(_name_prefix + "_" + std::to_string(g_node_id), segment_size(), true);
+    if (!base) return cleanup();
+    _segments[g_node_id] = base;
+
+    auto header = reinterpret_cast<segment_header_t*>(base);
+    header->num_client_nodes = g_num_client_nodes;
+    header->num_client_qps = g_num_client_qps;
+    header->num_batch_threads = g_num_batch_threads;
+    header->mr_base = 0;
+    header->mr_size = 0;
+
+#if TRANSPORT == ONE_SIDED
+    // emulate the registered region for one-sided RDMA
+    _mr_size = MR_SIZE;
+    char* alloc_base = map_segment(_name_prefix + "_mr_" + std::to_string(g_node_id), _mr_size, true);
+    if (!alloc_base) return cleanup();
+    _mr_bases[g_node_id] = alloc_base;
+    _remote_mr_bases[g_node_id] = reinterpret_cast<uint64_t>(alloc_base);
+    header->mr_base = reinterpret_cast<uint64_t>(alloc_base);
+    header->mr_size = _mr_size;
+
+    uint32_t num_indexes = 10 ; // hardcoded, same as server_transport_t
+    for (uint32_t i=0; i<num_indexes; i++) {
+        uint64_t* idx_root_ptr = reinterpret_cast<uint64_t*>(alloc_base + sizeof(global_addr_t) * i);
+        *idx_root_ptr = 0;
+        GET_WORKLOAD->set_index_root(reinterpret_cast<uint64_t>(idx_root_ptr), i);
+        printf("index %u root ptr: %lu\n", i, reinterpret_cast<uint64_t>(idx_root_ptr));
+    }
+    // init memory allocator for one-sided RDMA access
+    uint64_t base_addr = reinterpret_cast<uint64_t>(alloc_base + sizeof(global_addr_t) * num_indexes);
+    uint64_t base_size = _mr_size - (sizeof(global_addr_t) * num_indexes);
+    g_memory_allocator = new memory_allocator_t(base_addr, base_size);
+#endif // end of ONE_SIDED
+
+    header->magic.store(SHM_MAGIC, std::memory_order_release);
+    printf("Server exported shared memory segment %s ...\n", (_name_prefix + "_" + std::to_string(g_node_id)).c_str());
+    return true;
+}
+
+bool shm_transport_t::attach_segment(uint32_t server_id) {
+    char* base = map_segment(_name_prefix + "_" + std::to_string(server_id), segment_size(), false);
+    if (!base) return false;
+    _segments[server_id] = base;
+
+    auto header = reinterpret_cast<segment_header_t*>(base);
+    while (header->magic.load(std::memory_order_acquire) != SHM_MAGIC)
+        PAUSE
+    if (header->num_client_nodes != g_num_client_nodes ||
+        header->num_client_qps != g_num_client_qps ||
+        header->num_batch_threads != g_num_batch_threads) {
+        debug::notify_error("Configuration mismatch with server %u (client QPs %u vs %u)",
+                            server_id, header->num_client_qps, g_num_client_qps);
+        return false;
+    }
+
+    if (header->mr_size) {
+        _mr_size = header->mr_size;
+        _mr_bases[server_id] = map_segment(_name_prefix + "_mr_" + std::to_string(server_id), _mr_size, false);
+        if (!_mr_bases[server_id]) return false;
+        _remote_mr_bases[server_id] = header->mr_base;
+    }
+
+    // the last client to attach removes the names; the mappings stay valid
+    if (header->num_attached.fetch_add(1) + 1 == g_num_client_nodes) {
+        shm_unlink((_name_prefix + "_" + std::to_string(server_id)).c_str());
+        shm_unlink((_name_prefix + "_mr_" + std::to_string(server_id)).c_str());
+    }
+    return true;
+}
+
+uint64_t shm_transport_t::channel_size(bool batch) {
+    uint64_t slot_size = batch ? MAX_MESSAGE_SIZE * batch_table_t::MAX_GROUP_SIZE : MAX_MESSAGE_SIZE;
+    uint64_t header_size = (sizeof(channel_t) + 63) & ~63ULL;
+    return header_size + slot_size * RING_DEPTH;
+}
+
+uint64_t shm_transport_t::segment_size() {
+    //// segment layout
+    ////// [ header | device memory | (request, response) * g_num_client_qps * g_num_client_nodes | batch channels ]
+    uint64_t regular_size = channel_size(false) * 2 * g_num_client_qps * g_num_client_nodes;
+    uint64_t batch_size = channel_size(true) * 2 * g_num_batch_threads * g_num_client_nodes;
+    return SHM_HEADER_SIZE + DEVICE_MEMORY_SIZE + regular_size + batch_size;
+}
+
+shm_transport_t::channel_t* shm_transport_t::get_channel(uint32_t server_id, uint32_t client_id, uint32_t qp_id, bool batch, bool response) {
+    char* base = _segments[server_id] + SHM_HEADER_SIZE + DEVICE_MEMORY_SIZE;
+    uint64_t idx;
+    if (batch) {
+        base += channel_size(false) * 2 * g_num_client_qps * g_num_client_nodes;
+        idx = (client_id * g_num_batch_threads + qp_id) * 2 + response;
+    }
+    else
+        idx = (client_id * g_num_client_qps + qp_id) * 2 + response;
+    return reinterpret_cast<channel_t*>(base + idx * channel_size(batch));
+}
+
+char* shm_transport_t::get_slot(channel_t* chan, uint64_t idx, bool batch) {
+    uint64_t slot_size = batch ? MAX_MESSAGE_SIZE * batch_table_t::MAX_GROUP_SIZE : MAX_MESSAGE_SIZE;
+    uint64_t header_size = (sizeof(channel_t) + 63) & ~63ULL;
+    return reinterpret_cast<char*>(chan) + header_size + (idx % RING_DEPTH) * slot_size;
+}
+
+// publish a receive buffer; receives are consumed in the order they were posted
+void shm_transport_t::post_channel(channel_t* chan, char* ptr, uint32_t size, uint64_t wr_id) {
+    uint64_t idx = chan->posted.fetch_add(1);
+    assert(idx - chan->tail.load(std::memory_order_acquire) < RING_DEPTH);
+    chan->descs[idx % RING_DEPTH] = recv_desc_t{ptr, size, wr_id};
+    while (chan->credits.load(std::memory_order_acquire) != idx)
+        PAUSE
+    chan->credits.store(idx + 1, std::memory_order_release);
+}
+
+void shm_transport_t::send_channel(channel_t* chan, char* ptr, uint32_t size, bool batch) {
+    uint32_t unlocked = 0;
+    while (!chan->send_latch.compare_exchange_weak(unlocked, 1, std::memory_order_acquire)) {
+        unlocked = 0;
+        PAUSE
+    }
+
+    uint64_t head = chan->head.load(std::memory_order_relaxed);
+    // wait for a posted receive and a free slot
+    while (head >= chan->credits.load(std::memory_order_acquire) ||
+           head - chan->tail.load(std::memory_order_acquire) >= RING_DEPTH)
+        PAUSE
+
+    memcpy(get_slot(chan, head, batch), ptr, size);
+    chan->sizes[head % RING_DEPTH] = size;
+    chan->head.store(head + 1, std::memory_order_release);
+    chan->send_latch.store(0, std::memory_order_release);
+}
+
+int shm_transport_t::poll_channel(channel_t* chan, struct ibv_wc* wc, bool batch) {
+    uint64_t tail = chan->tail.load(std::memory_order_relaxed);
+    if (tail >= chan->head.load(std::memory_order_acquire))
+        return 0;
+
+    // the shared recv CQ of the memory node is polled by all server threads
+    uint32_t unlocked = 0;
+    if (!chan->recv_latch.compare_exchange_strong(unlocked, 1, std::memory_order_acquire))
+        return 0;
+    tail = chan->tail.load(std::memory_order_relaxed);
+    if (tail >= chan->head.load(std::memory_order_acquire)) {
+        chan->recv_latch.store(0, std::memory_order_release);
+        return 0;
+    }
+
+    auto& desc = chan->descs[tail % RING_DEPTH];
+    uint32_t size = chan->sizes[tail % RING_DEPTH];
+    assert(size <= desc.size);
+    memcpy(desc.ptr, get_slot(chan, tail, batch), size);
+
+    memset(wc, 0, sizeof(struct ibv_wc));
+    wc->wr_id = desc.wr_id;
+    wc->status = IBV_WC_SUCCESS;
+    wc->opcode = IBV_WC_RECV;
+    wc->byte_len = size;
+
+    chan->tail.store(tail + 1, std::memory_order_release);
+    chan->recv_latch.store(0, std::memory_order_release);
+    return 1;
+}
+
+int shm_transport_t::poll_once(struct ibv_wc* wc, int num) {
+    int cnt = 0;
+    if (g_is_server) {
+        // scan all client channels, starting from a per-thread cursor to spread contention
+        static thread_local uint32_t cursor = 0;
+        uint32_t num_regular = g_num_client_nodes * g_num_client_qps;
+        uint32_t num_channels = num_regular + g_num_client_nodes * g_num_batch_threads;
+        for (uint32_t i=0; i<num_channels && cnt<num; i++) {
+            uint32_t idx = (cursor + i) % num_channels;
+            if (idx < num_regular)
+                cnt += poll_channel(get_channel(g_node_id, idx / g_num_client_qps, idx % g_num_client_qps, false, false), &wc[cnt], false);
+            else {
+                idx -= num_regular;
+                cnt += poll_channel(get_channel(g_node_id, idx / g_num_batch_threads, idx % g_num_batch_threads, true, false), &wc[cnt], true);
+            }
+        }
+        cursor++;
+        return cnt;
+    }
+
+    uint32_t qp_id = GET_QP_ID;
+    for (uint32_t i=0; i<g_num_server_nodes && cnt<num; i++)
+        cnt += poll_channel(get_channel(i, g_node_id, qp_id, false, true), &wc[cnt], false);
+    uint32_t recv_size = 0;
+    for (int i=0; i<cnt; i++)
+        recv_size += wc[i].byte_len;
+    INC_INT_STATS(bytes_received, recv_size);
+    traffic_response += recv_size;
+    return cnt;
+}
+
+int shm_transport_t::poll(struct ibv_wc* wc, int num) {
+    if (g_is_server)
+        return poll_once(wc, num);
+
+    int total = 0;
+    while (total < num)
+        total += poll_once(wc + total, num - total);
+    return total;
+}
+
+void shm_transport_t::post_recv(char* ptr, uint32_t node_id, uint32_t size) {
+    assert(!g_is_server);
+    post_recv(ptr, node_id, GET_QP_ID, size);
+}
+
+void shm_transport_t::post_recv(char* ptr, uint32_t node_id, uint32_t qp_id, uint32_t size) {
+    if (g_is_server)
+        post_channel(get_channel(g_node_id, node_id, qp_id, false, false), ptr, size, serialize_node_info(node_id, qp_id));
+    else
+        post_channel(get_channel(node_id, g_node_id, qp_id, false, true), ptr, size, node_id);
+}
+
+void shm_transport_t::recv(char* ptr, uint32_t node_id, uint32_t size) {
+    assert(!g_is_server);
+    struct ibv_wc wc;
+    auto chan = get_channel(node_id, g_node_id, GET_QP_ID, false, true);
+    post_channel(chan, ptr, size, node_id);
+    while (poll_channel(chan, &wc, false) == 0)
+        PAUSE
+    INC_INT_STATS(bytes_received, wc.byte_len);
+    traffic_response += wc.byte_len;
+}
+
+void shm_transport_t::send(char* ptr, uint32_t node_id, uint32_t size, bool signaled) {
+    assert(!g_is_server);
+    send_channel(get_channel(node_id, g_node_id, GET_QP_ID, false, false), ptr, size, false);
+    INC_INT_STATS(bytes_sent, size);
+    traffic_request += size;
+}
+
+void shm_transport_t::send(char* ptr, uint32_t node_id, uint32_t qp_id, uint32_t size, bool signaled) {
+    assert(g_is_server);
+    send_channel(get_channel(g_node_id, node_id, qp_id, false, true), ptr, size, false);
+}
+
+int shm_transport_t::poll_once_batch(struct ibv_wc* wc, int num) {
+    assert(!g_is_server);
+    int cnt = 0;
+    uint32_t qp_id = GET_THD_ID / batch_table_t::MAX_GROUP_SIZE;
+    for (uint32_t i=0; i<g_num_server_nodes && cnt<num; i++)
+        cnt += poll_channel(get_channel(i, g_node_id, qp_id, true, true), &wc[cnt], true);
+    uint32_t recv_size = 0;
+    for (int i=0; i<cnt; i++)
+        recv_size += wc[i].byte_len;
+    INC_INT_STATS(bytes_received, recv_size);
+    traffic_response += recv_size;
+    return cnt;
+}
+
+int shm_transport_t::poll_batch(struct ibv_wc* wc, int num) {
+    int total = 0;
+    while (total < num)
+        total += poll_once_batch(wc + total, num - total);
+    return total;
+}
+
+void shm_transport_t::post_recv_batch(char* ptr, uint32_t node_id, uint32_t size) {
+    assert(!g_is_server);
+    post_recv_batch(ptr, node_id, GET_THD_ID / batch_table_t::MAX_GROUP_SIZE, size);
+}
+
+void shm_transport_t::post_recv_batch(char* ptr, uint32_t node_id, uint32_t qp_id, uint32_t size) {
+    if (g_is_server)
+        post_channel(get_channel(g_node_id, node_id, qp_id, true, false), ptr, size, serialize_node_info(node_id, qp_id + g_num_client_qps));
+    else
+        post_channel(get_channel(node_id, g_node_id, qp_id, true, true), ptr, size, serialize_node_info(node_id, qp_id));
+}
+
+void shm_transport_t::recv_batch(char* ptr, uint32_t node_id, uint32_t size) {
+    assert(!g_is_server);
+    struct ibv_wc wc;
+    auto chan = get_channel(node_id, g_node_id, GET_THD_ID / batch_table_t::MAX_GROUP_SIZE, true, true);
+    post_channel(chan, ptr, size, serialize_node_info(node_id, GET_THD_ID / batch_table_t::MAX_GROUP_SIZE));
+    while (poll_channel(chan, &wc, true) == 0)
+        PAUSE
+    INC_INT_STATS(bytes_received, wc.byte_len);
+    traffic_response += wc.byte_len;
+}
+
+void shm_transport_t::send_batch(char* ptr, uint32_t node_id, uint32_t size, bool signaled) {
+    assert(!g_is_server);
+    send_channel(get_channel(node_id, g_node_id, GET_THD_ID / batch_table_t::MAX_GROUP_SIZE, true, false), ptr, size, true);
+    INC_INT_STATS(bytes_sent, size);
+    traffic_request += size;
+}
+
+void shm_transport_t::send_batch(char* ptr, uint32_t node_id, uint32_t qp_id, uint32_t size, bool signaled) {
+    assert(g_is_server);
+    send_channel(get_channel(g_node_id, node_id, qp_id, true, true), ptr, size, true);
+}
+
+char* shm_transport_t::get_remote_ptr(global_addr_t addr) {
+    assert(_mr_bases[addr.node_id] != nullptr);
+    uint64_t offset = addr.addr - _remote_mr_bases[addr.node_id];
+    assert(offset < _mr_size);
+    return _mr_bases[addr.node_id] + offset;
+}
+
+char* shm_transport_t::get_remote_dm_ptr(global_addr_t addr) {
+    // device memory is zero-based, addresses are offsets from g_lock_start_addr
+    uint64_t offset = addr.addr;
+    assert(offset < DEVICE_MEMORY_SIZE);
+    return _segments[addr.node_id] + SHM_HEADER_SIZE + offset;
+}
+
+// emulates masked fetch-and-add: carries do not propagate across field boundaries
+static uint64_t add_bounded(uint64_t val, uint64_t add, uint64_t boundary) {
+    uint64_t ret = 0;
+    uint32_t lo = 0;
+    for (uint32_t hi=0; hi<64; hi++) {
+        if (!((boundary >> hi) & 1) && hi != 63)
+            continue;
+        uint32_t width = hi - lo + 1;
+        uint64_t mask = width == 64 ? ~0ULL : ((1ULL << width) - 1);
+        ret |= ((((val >> lo) & mask) + ((add >> lo) & mask)) & mask) << lo;
+        lo = hi + 1;
+    }
+    return ret;
+}
+
+static bool shm_cas(char* src, char* dest, uint64_t cmp, uint64_t swap, uint32_t size) {
+    assert(size <= sizeof(uint64_t));
+    uint64_t expected = cmp;
+    __atomic_compare_exchange_n(reinterpret_cast<uint64_t*>(dest), &expected, swap, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    *reinterpret_cast<uint64_t*>(src) = expected; // old value, as returned by RDMA CAS
+    return expected == cmp;
+}
+
+static bool shm_cas_mask(char* src, char* dest, uint64_t cmp, uint64_t swap, uint64_t mask, uint32_t size) {
+    assert(size <= 3); // extended atomics are limited to 8 bytes
+    auto ptr = reinterpret_cast<uint64_t*>(dest);
+    uint64_t old = __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+    while ((old & mask) == (cmp & mask)) {
+        uint64_t desired = (old & ~mask) | (swap & mask);
+        if (__atomic_compare_exchange_n(ptr, &old, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            break;
+    }
+    *reinterpret_cast<uint64_t*>(src) = old;
+    return (old & mask) == (cmp & mask);
+}
+
+static void shm_faa(char* src, char* dest, uint64_t add, uint32_t size) {
+    assert(size <= sizeof(uint64_t));
+    *reinterpret_cast<uint64_t*>(src) = __atomic_fetch_add(reinterpret_cast<uint64_t*>(dest), add, __ATOMIC_SEQ_CST);
+}
+
+static void shm_faa_bound(char* src, char* dest, uint64_t add, uint64_t boundary, uint32_t size) {
+    assert(size <= 3);
+    auto ptr = reinterpret_cast<uint64_t*>(dest);
+    uint64_t old = __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+    while (!__atomic_compare_exchange_n(ptr, &old, add_bounded(old, add, boundary), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+        ;
+    *reinterpret_cast<uint64_t*>(src) = old;
+}
+
+void shm_transport_t::read(char* src, global_addr_t dest, uint32_t size, bool signaled) {
+    memcpy(src, get_remote_ptr(dest), size);
+    INC_INT_STATS(bytes_read, size);
+    traffic_request += size;
+}
+
+void shm_transport_t::write(char* src, global_addr_t dest, uint32_t size, bool signaled) {
+    memcpy(get_remote_ptr(dest), src, size);
+    INC_INT_STATS(bytes_written, size);
+    traffic_request += size;
+}
+
+bool shm_transport_t::cas(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint32_t size, bool signaled) {
+    bool ret = shm_cas(src, get_remote_ptr(dest), cmp, swap, size);
+    INC_INT_STATS(bytes_cas, size);
+    traffic_request += size;
+    return signaled ? ret : true;
+}
+
+bool shm_transport_t::cas_mask(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint64_t mask, uint32_t size, bool signaled) {
+    bool ret = shm_cas_mask(src, get_remote_ptr(dest), cmp, swap, mask, size);
+    INC_INT_STATS(bytes_cas, size);
+    traffic_request += size;
+    return signaled ? ret : true;
+}
+
+void shm_transport_t::faa(char* src, global_addr_t dest, uint64_t add, uint32_t size, bool signaled) {
+    shm_faa(src, get_remote_ptr(dest), add, size);
+    INC_INT_STATS(bytes_faa, size);
+    traffic_request += size;
+}
+
+void shm_transport_t::faa_bound(char* src, global_addr_t dest, uint64_t add, uint64_t boundary, uint32_t size, bool signaled) {
+    shm_faa_bound(src, get_remote_ptr(dest), add, boundary, size);
+    INC_INT_STATS(bytes_faa, size);
+    traffic_request += size;
+}
+
+void shm_transport_t::read_dm(char* src, global_addr_t dest, uint32_t size, bool signaled) {
+    memcpy(src, get_remote_dm_ptr(dest), size);
+    INC_INT_STATS(bytes_read, size);
+    traffic_request += size;
+}
+
+void shm_transport_t::write_dm(char* src, global_addr_t dest, uint32_t size, bool signaled) {
+    memcpy(get_remote_dm_ptr(dest), src, size);
+    INC_INT_STATS(bytes_written, size);
+    traffic_request += size;
+}
+
+bool shm_transport_t::cas_dm(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint32_t size, bool signaled) {
+    bool ret = shm_cas(src, get_remote_dm_ptr(dest), cmp, swap, size);
+    INC_INT_STATS(bytes_cas, size);
+    traffic_request += size;
+    return signaled ? ret : true;
+}
+
+bool shm_transport_t::cas_dm_mask(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint64_t mask, uint32_t size, bool signaled) {
+    bool ret = shm_cas_mask(src, get_remote_dm_ptr(dest), cmp, swap, mask, size);
+    INC_INT_STATS(bytes_cas, size);
+    traffic_request += size;
+    return signaled ? ret : true;
+}
+
+void shm_transport_t::faa_dm(char* src, global_addr_t dest, uint64_t add, uint32_t size, bool signaled) {
+    shm_faa(src, get_remote_dm_ptr(dest), add, size);
+    INC_INT_STATS(bytes_faa, size);
+    traffic_request += size;
+}
+
+void shm_transport_t::faa_dm_bound(char* src, global_addr_t dest, uint64_t add, uint64_t boundary, uint32_t size, bool signaled) {
+    shm_faa_bound(src, get_remote_dm_ptr(dest), add, boundary, size);
+    INC_INT_STATS(bytes_faa, size);
+    traffic_request += size;
+}
+
+void shm_transport_t::post_batch(wr_batch_t& batch) {
+    for (uint32_t i=0; i<batch.size(); i++) {
+        auto& op = batch.get_wr(i);
+        switch (op.opcode) {
+            case wr_batch_t::OP_READ:
+                op.dm ? read_dm(op.src, op.dest, op.size) : read(op.src, op.dest, op.size);
+                break;
+            case wr_batch_t::OP_WRITE:
+                op.dm ? write_dm(op.src, op.dest, op.size) : write(op.src, op.dest, op.size);
+                break;
+            case wr_batch_t::OP_CAS:
+                op.dm ? cas_dm(op.src, op.dest, op.compare_add, op.swap, op.size) : cas(op.src, op.dest, op.compare_add, op.swap, op.size);
+                break;
+            case wr_batch_t::OP_FAA:
+                op.dm ? faa_dm(op.src, op.dest, op.compare_add, op.size) : faa(op.src, op.dest, op.compare_add, op.size);
+                break;
+        }
+    }
+}
+
+#endif // TRANSPORT_BACKEND == SHM
@@ -0,0 +1,119 @@
+#pragma once
+#include "transport/transport.h"
+
+#if TRANSPORT_BACKEND == SHM
+
+// Shared-memory loopback transport.
+// Every memory node exports one shared-memory segment that holds
+//   [ header | device memory | request/response rings per client QP | batch rings ]
+// and a second segment that emulates the registered region used for one-sided RDMA.
+// Compute nodes map the segments of all memory nodes, so send/recv, read/write and
+// the atomics become plain memory operations with the same completion semantics
+// as the ibverbs transport (posted receives, wr_id, byte_len in ibv_wc).
+class shm_transport_t : public transport_t {
+public:
+    shm_transport_t();
+    ~shm_transport_t();
+
+    bool init();
+
+    // operation completion
+    int  poll(struct ibv_wc* wc, int num);
+    int  poll_once(struct ibv_wc* wc, int num);
+
+    // two-sided RDMA
+    void post_recv(char* ptr, uint32_t node_id, uint32_t size);
+    void post_recv(char* ptr, uint32_t node_id, uint32_t qp_id, uint32_t size);
+    void recv(char* ptr, uint32_t node_id, uint32_t size);
+    void send(char* ptr, uint32_t node_id, uint32_t size, bool signaled = true);
+    void send(char* ptr, uint32_t node_id, uint32_t qp_id, uint32_t size, bool signaled = true);
+
+    // two-sided RDMA batch
+    int  poll_batch(struct ibv_wc* wc, int num);
+    int  poll_once_batch(struct ibv_wc* wc, int num);
+    void post_recv_batch(char* ptr, uint32_t node_id, uint32_t size);
+    void post_recv_batch(char* ptr, uint32_t node_id, uint32_t qp_id, uint32_t size);
+    void recv_batch(char* ptr, uint32_t node_id, uint32_t size);
+    void send_batch(char* ptr, uint32_t node_id, uint32_t size, bool signaled = true);
+    void send_batch(char* ptr, uint32_t node_id, uint32_t qp_id, uint32_t size, bool signaled = true);
+
+    // one-sided RDMA -- host memory functions
+    void read(char* src, global_addr_t dest, uint32_t size, bool signaled = true);
+    void write(char* src, global_addr_t dest, uint32_t size, bool signaled = true);
+    bool cas(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint32_t size, bool signaled = true);
+    bool cas_mask(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint64_t mask, uint32_t size, bool signaled = true);
+    void faa(char* src, global_addr_t dest, uint64_t add, uint32_t size, bool signaled = true);
+    void faa_bound(char* src, global_addr_t dest, uint64_t add, uint64_t boundary, uint32_t size, bool signaled = true);
+
+    // one-sided RDMA -- device memory functions
+    void read_dm(char* src, global_addr_t dest, uint32_t size, bool signaled = true);
+    void write_dm(char* src, global_addr_t dest, uint32_t size, bool signaled = true);
+    bool cas_dm(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint32_t size, bool signaled = true);
+    bool cas_dm_mask(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint64_t mask, uint32_t size, bool signaled = true);
+    void faa_dm(char* src, global_addr_t dest, uint64_t add, uint32_t size, bool signaled = true);
+    void faa_dm_bound(char* src, global_addr_t dest, uint64_t add, uint64_t boundary, uint32_t size, bool signaled = true);
+
+    // one-sided RDMA batch -- ops are applied in order, so the batch completes when this returns
+    void post_batch(wr_batch_t& batch);
+    void post_batch_async(wr_batch_t& batch) { post_batch(batch); }
+    void wait_batch(wr_batch_t& batch) { }
+
+    static constexpr uint32_t RING_DEPTH = 2; // max outstanding messages per channel
+
+private:
+    // posted receive; only touched by the receiving process
+    struct recv_desc_t {
+        char*    ptr;
+        uint32_t size;
+        uint64_t wr_id;
+    };
+
+    // message ring emulating one direction of a QP
+    // senders spin while no receive is posted (same as RNR retry in RC QPs)
+    struct channel_t {
+        alignas(64) std::atomic<uint64_t> head;    // messages produced
+        alignas(64) std::atomic<uint64_t> tail;    // messages consumed
+        alignas(64) std::atomic<uint64_t> credits; // receives published
+        std::atomic<uint64_t>             posted;  // receives reserved
+        alignas(64) std::atomic<uint32_t> send_latch;
+        std::atomic<uint32_t>             recv_latch;
+        uint32_t                          sizes[RING_DEPTH];
+        recv_desc_t                       descs[RING_DEPTH];
+    };
+
+    struct segment_header_t {
+        std::atomic<uint64_t> magic;
+        std::atomic<uint32_t> num_attached;
+        uint32_t num_client_nodes;
+        uint32_t num_client_qps;
+        uint32_t num_batch_threads;
+        uint64_t mr_base;  // address of the registered region in the memory node
+        uint64_t mr_size;
+    };
+
+    bool     cleanup();
+    bool     create_segment();
+    bool     attach_segment(uint32_t server_id);
+    char*    map_segment(const std::string& name, uint64_t size, bool create);
+
+    uint64_t segment_size();
+    uint64_t channel_size(bool batch);
+    channel_t* get_channel(uint32_t server_id, uint32_t client_id, uint32_t qp_id, bool batch, bool response);
+    char*    get_slot(channel_t* chan, uint64_t idx, bool batch);
+
+    void     post_channel(channel_t* chan, char* ptr, uint32_t size, uint64_t wr_id);
+    void     send_channel(channel_t* chan, char* ptr, uint32_t size, bool batch);
+    int      poll_channel(channel_t* chan, struct ibv_wc* wc, bool batch);
+
+    // address translation for one-sided operations
+    char*    get_remote_ptr(global_addr_t addr);
+    char*    get_remote_dm_ptr(global_addr_t addr);
+
+    std::string            _name_prefix;
+    char**                 _segments; // one segment per memory node
+    char**                 _mr_bases; // local mapping of each memory node's registered region
+    uint64_t*              _remote_mr_bases;
+    uint64_t               _mr_size;
+};
+
+#endif // TRANSPORT_BACKEND == SHM
@@ -352,14 +352,18 @@ bool transport_t::init_rdma() {
 
     // QPs and CQs are initialized in the derived classes
     // Clients and servers have different # of QPs and CQs
+    return init_buffers();
+}
 
+bool transport_t::init_buffers() {
     // we allocate memory regions for each node (this MR is only for two-sided RDMA)
     //// buffer layout for server
-    ////// [ send region * g_num_server_threads | recv region * g_num_client_threads * g_num_client_nodes ]
+    ////// [ send region * g_num_server_threads | recv region * g_num_client_qps * g_num_client_nodes ]
     //// buffer layout for client
-    ////// [ send region * g_num_client_threads | recv region * g_num_server_threads * g_num_server_nodes ]
-    uint64_t global_num_send_threads = g_num_client_threads < g_num_server_threads ? g_num_server_threads : g_num_client_threads;
-    uint64_t global_num_recv_threads = g_num_client_threads;
+    ////// [ send region * g_num_client_qps | recv region * g_num_server_threads * g_num_server_nodes ]
+    //// (g_num_client_qps == g_num_client_threads unless client threads run multiple coroutines)
+    uint64_t global_num_send_threads = g_num_client_qps < g_num_server_threads ? g_num_server_threads : g_num_client_qps;
+    uint64_t global_num_recv_threads = g_num_client_qps;
     //uint64_t global_num_recv_threads = g_is_server ? g_num_client_threads : g_num_server_threads;
     _rdma_send_buffer_size = MAX_MESSAGE_SIZE * global_num_send_threads * g_num_nodes;
     _rdma_recv_buffer_size = MAX_MESSAGE_SIZE * global_num_recv_threads * g_num_nodes;
@@ -474,7 +478,7 @@ bool transport_t::init_rdma() {
 
 bool transport_t::cleanup() {
     if (_rdma_send_buffer) {
-        for (uint32_t i=0; i<g_num_client_threads; i++) {
+        for (uint32_t i=0; i<g_num_client_qps; i++) {
         // for (uint32_t i=0; i<g_num_nodes; i++) {
             if (_rdma_send_buffer[i]) {
                 delete[] _rdma_send_buffer[i];
@@ -485,7 +489,7 @@ bool transport_t::cleanup() {
         _rdma_send_buffer = nullptr;
     }
     if (_rdma_recv_buffer) {
-        for (uint32_t i=0; i<g_num_client_threads; i++) {
+        for (uint32_t i=0; i<g_num_client_qps; i++) {
         // for (uint32_t i=0; i<g_num_nodes; i++) {
             if (_rdma_recv_buffer[i]) {
                 delete[] _rdma_recv_buffer[i];
@@ -819,12 +823,12 @@ bool transport_t::modify_qp_state_to_rts(struct ibv_qp* qp) {
 }
 
 char* transport_t::get_buffer(){
-    return _rdma_send_buffer[GET_THD_ID][0];
+    return _rdma_send_buffer[GET_QP_ID][0];
     // return _rdma_send_buffer[0][GET_THD_ID];
 }
 
 char* transport_t::get_buffer(uint32_t node_id) {
-    return _rdma_send_buffer[GET_THD_ID][node_id];
+    return _rdma_send_buffer[GET_QP_ID][node_id];
     // return _rdma_send_buffer[node_id][GET_THD_ID];
 }
 
@@ -849,7 +853,7 @@ char* transport_t::get_batch_buffer(uint32_t node_id) {
 }
 
 char* transport_t::get_recv_buffer(uint32_t node_id) {
-    return _rdma_recv_buffer[GET_THD_ID][node_id];
+    return _rdma_recv_buffer[GET_QP_ID][node_id];
     // return _rdma_recv_buffer[node_id][GET_THD_ID];
 }
 
@@ -1154,6 +1158,60 @@ bool transport_t::post_write(struct ibv_qp* qp, char* src, uint64_t dest, uint32
     return true;
 }
 
+void transport_t::prepare_wr(struct ibv_send_wr* wr, struct ibv_sge* sge, const wr_batch_t::wr_t& op, uint64_t dest, uint32_t lkey, uint32_t rkey) {
+    memset(sge, 0, sizeof(*sge));
+    memset(wr, 0, sizeof(*wr));
+
+    sge->addr   = (uintptr_t)op.src;
+    sge->length = op.size;
+    sge->lkey   = lkey;
+
+    wr->wr_id      = 0;
+    wr->sg_list    = sge;
+    wr->num_sge    = 1;
+    wr->send_flags = 0;
+    switch (op.opcode) {
+        case wr_batch_t::OP_READ:
+            wr->opcode = IBV_WR_RDMA_READ;
+            wr->wr.rdma.remote_addr = dest;
+            wr->wr.rdma.rkey = rkey;
+            break;
+        case wr_batch_t::OP_WRITE:
+            wr->opcode = IBV_WR_RDMA_WRITE;
+            wr->wr.rdma.remote_addr = dest;
+            wr->wr.rdma.rkey = rkey;
+            break;
+        case wr_batch_t::OP_CAS:
+            assert(op.size <= 8);
+            wr->opcode = IBV_WR_ATOMIC_CMP_AND_SWP;
+            wr->wr.atomic.remote_addr = dest;
+            wr->wr.atomic.rkey = rkey;
+            wr->wr.atomic.compare_add = op.compare_add;
+            wr->wr.atomic.swap = op.swap;
+            break;
+        case wr_batch_t::OP_FAA:
+            assert(op.size <= 8);
+            wr->opcode = IBV_WR_ATOMIC_FETCH_AND_ADD;
+            wr->wr.atomic.remote_addr = dest;
+            wr->wr.atomic.rkey = rkey;
+            wr->wr.atomic.compare_add = op.compare_add;
+            break;
+        default:
+            assert(false);
+    }
+}
+
+// post a linked list of work requests with a single doorbell
+bool transport_t::post_send_list(struct ibv_qp* qp, struct ibv_send_wr* wr) {
+    struct ibv_send_wr* wr_bad;
+    if(ibv_post_send(qp, wr, &wr_bad)){
+        debug::notify_error("Failed to ibv_post_send (RDMA BATCH)");
+    	assert(false);
+        return false;
+    }
+    return true;
+}
+
 int transport_t::poll_cq(struct ibv_cq* cq, int num_entries, struct ibv_wc* wc) {
     int total_wc = 0;
     while (total_wc < num_entries) {
@@ -1168,6 +1226,18 @@ int transport_t::poll_cq(struct ibv_cq* cq, int num_entries, struct ibv_wc* wc)
 }
 
 
+// waits for the completion of a signaled one-sided op; the other coroutines of the thread may run meanwhile
+int transport_t::poll_completion(struct ibv_cq* cq, struct ibv_wc* wc) {
+    int ne;
+    while ((ne = ibv_poll_cq(cq, 1, wc)) == 0)
+        global_manager->yield_on_completion();
+    if (ne < 0) {
+        debug::notify_error("Failed to poll CQ");
+        return -1;
+    }
+    return ne;
+}
+
 int transport_t::poll_cq_once(struct ibv_cq* cq, int num_entries, struct ibv_wc* wc) {
     int cnt = ibv_poll_cq(cq, num_entries, wc);
     if (cnt < 0) {
@@ -1181,7 +1251,7 @@ void transport_t::rdma_faa(struct ibv_qp* qp, struct ibv_cq* cq, char* src, uint
     bool ret = post_faa(qp, src, dest, add, size, lkey, rkey, signaled);
     if (signaled) {
         struct ibv_wc wc;
-        poll_cq(cq, 1, &wc);
+        poll_completion(cq, &wc);
     }
 }
 
@@ -1189,7 +1259,7 @@ void transport_t::rdma_faa_bound(struct ibv_qp* qp, struct ibv_cq* cq, char* src
     bool ret = post_faa_bound(qp, src, dest, add, boundary, size, lkey, rkey, signaled);
     if (signaled) {
         struct ibv_wc wc;
-        poll_cq(cq, 1, &wc);
+        poll_completion(cq, &wc);
     }
 }
 
@@ -1197,7 +1267,7 @@ bool transport_t::rdma_cas(struct ibv_qp* qp, struct ibv_cq* cq, char* src, uint
     bool ret = post_cas(qp, src, dest, cmp, swp, size, lkey, rkey, signaled);
     if (signaled) {
         struct ibv_wc wc;
-        poll_cq(cq, 1, &wc);
+        poll_completion(cq, &wc);
         return cmp == *reinterpret_cast<uint64_t*>(src);
     }
     else
@@ -1208,7 +1278,7 @@ bool transport_t::rdma_cas_mask(struct ibv_qp* qp, struct ibv_cq* cq, char* src,
     bool ret = post_cas_mask(qp, src, dest, cmp, swp, mask, size, lkey, rkey, signaled);
     if (signaled) {
         struct ibv_wc wc;
-        poll_cq(cq, 1, &wc);
+        poll_completion(cq, &wc);
 
         if (size <= 3) {
             return (cmp & mask) == (*reinterpret_cast<uint64_t*>(src) & mask);
@@ -1233,7 +1303,7 @@ void transport_t::rdma_read(struct ibv_qp* qp, struct ibv_cq* cq, char* src, uin
     post_read(qp, src, dest, size, lkey, rkey, signaled);
     if (signaled) {
         struct ibv_wc wc;
-        poll_cq(cq, 1, &wc);
+        poll_completion(cq, &wc);
     }
 }
 
@@ -1241,7 +1311,7 @@ void transport_t::rdma_write(struct ibv_qp* qp, struct ibv_cq* cq, char* src, ui
     post_write(qp, src, dest, size, lkey, rkey, signaled);
     if (signaled) {
         struct ibv_wc wc;
-        poll_cq(cq, 1, &wc);
+        poll_completion(cq, &wc);
     }
 }
 
@@ -15,6 +15,59 @@ class memory_region_t;
 
 class transport_t {
 public:
+    // One-sided RDMA batch.
+    // Records reads, writes and atomics to one or more nodes. post_batch() chains the ops to each node
+    // (in the order they were added) into a single list of work requests posted with one doorbell;
+    // only the last work request of each chain is signaled.
+    // post_batch_async() returns right after posting, so several batches can be in flight at once;
+    // wait_batch() returns once the ops of one of them have completed.
+    class wr_batch_t {
+    public:
+        enum opcode_t { OP_READ, OP_WRITE, OP_CAS, OP_FAA };
+        struct wr_t {
+            opcode_t      opcode;
+            bool          dm; // device memory
+            char*         src;
+            global_addr_t dest;
+            uint32_t      size;
+            uint64_t      compare_add;
+            uint64_t      swap;
+        };
+        static constexpr uint32_t MAX_WRS = 16;
+
+        wr_batch_t(): _num_wrs(0), _num_pending(0) { }
+
+        void     read(char* src, global_addr_t dest, uint32_t size)                               { append(OP_READ, false, src, dest, size, 0, 0); }
+        void     write(char* src, global_addr_t dest, uint32_t size)                              { append(OP_WRITE, false, src, dest, size, 0, 0); }
+        void     cas(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint32_t size)    { append(OP_CAS, false, src, dest, size, cmp, swap); }
+        void     faa(char* src, global_addr_t dest, uint64_t add, uint32_t size)                   { append(OP_FAA, false, src, dest, size, add, 0); }
+        void     read_dm(char* src, global_addr_t dest, uint32_t size)                            { append(OP_READ, true, src, dest, size, 0, 0); }
+        void     write_dm(char* src, global_addr_t dest, uint32_t size)                           { append(OP_WRITE, true, src, dest, size, 0, 0); }
+        void     cas_dm(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint32_t size) { append(OP_CAS, true, src, dest, size, cmp, swap); }
+        void     faa_dm(char* src, global_addr_t dest, uint64_t add, uint32_t size)                { append(OP_FAA, true, src, dest, size, add, 0); }
+
+        void     clear()              { assert(_num_pending == 0); _num_wrs = 0; }
+        uint32_t size()               { return _num_wrs; }
+        // signaled chains posted asynchronously whose completion has not been polled yet
+        uint32_t& pending()           { return _num_pending; }
+        wr_t&    get_wr(uint32_t idx) { return _wrs[idx]; }
+        // whether the CAS at idx has succeeded (valid after post_batch)
+        bool     cas_succeeded(uint32_t idx) {
+            assert(_wrs[idx].opcode == OP_CAS);
+            return *reinterpret_cast<uint64_t*>(_wrs[idx].src) == _wrs[idx].compare_add;
+        }
+
+    private:
+        void     append(opcode_t opcode, bool dm, char* src, global_addr_t dest, uint32_t size, uint64_t compare_add, uint64_t swap) {
+            assert(_num_wrs < MAX_WRS);
+            _wrs[_num_wrs++] = wr_t{opcode, dm, src, dest, size, compare_add, swap};
+        }
+
+        wr_t     _wrs[MAX_WRS];
+        uint32_t _num_wrs;
+        uint32_t _num_pending;
+    };
+
     transport_t();
     ~transport_t();
 
@@ -50,8 +103,11 @@ public:
     bool         post_cas_mask(struct ibv_qp* qp, char* src, uint64_t dest, uint64_t expected, uint64_t desired, uint64_t mask, uint32_t size, uint32_t lkey, uint32_t rkey, bool signaled=true);
     bool         post_read(struct ibv_qp* qp, char* src, uint64_t dest, uint32_t size, uint32_t lkey, uint32_t rkey, bool signaled=true);
     bool         post_write(struct ibv_qp* qp, char* src, uint64_t dest, uint32_t size, uint32_t lkey, uint32_t rkey, bool signaled=true);
+    void         prepare_wr(struct ibv_send_wr* wr, struct ibv_sge* sge, const wr_batch_t::wr_t& op, uint64_t dest, uint32_t lkey, uint32_t rkey);
+    bool         post_send_list(struct ibv_qp* qp, struct ibv_send_wr* wr);
     int          poll_cq(struct ibv_cq* cq, int num_entries, struct ibv_wc* wc);
     int          poll_cq_once(struct ibv_cq* cq, int num_entries, struct ibv_wc* wc);
+    int          poll_completion(struct ibv_cq* cq, struct ibv_wc* wc);
 
     // communication wrappers
     void         rdma_read(struct ibv_qp* qp, struct ibv_cq* cq, char* src, uint64_t dest, uint32_t size, uint32_t lkey, uint32_t rkey, bool signaled=true);
@@ -99,6 +155,12 @@ public:
     virtual      bool cas_dm(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint32_t size, bool signaled = true) = 0;
     virtual      bool cas_dm_mask(char* src, global_addr_t dest, uint64_t cmp, uint64_t swap, uint64_t mask, uint32_t size, bool signaled = true) = 0;
 
+    // one-sided RDMA batch -- returns once all ops in the batch have completed
+    virtual      void post_batch(wr_batch_t& batch) = 0;
+    // one-sided RDMA batch -- returns once posted; the thread must wait_batch() before issuing other signaled ops
+    virtual      void post_batch_async(wr_batch_t& batch) = 0;
+    virtual      void wait_batch(wr_batch_t& batch) = 0;
+
 protected:
     struct rdma_ctx {
         struct ibv_context* ctx;
@@ -115,7 +177,8 @@ protected:
         uint32_t rkey;
         uint32_t dm_rkey;
         uint64_t dm_base;
-        uint32_t qpn[MAX_NUM_THREADS];
+        uint32_t num_qps; // g_num_client_qps (client threads x coroutines) of the sender; must match on both sides
+        uint32_t qpn[MAX_NUM_THREADS * MAX_NUM_COROS];
         uint32_t batch_qpn[MAX_NUM_THREADS];
     };
 
@@ -126,6 +189,7 @@ protected:
     uint32_t     get_port_num(uint32_t node_id, bool is_server);
 
     bool         init_rdma();
+    bool         init_buffers();
     virtual bool cleanup();
 
     // rdma configuration functions
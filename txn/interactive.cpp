@@ -83,7 +83,9 @@ RC interactive_t::process_request() {
 #else // no BATCH
     transport->send(base_ptr, node_id, base_size + data_size);
     struct ibv_wc wc;
-    uint32_t num = transport->poll(&wc, 1);
+    uint32_t num = 0;
+    while ((num = transport->poll_once(&wc, 1)) == 0)
+        global_manager->yield();
     assert(num == 1);
     assert(wc.wr_id == node_id);
     transport->post_recv(recv_buffer, node_id, MAX_MESSAGE_SIZE); // prepost
@@ -16,7 +16,22 @@ class txn_manager_t{
 
         virtual RC   execute() = 0;
         virtual void global_sync() = 0;
+        virtual void yield() { }
+
+        // one-sided ops yield while waiting for their completions only inside a yield_scope_t;
+        // the indexes keep per-thread state (e.g., Sherman's path stack and local locks)
+        // that the other coroutines of the thread would clobber
+        void         yield_on_completion() { if (_yield_scope > 0) yield(); }
+
+        class yield_scope_t {
+        public:
+            yield_scope_t(txn_manager_t* txn_man): _txn_man(txn_man) { if (_txn_man) _txn_man->_yield_scope++; }
+            ~yield_scope_t() { if (_txn_man) _txn_man->_yield_scope--; }
+        private:
+            txn_manager_t* _txn_man;
+        };
 
     protected:
         thread_t*               _thread;
+        uint32_t                _yield_scope = 0;
 };
@@ -108,6 +108,7 @@ RC stored_procedure_t::process_request() {
 #endif
     struct ibv_wc wc[sent_num];
     uint32_t num = 0;
+    uint64_t starttime = get_sys_clock();
     while (num < sent_num) { 
         int polled = transport->poll_once(wc, sent_num - num);
         if (polled > 0) {
@@ -131,7 +132,11 @@ RC stored_procedure_t::process_request() {
             }
             num += polled;
         }
+        else
+            global_manager->yield(); // let other coroutines of this thread run
     }
+    if (sent_num > 0)
+        INC_TIME_STATS(time_wait, get_sys_clock() - starttime);
 #if BATCH
     batch_man->report_member(get_sys_clock() - latency);
     }
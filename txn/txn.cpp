@@ -11,18 +11,22 @@
 #include "batch/decision.h"
 #include "batch/manager.h"
 #include "utils/packetize.h"
+#include "transport/access_list.h"
+#include "storage/scan.h"
 
 // server constructor 
 txn_t::txn_t(txn_id_t txn_id): _txn_id(txn_id), _query(nullptr),
-                               _timestamp(0), _prev_offset(0), _curr_offset(0) {
+                               _timestamp(0), _snapshot(false), _commit_ts(0),
+                               _prev_offset(0), _curr_offset(0), _lock_nodes(nullptr) {
     assert(g_is_server);
     _cc_manager = cc_manager_t::create(this);
 }
 
 // client constructor
-txn_t::txn_t(base_query_t* query): _txn_id(txn_id_t(g_node_id, GET_THD_ID)), 
+txn_t::txn_t(base_query_t* query): _txn_id(txn_id_t(g_node_id, GET_QP_ID)), 
                                    _query(query), _timestamp(get_priority()),
-                                   _prev_offset(0), _curr_offset(0) {
+                                   _snapshot(SNAPSHOT_READ && !PARTITIONED && TRANSPORT == TWO_SIDED && query->is_read_only()),
+                                   _commit_ts(0), _prev_offset(0), _curr_offset(0), _lock_nodes(nullptr) {
     assert(!g_is_server);
     _cc_manager = cc_manager_t::create(this);
 }
@@ -35,9 +39,23 @@ txn_t::~txn_t() {
 void txn_t::init() {
     _prev_offset = 0;
     _curr_offset = 0;
+    _commit_ts = 0;
+    if (_snapshot) // a restarted read-only txn reads a newer snapshot
+        _timestamp = get_priority();
     _state.store(RUNNING);
 }
 
+void txn_t::reset(txn_id_t txn_id) {
+    assert(g_is_server);
+    _txn_id = txn_id;
+    _timestamp = 0;
+    _snapshot = false;
+    _commit_ts = 0;
+    _lock_nodes = nullptr;
+    _cc_manager->clear();
+    init();
+}
+
 void txn_t::set_query(base_query_t* query) {
     if(_query) delete _query;
     _query = query;
@@ -50,7 +68,7 @@ void txn_t::set_query(base_query_t* query) {
 void txn_t::parse_request(message_t* msg) {
     uint32_t size = msg->get_data_size();
     UnstructuredBuffer buffer(msg->get_data_ptr());
-#if (CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT) && !PARTITIONED
+#if (CC_ALG == WAIT_DIE || CC_ALG == WOUND_WAIT || SNAPSHOT_READ) && !PARTITIONED
     uint64_t timestamp = 0;
     buffer.get(&timestamp);
     assert(timestamp != 0);
@@ -59,33 +77,40 @@ void txn_t::parse_request(message_t* msg) {
 #endif
     uint32_t num = 0;
     buffer.get(&num);
+    if (num & access_list_t::SNAPSHOT)
+        _snapshot = true;
+    if (num & access_list_t::COMPACT) {
+        access_list_t::decode(num & access_list_t::COUNT_MASK, buffer, [&](access_list_t::entry_t& entry) {
+#if PARTITIONED
+            _cc_manager->register_access(entry.type, entry.key, entry.table_id, entry.index_id, entry.cache, entry.value, entry.evict_key, entry.evict_value);
+#else
+            if (entry.scan)
+                _cc_manager->register_scan(entry.key, entry.table_id, entry.index_id, *entry.scan);
+            else
+                _cc_manager->register_access(entry.type, entry.key, entry.table_id, entry.index_id, entry.cache);
+#endif
+        });
+        assert(buffer.size() == size);
+        return;
+    }
 
+    num &= access_list_t::COUNT_MASK;
     for (uint32_t i=0; i<num; i++) {
-        uint64_t key = -1;
-        uint32_t index_id = -1, table_id = -1;
-        access_t type = TYPE_NONE;
-        uint64_t cache_hint = 0;
 #if PARTITIONED // index manager
-        uint64_t evict_key, evict_value;
-        uint64_t value;
-        buffer.get(&cache_hint);
-        buffer.get(&type);
-        buffer.get(&key);
-        buffer.get(&index_id);
-        buffer.get(&table_id);
-        buffer.get(&value);
-        if (cache_hint == 2) { // cache admission + eviction
-            buffer.get(&evict_key);
-            buffer.get(&evict_value);
+        auto tuple = buffer.get_ptr<cc_manager_t::IndexTuple>();
+        uint64_t evict_key = 0, evict_value = 0;
+        if (tuple->cache_op == 2) { // cache admission + eviction
+            auto evict = buffer.get_ptr<cc_manager_t::EvictTuple>();
+            evict_key = evict->key;
+            evict_value = evict->value;
         }
-        _cc_manager->register_access(type, key, table_id, index_id, cache_hint, value, evict_key, evict_value);
+        _cc_manager->register_access(tuple->type, tuple->key, tuple->table_id, tuple->index_id, tuple->cache_op, tuple->value, evict_key, evict_value);
 #else // CC manager
-        buffer.get(&type);
-        buffer.get(&key);
-        buffer.get(&index_id);
-        buffer.get(&table_id);
-        buffer.get(&cache_hint);
-        _cc_manager->register_access(type, key, table_id, index_id, cache_hint);
+        auto tuple = buffer.get_ptr<cc_manager_t::AccessTuple>();
+        if (tuple->type == SCAN && tuple->cache == scan_spec_t::RANGE)
+            _cc_manager->register_scan(tuple->key, tuple->table_id, tuple->index_id, *buffer.get_ptr<scan_spec_t>());
+        else
+            _cc_manager->register_access(tuple->type, tuple->key, tuple->table_id, tuple->index_id, tuple->cache);
 #endif
     }
     assert(buffer.size() == size);
@@ -97,12 +122,23 @@ RC txn_t::process_prepare(char* data, uint32_t size) {
 
 RC txn_t::process_commit(char* data, uint32_t size) {
     RC rc = RCOK;
+#if SNAPSHOT_READ && !PARTITIONED
+    if (size > 0 && get_state() == state_t::COMMITTING) { // 2PC commit phase, carries the commit timestamp
+        UnstructuredBuffer buffer(data);
+        buffer.get(&_commit_ts);
+        assert(buffer.size() == size);
+        size = 0;
+    }
+#endif
     if (size > 0) { // this is not 2PC, single-node commit
         rc = _cc_manager->process_prepare(data, size);
         if (rc != RCOK) {
             assert(rc == ABORT);
             return rc;
         }
+#if SNAPSHOT_READ && !PARTITIONED
+        _commit_ts = std::max(_commit_ts, get_priority()); // the only node picks the commit timestamp
+#endif
     }
     rc = _cc_manager->process_commit();
     return rc;
@@ -162,7 +198,7 @@ void txn_t::process_abort_nodes() {
     uint32_t num_resp_expected = _cc_manager->get_commit_nodes(all_nodes_involved);
 #if BATCH
     auto batch_man = global_manager->get_batch_manager();
-    auto decision = batch_man->get_decision();
+    auto decision = batch_man->get_commit_decision();
     uint32_t wait_time[num_resp_expected];
 #endif
 
@@ -208,6 +244,8 @@ void txn_t::process_abort_nodes() {
                 transport->post_recv(recv_buffer, node_id, MAX_MESSAGE_SIZE); // prepost receive
             }
         }
+        else
+            global_manager->yield(); // let other coroutines of this thread run
     } while (num < num_resp_expected);
 #if BATCH
     }    
@@ -220,14 +258,20 @@ void txn_t::process_abort_nodes() {
 RC txn_t::process_commit() {
     RC rc = RCOK;
     set_state(state_t::COMMITTING);
+    uint64_t starttime = get_sys_clock();
 #if !PARTITIONED
 #if TRANSPORT == TWO_SIDED
     std::vector<uint32_t> all_nodes_involved;
     uint32_t size = _cc_manager->get_commit_nodes(all_nodes_involved);
-    if (size == 1) // single node commit
+    if (_snapshot) // the servers have already finished the read-only txn
+        rc = RCOK;
+    else if (size == 1) // single node commit
         rc = process_single_commit(all_nodes_involved);
     else { // 2PC commit
         rc = process_2pc_prepare(all_nodes_involved);
+        uint64_t endtime = get_sys_clock();
+        INC_TIME_STATS(time_prepare, endtime - starttime);
+        starttime = endtime;
         if (rc == RCOK)
             process_2pc_commit(all_nodes_involved);
     }
@@ -241,6 +285,7 @@ RC txn_t::process_commit() {
         assert(rc == ABORT);
         _cc_manager->cleanup(rc);
     }
+    INC_TIME_STATS(time_commit, get_sys_clock() - starttime);
 // #if !PARTITIONED
 // #if TRANSPORT == ONE_SIDED
 //     _cc_manager->cleanup(COMMIT);
@@ -275,7 +320,7 @@ RC txn_t::process_2pc_prepare(std::vector<uint32_t>& nodes_involved) {
     bool aborting = false;
 #if BATCH
     auto batch_man = global_manager->get_batch_manager();
-    auto decision = batch_man->get_decision();
+    auto decision = batch_man->get_commit_decision();
     uint32_t wait_time[num_nodes];
     uint64_t latency = get_sys_clock();
     bool batch_status = false;
@@ -318,13 +363,14 @@ RC txn_t::process_2pc_prepare(std::vector<uint32_t>& nodes_involved) {
         for (auto& node_id: nodes_involved) {
             char* recv_buffer = transport->get_recv_buffer(node_id);
             auto recv_msg = reinterpret_cast<message_t*>(recv_buffer);
-            assert(recv_msg->get_data_size() == 0);
             assert(recv_msg->get_node_id() == node_id);
             if (recv_msg->get_type() != message_t::type_t::RESPONSE_PREPARE) { // this node voted ABORT
                 assert(recv_msg->get_type() == message_t::type_t::RESPONSE_ABORT);
                 aborting = true;
                 nodes_aborted.push_back(node_id);
             }
+            else
+                process_prepare_vote(recv_msg);
         }
     }
     else { // SEND_IMMEDIATELY
@@ -339,16 +385,19 @@ RC txn_t::process_2pc_prepare(std::vector<uint32_t>& nodes_involved) {
                 uint64_t node_id = wc[i].wr_id;
                 char* recv_buffer = transport->get_recv_buffer(node_id);
                 auto recv_msg = reinterpret_cast<message_t*>(recv_buffer);
-                assert(recv_msg->get_data_size() == 0);
                 assert(recv_msg->get_node_id() == node_id);
                 if (recv_msg->get_type() != message_t::type_t::RESPONSE_PREPARE) { // this node voted ABORT
                     assert(recv_msg->get_type() == message_t::type_t::RESPONSE_ABORT);
                     aborting = true;
                     nodes_aborted.push_back(node_id);
                 }
+                else
+                    process_prepare_vote(recv_msg);
                 transport->post_recv(recv_buffer, node_id, MAX_MESSAGE_SIZE); // prepost receive
             }
         }
+        else
+            global_manager->yield(); // let other coroutines of this thread run
     } while (num < num_nodes);
 #if BATCH
     batch_man->report_member(get_sys_clock() - latency);
@@ -364,6 +413,19 @@ RC txn_t::process_2pc_prepare(std::vector<uint32_t>& nodes_involved) {
         return RCOK;
 }
 
+void txn_t::process_prepare_vote(message_t* msg) {
+#if SNAPSHOT_READ
+    // [ lower bound of the commit timestamp ]
+    UnstructuredBuffer buffer(msg->get_data_ptr());
+    uint64_t bound = 0;
+    buffer.get(&bound);
+    assert(buffer.size() == msg->get_data_size());
+    _commit_ts = std::max(_commit_ts, bound);
+#else
+    assert(msg->get_data_size() == 0);
+#endif
+}
+
 void txn_t::process_2pc_commit(std::vector<uint32_t>& nodes_involved) {
     uint32_t total_size = 0;
     uint32_t base_size = sizeof(message_t) - sizeof(char*);
@@ -371,9 +433,15 @@ void txn_t::process_2pc_commit(std::vector<uint32_t>& nodes_involved) {
 
     uint32_t num_nodes = nodes_involved.size();
     assert(num_nodes > 1);
+    uint32_t data_size = 0;
+#if SNAPSHOT_READ
+    // commit timestamp above the bounds of all nodes
+    uint64_t commit_ts = std::max(_commit_ts, get_priority());
+    data_size = sizeof(commit_ts);
+#endif
 #if BATCH
     auto batch_man = global_manager->get_batch_manager();
-    auto decision = batch_man->get_decision();
+    auto decision = batch_man->get_commit_decision();
     uint32_t wait_time[num_nodes];
     bool batch_status = false;
     uint64_t latency = get_sys_clock();
@@ -382,12 +450,16 @@ void txn_t::process_2pc_commit(std::vector<uint32_t>& nodes_involved) {
         uint32_t node_id = nodes_involved[i];
         char* send_ptr = transport->get_buffer(node_id);
         message_t* send_msg = new (send_ptr) message_t(message_t::type_t::REQUEST_COMMIT, qp_id, 0);
+#if SNAPSHOT_READ
+        memcpy(send_msg->get_data_ptr(), &commit_ts, data_size);
+        send_msg->set_data_size(data_size);
+#endif
 #if BATCH
         if (decision == batch_decision_t::WAIT_FOR_BATCH)
-            wait_time[i] = batch_man->submit_request(node_id, base_size);
+            wait_time[i] = batch_man->submit_request(node_id, base_size + data_size);
         else {
 #endif
-        transport->send(send_ptr, node_id, base_size);
+        transport->send(send_ptr, node_id, base_size + data_size);
 #if BATCH
         }
 #endif
@@ -427,6 +499,8 @@ void txn_t::process_2pc_commit(std::vector<uint32_t>& nodes_involved) {
                 transport->post_recv(recv_buffer, node_id, MAX_MESSAGE_SIZE); // prepost receive
             }
         }
+        else
+            global_manager->yield(); // let other coroutines of this thread run
     } while(num < num_nodes);
 #if BATCH
     batch_man->report_member(get_sys_clock() - latency);
@@ -449,7 +523,7 @@ RC txn_t::process_single_commit(std::vector<uint32_t>& nodes_involved) {
         send_msg->set_data_size(send_size);
 #if BATCH
     auto batch_man = global_manager->get_batch_manager();
-    auto decision = batch_man->get_decision();
+    auto decision = batch_man->get_commit_decision();
     uint32_t wait_time = 0;
     bool batch_status = false;
     uint64_t latency = get_sys_clock();
@@ -471,7 +545,9 @@ RC txn_t::process_single_commit(std::vector<uint32_t>& nodes_involved) {
 #endif // no BATCH
     transport->send(send_buffer, node_id, base_size + send_size);
     struct ibv_wc wc;
-    uint32_t num = transport->poll(&wc, 1);
+    uint32_t num = 0;
+    while ((num = transport->poll_once(&wc, 1)) == 0)
+        global_manager->yield();
     assert(num == 1);
     assert(wc.wr_id == node_id);
     transport->post_recv(transport->get_recv_buffer(node_id), node_id, MAX_MESSAGE_SIZE); // prepost receive
@@ -639,6 +715,7 @@ void txn_t::wait_for_responses(uint32_t num_responses) {
     uint32_t tid = GET_THD_ID;
     struct ibv_wc wc[num_responses];
     uint32_t num = 0;
+    uint64_t starttime = get_sys_clock();
     do {
         int polled = transport->poll_once(wc, num_responses - num);
         if (polled > 0) {
@@ -652,6 +729,7 @@ void txn_t::wait_for_responses(uint32_t num_responses) {
             }
         }
     } while (num < num_responses);
+    INC_TIME_STATS(time_wait, get_sys_clock() - starttime);
 }
 /*
 bool txn_t::twotree_rpc_insert(INDEX* index, char* addr, uint64_t version, uint64_t key, uint64_t value, char* data) {
@@ -7,6 +7,7 @@
 class base_query_t;
 class cc_manager_t;
 class message_t;
+namespace twosided { struct lock_node_t; }
 
 class txn_t {
 public:
@@ -14,6 +15,8 @@ public:
     txn_t(base_query_t* query);
     virtual ~txn_t();
     virtual void init();
+    // reuses a server txn for the next request instead of allocating a new one
+    void         reset(txn_id_t txn_id);
 
     txn_id_t      get_id()           { return _txn_id; }
     base_query_t* get_query()        { return _query; }
@@ -30,6 +33,16 @@ public:
     void          set_ts(uint64_t ts) { _timestamp = ts; }
     uint64_t      get_ts()            { return _timestamp; }
 
+    // SNAPSHOT_READ: a read-only txn reads the snapshot at its timestamp without locks;
+    // an update txn collects a lower bound of its commit timestamp while it prepares
+    bool          is_snapshot()                { return _snapshot; }
+    void          set_commit_ts(uint64_t ts)   { _commit_ts = ts; }
+    uint64_t      get_commit_ts()              { return _commit_ts; }
+
+    // lock nodes of the lock-word row manager held by this txn
+    twosided::lock_node_t* get_lock_nodes()                            { return _lock_nodes; }
+    void                   set_lock_nodes(twosided::lock_node_t* head) { _lock_nodes = head; }
+
     virtual RC    execute() = 0;
     virtual RC    process_request() = 0;
 
@@ -51,14 +64,18 @@ protected:
     bool          handle_batching_leader(std::vector<uint32_t>& nodes_involved, uint32_t* wait_time);
     bool          handle_batching_member(std::vector<uint32_t>& nodes_involved, uint32_t* wait_time);
     void          wait_for_responses(uint32_t num_responses);
+    void          process_prepare_vote(message_t* msg); // RESPONSE_PREPARE of a node
 
     txn_id_t       _txn_id;
     cc_manager_t*  _cc_manager; // concurrency control manager
     base_query_t*  _query;
     uint64_t       _timestamp;
+    bool           _snapshot;
+    uint64_t       _commit_ts;
     uint32_t       _prev_offset;
     uint32_t       _curr_offset;
 
     // TXN state for concurrency control (for 2PC)
     std::atomic<state_t> _state;
+    twosided::lock_node_t* _lock_nodes;
 };
\ No newline at end of file
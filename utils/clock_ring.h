@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// CLOCK ring over the entries of a cache for O(1) victim selection (GCLOCK).
+// Every cached entry occupies one slot of the ring and remembers it (T::clock_slot).
+// The hand sweeps the ring and halves the frequency of each entry it passes, so an entry
+// is selected once it has not been accessed for as many sweeps as its frequency has bits.
+// The ring is kept at most 2/3 full, so finding an empty slot for a new entry takes a few probes.
+// T provides: std::atomic<uint32_t> clock_slot, getFrequency() and ageFrequency().
+template <typename T>
+class clock_ring_t {
+public:
+    static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+    // capacity: number of entries the cache holds
+    clock_ring_t(uint64_t capacity) {
+        _size = capacity + capacity / 2 + 64;
+        _slots = new std::atomic<T*> [_size];
+        for (uint64_t i=0; i<_size; i++)
+            _slots[i].store(nullptr, std::memory_order_relaxed);
+        _hand.store(0);
+    }
+
+    ~clock_ring_t() { delete[] _slots; }
+
+    // puts an entry into the first free slot from hint (e.g., the slot of the last victim)
+    // returns false if the ring is full; the entry is then never selected as a victim
+    bool add(T* entry, uint64_t hint) {
+        uint64_t idx = hint % _size;
+        for (uint64_t i=0; i<_size; i++) {
+            T* expected = nullptr;
+            if (_slots[idx].load(std::memory_order_relaxed) == nullptr) {
+                entry->clock_slot.store(idx);
+                if (_slots[idx].compare_exchange_strong(expected, entry))
+                    return true;
+            }
+            idx = (idx + 1 == _size) ? 0 : idx + 1;
+        }
+        entry->clock_slot.store(INVALID_SLOT);
+        return false;
+    }
+
+    // takes an entry out of the ring; a no-op if it has never been added or is already removed
+    void remove(T* entry) {
+        uint32_t idx = entry->clock_slot.load();
+        if (idx == INVALID_SLOT)
+            return;
+        T* expected = entry;
+        _slots[idx].compare_exchange_strong(expected, nullptr);
+    }
+
+    // advances the hand to the next entry whose frequency has aged to zero
+    // returns nullptr only if the ring is empty
+    T* next_victim() {
+        // every frequency bit is worth one sweep; after that the ring has no entries
+        for (uint64_t i=0; i<_size*17; i++) {
+            uint64_t idx = _hand.fetch_add(1, std::memory_order_relaxed) % _size;
+            T* entry = _slots[idx].load();
+            if (entry == nullptr)
+                continue;
+            if (!entry->ageFrequency())
+                return entry;
+        }
+        return nullptr;
+    }
+
+    // the first entry from the given position, without moving the hand or aging anything
+    // (e.g., a random resident entry for admission)
+    T* peek(uint64_t start) {
+        uint64_t idx = start % _size;
+        for (uint64_t i=0; i<_size; i++) {
+            T* entry = _slots[idx].load();
+            if (entry != nullptr)
+                return entry;
+            idx = (idx + 1 == _size) ? 0 : idx + 1;
+        }
+        return nullptr;
+    }
+
+private:
+    std::atomic<T*>*      _slots;
+    uint64_t              _size;
+    std::atomic<uint64_t> _hand;
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Count-min sketch of 4-bit counters for TinyLFU admission (as in Caffeine).
+// Each key maps to one counter in each of 4 rows; its frequency is the minimum of them.
+// Once the number of recorded accesses reaches 10x the number of cached entries,
+// all counters are halved so that the sketch follows changes of the popularity (aging).
+// Increments saturate at 15 with a CAS, so a racing increment never carries into the next counter;
+// aging is relaxed and may lose concurrent increments, the sketch only has to be approximately right.
+class frequency_sketch_t {
+public:
+    // capacity: number of entries the cache holds
+    frequency_sketch_t(uint64_t capacity) {
+        _num_words = 64;
+        while (_num_words < capacity)
+            _num_words <<= 1;
+        _mask = _num_words - 1;
+        _table = new std::atomic<uint64_t> [_num_words];
+        for (uint64_t i=0; i<_num_words; i++)
+            _table[i].store(0, std::memory_order_relaxed);
+        _sample_size = 10 * (capacity > 0 ? capacity : 1);
+        _additions.store(0);
+    }
+
+    ~frequency_sketch_t() { delete[] _table; }
+
+    // records an access to the key
+    void increment(uint64_t key) {
+        uint64_t hash = spread(key);
+        bool added = false;
+        for (uint32_t i=0; i<NUM_ROWS; i++) {
+            auto& word = _table[index_of(hash, i)];
+            uint32_t offset = offset_of(hash, i);
+            uint64_t value = word.load(std::memory_order_relaxed);
+            while (((value >> offset) & 0xf) != 0xf) { // a failed CAS reloads the word
+                if (word.compare_exchange_weak(value, value + (1ULL << offset), std::memory_order_relaxed)) {
+                    added = true;
+                    break;
+                }
+            }
+        }
+        if (added && _additions.fetch_add(1, std::memory_order_relaxed) + 1 == _sample_size)
+            reset();
+    }
+
+    // estimated number of accesses to the key (at most 15)
+    uint32_t estimate(uint64_t key) {
+        uint64_t hash = spread(key);
+        uint32_t freq = 0xf;
+        for (uint32_t i=0; i<NUM_ROWS; i++) {
+            uint64_t value = _table[index_of(hash, i)].load(std::memory_order_relaxed);
+            uint32_t count = (value >> offset_of(hash, i)) & 0xf;
+            if (count < freq)
+                freq = count;
+        }
+        return freq;
+    }
+
+    // raw words of 16 counters (for tests)
+    uint64_t get_num_words() const        { return _num_words; }
+    uint64_t get_word(uint64_t idx) const { return _table[idx].load(std::memory_order_relaxed); }
+
+    // mixes the bits of a key (murmur3 finalizer)
+    static uint64_t spread(uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return key;
+    }
+
+private:
+    static constexpr uint32_t NUM_ROWS = 4;
+
+    // halves all counters
+    void reset() {
+        for (uint64_t i=0; i<_num_words; i++) {
+            uint64_t value = _table[i].load(std::memory_order_relaxed);
+            _table[i].store((value >> 1) & 0x7777777777777777ULL, std::memory_order_relaxed);
+        }
+        _additions.store(_sample_size / 2, std::memory_order_relaxed);
+    }
+
+    uint64_t index_of(uint64_t hash, uint32_t row) {
+        static constexpr uint64_t SEEDS[NUM_ROWS] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+                                                     0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL};
+        uint64_t h = (hash + SEEDS[row]) * SEEDS[row];
+        return (h + (h >> 32)) & _mask;
+    }
+
+    // each row uses its own quarter of the 16 counters of a word
+    static uint32_t offset_of(uint64_t hash, uint32_t row) {
+        return ((row << 2) + ((hash >> (row << 3)) & 3)) << 2;
+    }
+
+    std::atomic<uint64_t>* _table;
+    uint64_t               _num_words;
+    uint64_t               _mask;
+    uint64_t               _sample_size;
+    std::atomic<uint64_t>  _additions;
+};
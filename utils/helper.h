@@ -47,6 +47,7 @@
 //////////////////////////////////////////////////
 #define GET_WORKLOAD global_manager->get_workload()
 #define GET_THD_ID global_manager->get_tid()
+#define GET_QP_ID global_manager->get_qp_id()
 #define GET_TRANSPORT global_manager->get_transport()
 #define GET_BATCH_TABLE global_manager->get_batch_table()
 
@@ -161,6 +162,16 @@
     if (STATS_ENABLE) \
         stats->_stats[GET_THD_ID]->_int_stats[STAT_##name] += value;
 
+// records a sample in the latency histogram of the thread
+#define INC_LATENCY_STATS(name, value) \
+    if (STATS_ENABLE && COLLECT_LATENCY) \
+        stats->_stats[GET_THD_ID]->_latency_stats[LAT_##name].add(value);
+
+// accumulates the time of a phase and records it in its latency histogram
+#define INC_TIME_STATS(name, value) { \
+    INC_FLOAT_STATS(name, value) \
+    INC_LATENCY_STATS(name, value) }
+
 #define CLEAR_STATS() \
     if (STATS_ENABLE) \
         stats->clear(GET_THD_ID);
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// Fixed-size log-linear (HDR-style) histogram of latencies in ns.
+// Values below 2^SUB_BITS are kept exactly; above that, each power of two is split into
+// 2^SUB_BITS linear sub-buckets, so the relative error is bounded by 2^-SUB_BITS (~3%).
+// Histograms of different threads (or windows) are combined with merge() and subtract().
+class latency_hist_t {
+public:
+    static constexpr uint32_t SUB_BITS    = 5;
+    static constexpr uint32_t SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr uint32_t MAX_BITS    = 36; // ~68 sec; larger values go to the last bucket
+    static constexpr uint32_t NUM_BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+    latency_hist_t() { clear(); }
+
+    void clear() {
+        memset(_counts, 0, sizeof(_counts));
+        _total = 0;
+    }
+
+    void add(uint64_t value) {
+        _counts[get_index(value)]++;
+        _total++;
+    }
+
+    void merge(const latency_hist_t& other) {
+        for (uint32_t i=0; i<NUM_BUCKETS; i++)
+            _counts[i] += other._counts[i];
+        _total += other._total;
+    }
+
+    // other is an earlier snapshot of this histogram; buckets that were cleared since then become empty
+    void subtract(const latency_hist_t& other) {
+        _total = 0;
+        for (uint32_t i=0; i<NUM_BUCKETS; i++) {
+            _counts[i] = (_counts[i] > other._counts[i]) ? _counts[i] - other._counts[i] : 0;
+            _total += _counts[i];
+        }
+    }
+
+    uint64_t get_total() const               { return _total; }
+    uint64_t get_count(uint32_t idx) const   { return _counts[idx]; }
+    // representative value of a bucket (its middle)
+    static uint64_t get_value(uint32_t idx)  { return get_lower(idx) + get_width(idx) / 2; }
+
+    // value at the given percentile (0 < p <= 1), reported as the middle of its bucket
+    uint64_t get_percentile(double p) const {
+        if (_total == 0)
+            return 0;
+        if (p >= 1.0)
+            return get_max();
+        uint64_t rank = (uint64_t)(p * _total);
+        if (rank == 0) rank = 1;
+        uint64_t cnt = 0;
+        for (uint32_t i=0; i<NUM_BUCKETS; i++) {
+            cnt += _counts[i];
+            if (cnt >= rank)
+                return get_value(i);
+        }
+        return get_max();
+    }
+
+    uint64_t get_max() const {
+        for (int i=NUM_BUCKETS-1; i>=0; i--) {
+            if (_counts[i] > 0)
+                return get_lower(i) + get_width(i) - 1;
+        }
+        return 0;
+    }
+
+private:
+    static uint32_t get_index(uint64_t value) {
+        if (value < SUB_BUCKETS)
+            return value;
+        uint32_t msb = 63 - __builtin_clzll(value);
+        if (msb >= MAX_BITS)
+            return NUM_BUCKETS - 1;
+        uint32_t shift = msb - SUB_BITS;
+        return ((shift + 1) << SUB_BITS) + ((value >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    static uint64_t get_lower(uint32_t idx) {
+        if (idx < SUB_BUCKETS)
+            return idx;
+        uint32_t shift = (idx >> SUB_BITS) - 1;
+        return (uint64_t)(SUB_BUCKETS + (idx & (SUB_BUCKETS - 1))) << shift;
+    }
+
+    static uint64_t get_width(uint32_t idx) {
+        if (idx < SUB_BUCKETS)
+            return 1;
+        return 1ULL << ((idx >> SUB_BITS) - 1);
+    }
+
+    uint64_t _counts[NUM_BUCKETS];
+    uint64_t _total;
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include "utils/frequency_sketch.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Hot-key replication for skewed partitions (NUM_HOT_KEYS).
+// The memory server samples the accesses it serves into a count-min sketch sized for NUM_HOT_KEYS keys;
+// a key is hot while its counter is saturated, i.e., while it takes more than about 1/NUM_HOT_KEYS of
+// the sampled accesses, so at most NUM_HOT_KEYS keys are hot at a time. The server flags hot keys in its
+// responses and the compute node keeps them in a hot set, whose keys its cache always admits.
+class hot_key_detector_t {
+public:
+    static constexpr uint32_t SAMPLE = 8; // one in SAMPLE accesses of a thread goes into the sketch
+
+    hot_key_detector_t(uint64_t num_hot, uint32_t num_threads) : _sketch(num_hot), _counts(num_threads) { }
+
+    // records an access to the key by thread tid; true if the key is hot
+    bool access(uint64_t key, uint32_t tid) {
+        uint32_t& count = _counts[tid].count;
+        if (++count == SAMPLE) {
+            count = 0;
+            _sketch.increment(key);
+        }
+        return _sketch.estimate(key) == MAX_FREQUENCY;
+    }
+
+private:
+    static constexpr uint32_t MAX_FREQUENCY = 0xf;
+
+    struct alignas(64) thread_count_t { // padded, as each thread updates its own
+        uint32_t count = 0;
+    };
+
+    frequency_sketch_t _sketch;
+    std::vector<thread_count_t> _counts; // sampling counter of each thread, per detector
+};
+
+// Keys the memory server has reported as hot, in a direct-mapped table (a report may replace another key).
+class hot_key_set_t {
+public:
+    hot_key_set_t(uint64_t num_hot) {
+        _size = 64;
+        while (_size < 4 * num_hot)
+            _size <<= 1;
+        _slots = new std::atomic<uint64_t> [_size];
+        for (uint64_t i=0; i<_size; i++)
+            _slots[i].store(INVALID_KEY, std::memory_order_relaxed);
+    }
+
+    ~hot_key_set_t() { delete[] _slots; }
+
+    void insert(uint64_t key) {
+        auto& slot = _slots[frequency_sketch_t::spread(key) & (_size - 1)];
+        if (slot.load(std::memory_order_relaxed) != key)
+            slot.store(key, std::memory_order_relaxed);
+    }
+
+    bool contains(uint64_t key) {
+        return _slots[frequency_sketch_t::spread(key) & (_size - 1)].load(std::memory_order_relaxed) == key;
+    }
+
+private:
+    static constexpr uint64_t INVALID_KEY = UINT64_MAX;
+
+    std::atomic<uint64_t>* _slots;
+    uint64_t               _size;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include "config.h"
 #include <sys/mman.h>
 #include <memory.h>
 #include <iostream>
@@ -7,6 +8,11 @@ inline void* huge_page_alloc(uint64_t size){
     int access_flags = PROT_READ | PROT_WRITE;
     int map_flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
     void* addr = mmap(NULL, size, access_flags, map_flags, -1, 0);
+#if TRANSPORT_BACKEND == SHM
+    // loopback runs (e.g., CI) may not have huge pages reserved
+    if(addr == MAP_FAILED)
+        addr = mmap(NULL, size, access_flags, map_flags & ~MAP_HUGETLB, -1, 0);
+#endif
     if(addr == MAP_FAILED) {
         std::cerr << "Huge page allocation failed ( " << size / 1024 / 1024 << " MB)" << std::endl;
         return nullptr;
@@ -0,0 +1,49 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+
+// vector that keeps its first N elements inline and spills to the heap beyond that
+// clear() keeps the spilled buffer, so a reused owner (e.g., a pooled txn) stops allocating after warm-up
+// like std::vector, growing invalidates pointers to the elements
+template <typename T, uint32_t N>
+class inline_vector_t {
+public:
+    inline_vector_t() : _data(_inline), _size(0), _capacity(N) { }
+    ~inline_vector_t() {
+        if (_data != _inline)
+            delete[] _data;
+    }
+    inline_vector_t(const inline_vector_t&) = delete;
+    inline_vector_t& operator=(const inline_vector_t&) = delete;
+
+    void push_back(const T& value) {
+        if (_size == _capacity)
+            grow();
+        _data[_size++] = value;
+    }
+
+    void clear()             { _size = 0; }
+    uint32_t size() const    { return _size; }
+    bool empty() const       { return _size == 0; }
+
+    T& operator[](uint32_t idx) { assert(idx < _size); return _data[idx]; }
+    T& back()                   { assert(_size > 0); return _data[_size - 1]; }
+    T* begin()                  { return _data; }
+    T* end()                    { return _data + _size; }
+
+private:
+    void grow() {
+        auto data = new T[_capacity * 2];
+        for (uint32_t i=0; i<_size; i++)
+            data[i] = _data[i];
+        if (_data != _inline)
+            delete[] _data;
+        _data = data;
+        _capacity *= 2;
+    }
+
+    T        _inline[N];
+    T*       _data;
+    uint32_t _size;
+    uint32_t _capacity;
+};
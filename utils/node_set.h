@@ -0,0 +1,38 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+
+// set of node ids kept in a bitmap (node ids are smaller than MAX_NODES)
+// iterates in ascending order like std::set<uint32_t>
+class node_set_t {
+public:
+    static constexpr uint32_t MAX_NODES = 64;
+
+    class iterator {
+    public:
+        iterator(uint64_t bits) : _bits(bits) { }
+        uint32_t  operator*() const                  { return __builtin_ctzll(_bits); }
+        iterator& operator++()                       { _bits &= _bits - 1; return *this; }
+        bool      operator!=(const iterator& o) const { return _bits != o._bits; }
+    private:
+        uint64_t _bits;
+    };
+
+    node_set_t() : _bits(0) { }
+
+    void insert(uint32_t node_id) {
+        assert(node_id < MAX_NODES);
+        _bits |= 1ULL << node_id;
+    }
+    void     erase(uint32_t node_id)      { _bits &= ~(1ULL << node_id); }
+    bool     contains(uint32_t node_id)   { return _bits & (1ULL << node_id); }
+    void     clear()                      { _bits = 0; }
+    uint32_t size() const                 { return __builtin_popcountll(_bits); }
+    bool     empty() const                { return _bits == 0; }
+
+    iterator begin() const { return iterator(_bits); }
+    iterator end() const   { return iterator(0); }
+
+private:
+    uint64_t _bits;
+};
@@ -0,0 +1,111 @@
+#include "utils/numa.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+namespace numa {
+
+namespace {
+
+struct topology_t {
+    // cpus of each socket
+    std::vector<std::vector<uint32_t>> cpus;
+
+    topology_t() {
+        for (uint32_t node=0; ; node++) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!file.is_open())
+                break;
+            std::string list;
+            std::getline(file, list);
+            cpus.push_back(parse(list));
+        }
+        if (cpus.empty()) {
+            cpus.emplace_back();
+            for (uint32_t i=0; i<std::thread::hardware_concurrency(); i++)
+                cpus[0].push_back(i);
+        }
+    }
+
+    // e.g., "0-3,8-11"
+    static std::vector<uint32_t> parse(const std::string& list) {
+        std::vector<uint32_t> ret;
+        size_t pos = 0;
+        while (pos < list.size()) {
+            size_t end = list.find(',', pos);
+            if (end == std::string::npos)
+                end = list.size();
+            auto range = list.substr(pos, end - pos);
+            auto dash = range.find('-');
+            if (!range.empty()) {
+                uint32_t from = std::stoul(range.substr(0, dash));
+                uint32_t to = (dash == std::string::npos) ? from : std::stoul(range.substr(dash + 1));
+                for (uint32_t i=from; i<=to; i++)
+                    ret.push_back(i);
+            }
+            pos = end + 1;
+        }
+        return ret;
+    }
+};
+
+const topology_t& get_topology() {
+    static topology_t topology;
+    return topology;
+}
+
+thread_local uint32_t thread_socket = 0;
+
+}
+
+uint32_t get_num_sockets() {
+    return get_topology().cpus.size();
+}
+
+uint32_t get_socket_of(uint64_t idx, uint64_t num) {
+    uint32_t num_sockets = get_num_sockets();
+    if (num == 0 || idx >= num)
+        return num_sockets - 1;
+    return idx * num_sockets / num;
+}
+
+uint32_t bind_thread(uint32_t idx, uint32_t num) {
+    auto& topology = get_topology();
+    uint32_t socket = get_socket_of(idx, num);
+    // rank of this thread among the threads of its socket
+    uint32_t first = 0;
+    while (get_socket_of(first, num) != socket)
+        first++;
+    auto& cpus = topology.cpus[socket];
+    if (!cpus.empty()) {
+        uint32_t cpu = cpus[(idx - first) % cpus.size()];
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(cpu, &cpuset);
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        if (rc != 0)
+            std::cerr << "Failed to bind core at " << cpu << std::endl;
+    }
+
+    if (topology.cpus.size() > 1) {
+        // allocations of this thread are served from its socket first (falls back to others when full)
+        unsigned long mask[4] = {0};
+        mask[socket / 64] |= 1UL << (socket % 64);
+        if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, sizeof(mask) * 8 + 1) != 0)
+            std::cerr << "Failed to set memory policy to socket " << socket << std::endl;
+    }
+    thread_socket = socket;
+    return socket;
+}
+
+uint32_t get_thread_socket() {
+    return thread_socket;
+}
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+// NUMA placement of memory-server threads (NUMA_AWARE).
+// The sockets (NUMA nodes) and their cpus are read from /sys/devices/system/node;
+// a machine without NUMA information is treated as a single socket.
+// Threads, partitions and their rows are spread over the sockets in contiguous blocks,
+// so the idx-th of num threads (or keys) belongs to socket idx * num_sockets / num.
+namespace numa {
+
+uint32_t get_num_sockets();
+uint32_t get_socket_of(uint64_t idx, uint64_t num);
+
+// pins the calling thread to a cpu of its socket and makes the socket its preferred memory node,
+// so that rows and index nodes it allocates (and first touches) stay local; returns the socket
+uint32_t bind_thread(uint32_t idx, uint32_t num);
+// socket of the calling thread (0 if it has not been bound)
+uint32_t get_thread_socket();
+
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+#include <sys/mman.h>
+
+// Fixed-capacity pool of objects carved out of one hugepage-backed arena.
+// Objects are laid out at a power-of-two stride (up to a cache line), so none straddles two cache lines.
+// Each thread recycles freed objects through its own free list (padded to a cache line); lists that grow
+// beyond 2 * REFILL_BATCH objects hand a batch over to a shared list, from which empty lists are refilled.
+// Objects that do not fit in the arena are allocated from the heap (and freed back to it).
+template <typename T>
+class object_pool_t {
+public:
+    static constexpr uint32_t REFILL_BATCH = 64;
+
+    object_pool_t(uint64_t capacity, uint32_t num_threads) : _threads(num_threads) {
+        _stride = 8;
+        while (_stride < sizeof(T) && _stride < 64)
+            _stride <<= 1;
+        if (_stride < sizeof(T)) // larger than a cache line
+            _stride = (sizeof(T) + 63) & ~63ULL;
+        _size = (capacity * _stride + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        // fall back to transparent huge pages when no huge pages are reserved
+        void* addr = mmap(NULL, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr == MAP_FAILED) {
+            addr = mmap(NULL, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (addr != MAP_FAILED)
+                madvise(addr, _size, MADV_HUGEPAGE);
+        }
+        if (addr == MAP_FAILED) { // everything comes from the heap
+            _base = nullptr;
+            _size = 0;
+        }
+        else
+            _base = reinterpret_cast<char*>(addr);
+        _capacity = _size / _stride;
+        _next.store(0);
+    }
+
+    ~object_pool_t() {
+        if (_base)
+            munmap(_base, _size);
+    }
+
+    template <typename... Args>
+    T* alloc(uint32_t tid, Args&&... args) {
+        void* mem = get(tid);
+        if (mem == nullptr)
+            return new T(std::forward<Args>(args)...);
+        return new (mem) T(std::forward<Args>(args)...);
+    }
+
+    void free(uint32_t tid, T* p) {
+        char* mem = reinterpret_cast<char*>(p);
+        if (mem < _base || mem >= _base + _size) {
+            delete p;
+            return;
+        }
+        p->~T();
+        auto& local = _threads[tid];
+        push(local.head, mem);
+        if (++local.count >= 2 * REFILL_BATCH) {
+            std::lock_guard<std::mutex> guard(_latch);
+            for (uint32_t i=0; i<REFILL_BATCH; i++)
+                push(_shared, pop(local.head));
+            local.count -= REFILL_BATCH;
+        }
+    }
+
+    uint64_t get_capacity()  { return _capacity; }
+    uint64_t get_footprint() { return _size; }
+
+private:
+    static constexpr uint64_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    struct alignas(64) thread_list_t {
+        char*    head = nullptr; // freed objects, linked through their first word
+        uint64_t count = 0;
+    };
+
+    static void push(char*& head, char* mem) {
+        *reinterpret_cast<char**>(mem) = head;
+        head = mem;
+    }
+
+    static char* pop(char*& head) {
+        char* mem = head;
+        head = *reinterpret_cast<char**>(mem);
+        return mem;
+    }
+
+    // memory for one object; nullptr if the arena is used up
+    void* get(uint32_t tid) {
+        auto& local = _threads[tid];
+        if (local.head == nullptr) {
+            // objects that have never been handed out come first
+            if (_next.load(std::memory_order_relaxed) < _capacity) {
+                uint64_t idx = _next.fetch_add(1);
+                if (idx < _capacity)
+                    return _base + idx * _stride;
+            }
+            std::lock_guard<std::mutex> guard(_latch);
+            for (uint32_t i=0; i<REFILL_BATCH && _shared != nullptr; i++) {
+                push(local.head, pop(_shared));
+                local.count++;
+            }
+            if (local.head == nullptr)
+                return nullptr;
+        }
+        local.count--;
+        return pop(local.head);
+    }
+
+    char*                      _base;
+    uint64_t                   _size;
+    uint64_t                   _stride;
+    uint64_t                   _capacity;
+    std::atomic<uint64_t>      _next;      // first object that has never been handed out
+    std::vector<thread_list_t> _threads;
+    std::mutex                 _latch;     // protects the shared list
+    char*                      _shared = nullptr;
+};
@@ -28,9 +28,13 @@ struct options_t{
     bool partitioned = false;
     uint32_t num_server_threads = g_num_server_threads;
     uint32_t num_client_threads = g_num_client_threads;
+    uint32_t num_client_coros = g_num_client_coros;
     uint64_t cache_size = g_cache_size;
     double admission_rate = g_admission_rate; 
     double rpc_rate = g_rpc_rate; // dex
+#if TRANSPORT_BACKEND == SHM
+    uint32_t node_id = 0; // loopback nodes share a hostname
+#endif
 };
 
 std::ostream& operator<<(std::ostream& os, const options_t& opt){
@@ -58,8 +62,10 @@ std::ostream& operator<<(std::ostream& os, const options_t& opt){
        << "\tCache admission rate: " << g_admission_rate << std::endl;
        if (g_is_server)
            os << "\tNumber of Threads:    " << g_num_server_threads << std::endl;
-       else
+       else {
            os << "\tNumber of Threads:    " << g_num_client_threads << std::endl;
+           os << "\tCoroutines/thread:    " << g_num_client_coros << std::endl;
+       }
     return os;
 }
 
@@ -134,6 +140,18 @@ bool validate(options_t& opt) {
             valid = false;
         }
 
+        if (opt.num_client_coros == 0 || opt.num_client_coros > MAX_NUM_COROS) {
+            std::cout << "Number of coroutines should be between [1, " << MAX_NUM_COROS << "]: " << opt.num_client_coros << std::endl;
+            valid = false;
+        }
+
+        #if BATCH
+        if (opt.num_client_coros > 1) {
+            std::cout << "Coroutines cannot be combined with batching: " << opt.num_client_coros << std::endl;
+            valid = false;
+        }
+        #endif
+
         if (opt.admission_rate < 0 || opt.admission_rate > 1.0) {
             std::cout << "Cache admission rate should be between [0, 1]: " << opt.admission_rate << std::endl;
             valid = false;
@@ -174,9 +192,13 @@ void parse_args(int argc, char* argv[]){
 	    #endif
             ("server_threads", "Number of server threads", cxxopts::value<uint32_t>()->default_value(std::to_string(opt.num_server_threads)))
             ("client_threads", "Number of client threads", cxxopts::value<uint32_t>()->default_value(std::to_string(opt.num_client_threads)))
+            ("coros", "Number of coroutines (in-flight txns) per client thread", cxxopts::value<uint32_t>()->default_value(std::to_string(opt.num_client_coros)))
             ("cache", "Index cache size (MB)", cxxopts::value<uint64_t>()->default_value(std::to_string(opt.cache_size)))
             ("admission", "Cache admission rate", cxxopts::value<double>()->default_value(std::to_string(opt.admission_rate)))
             ("rpc", "Index pushdown (RPC) rate", cxxopts::value<double>()->default_value(std::to_string(opt.rpc_rate)))
+        #if TRANSPORT_BACKEND == SHM
+            ("node", "Node ID (shared-memory loopback transport)", cxxopts::value<uint32_t>()->default_value(std::to_string(opt.node_id)))
+        #endif
             ("help", "Print help")
             ;
 
@@ -218,6 +240,8 @@ void parse_args(int argc, char* argv[]){
             if (g_is_server) opt.num_server_threads = result["threads"].as<uint32_t>();
             else opt.num_client_threads = result["threads"].as<uint32_t>();
         } 
+        if (result.count("coros"))
+            opt.num_client_coros = result["coros"].as<uint32_t>();
         if (result.count("partition"))
             opt.partitioned = result["partition"].as<bool>();
         if (result.count("cache"))
@@ -226,6 +250,10 @@ void parse_args(int argc, char* argv[]){
             opt.admission_rate = result["admission"].as<double>();
         if (result.count("rpc"))
             opt.rpc_rate = result["rpc"].as<double>();
+#if TRANSPORT_BACKEND == SHM
+        if (result.count("node"))
+            opt.node_id = result["node"].as<uint32_t>();
+#endif
         
         if (!validate(opt)) {
             std::cout << "Invalid options detected:" << std::endl;
@@ -265,6 +293,11 @@ void parse_args(int argc, char* argv[]){
     g_rpc_rate = opt.rpc_rate;
     g_num_client_threads = opt.num_client_threads;
     g_num_server_threads = opt.num_server_threads;
+    g_num_client_coros = opt.num_client_coros;
+    g_num_client_qps = g_num_client_threads * g_num_client_coros; // each coroutine owns a QP
+#if TRANSPORT_BACKEND == SHM
+    g_node_id = opt.node_id;
+#endif
     if (g_is_server) g_total_num_threads = opt.num_server_threads;
     else g_total_num_threads = opt.num_client_threads;
     g_init_parallelism = g_total_num_threads;
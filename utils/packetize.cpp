@@ -18,6 +18,29 @@ UnstructuredBuffer::get(char * &data, uint32_t size) {
     _pos += size;
 }
 
+void
+UnstructuredBuffer::put_varint(uint64_t value) {
+    char bytes[10];
+    uint32_t n = 0;
+    while (value >= 0x80) {
+        bytes[n++] = static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    bytes[n++] = static_cast<char>(value);
+    put(bytes, n);
+}
+
+uint64_t
+UnstructuredBuffer::get_varint() {
+    assert(_buf);
+    uint64_t value = 0;
+    for (uint32_t shift = 0; ; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(_buf[_pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+}
 
 uint32_t
 UnstructuredBuffer::size() {
@@ -19,11 +19,19 @@ public:
     template<class T> void put(T * data);
     template<class T> void get(T * data);
 
+    // in place: a T at the current position of a raw buffer, written or read by the caller
+    template<class T> T* put_ptr();
+    template<class T> T* get_ptr();
+
     template<class T> void put_front(T * data);
     template<class T> void put_at(T * data, uint32_t pos);
 
     void put(char * data, uint32_t size);
     void get(char * &data, uint32_t size);
+
+    // LEB128: 7 bits per byte, low bits first
+    void     put_varint(uint64_t value);
+    uint64_t get_varint();
 };
 
 template<class T>
@@ -43,6 +51,22 @@ void UnstructuredBuffer::get(T * data) {
     _pos += sizeof(T);
 }
 
+template<class T>
+T* UnstructuredBuffer::put_ptr() {
+    assert(_buf);
+    T* ptr = reinterpret_cast<T*>(_buf + _pos);
+    _pos += sizeof(T);
+    return ptr;
+}
+
+template<class T>
+T* UnstructuredBuffer::get_ptr() {
+    assert(_buf);
+    T* ptr = reinterpret_cast<T*>(_buf + _pos);
+    _pos += sizeof(T);
+    return ptr;
+}
+
 template<class T>
 void UnstructuredBuffer::put_front(T * data) {
     put_at(data, 0);
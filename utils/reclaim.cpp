@@ -0,0 +1,117 @@
+#include "utils/reclaim.h"
+#include "utils/epoch.h"
+#include "system/global.h"
+#include "utils/helper.h"
+#include <vector>
+
+namespace reclaim {
+
+namespace {
+
+// retirements between two advances of the global epoch
+constexpr uint64_t RECLAIM_BATCH = 64;
+
+struct retired_t {
+    void*            ptr;
+    uint64_t         size;
+    deleter_t        deleter;
+    void*            ctx;
+    cachepush::Epoch epoch;
+    uint64_t         time; // of retirement
+};
+
+struct thread_list_t {
+    std::vector<retired_t> list; // in the order of retirement, hence of epochs
+    uint64_t bytes = 0;
+    uint64_t since_bump = 0;
+    uint32_t depth = 0;
+};
+
+// a single manager: MinEpochTable keeps the entry of a thread in one thread_local for all managers
+cachepush::EpochManager* get_epoch_manager() {
+    static cachepush::EpochManager* manager = [] {
+        auto m = new cachepush::EpochManager();
+        m->Initialize();
+        return m;
+    }();
+    return manager;
+}
+
+thread_list_t& get_thread_list() {
+    static thread_local thread_list_t list;
+    return list;
+}
+
+void record_footprint(uint64_t bytes) {
+    if (!STATS_ENABLE || !stats)
+        return;
+    auto& max_bytes = stats->_stats[GET_THD_ID]->_int_stats[STAT_max_retired_bytes];
+    if (bytes > max_bytes)
+        max_bytes = bytes;
+}
+
+// lag: time the oldest freed object has waited since its retirement
+void record_reclaimed(uint64_t bytes, uint64_t lag) {
+    if (!STATS_ENABLE || !stats)
+        return;
+    auto int_stats = stats->_stats[GET_THD_ID]->_int_stats;
+    int_stats[STAT_bytes_reclaimed] += bytes;
+    lag /= 1000; // in us
+    if (lag > int_stats[STAT_max_reclaim_lag])
+        int_stats[STAT_max_reclaim_lag] = lag;
+}
+
+// frees everything that no reader can reach anymore
+void collect(thread_list_t& local) {
+    auto safe_epoch = get_epoch_manager()->GetReclaimEpoch();
+    uint64_t freed = 0;
+    size_t idx = 0;
+    for (; idx<local.list.size() && local.list[idx].epoch <= safe_epoch; idx++) {
+        local.list[idx].deleter(local.list[idx].ptr, local.list[idx].ctx);
+        freed += local.list[idx].size;
+    }
+    if (idx > 0) {
+        record_reclaimed(freed, get_sys_clock() - local.list[0].time);
+        local.bytes -= freed;
+        local.list.erase(local.list.begin(), local.list.begin() + idx);
+    }
+}
+
+}
+
+void enter() {
+    auto& local = get_thread_list();
+    if (local.depth++ == 0)
+        get_epoch_manager()->Protect();
+}
+
+void exit() {
+    auto& local = get_thread_list();
+    assert(local.depth > 0);
+    if (--local.depth > 0)
+        return;
+    get_epoch_manager()->Unprotect();
+    if (local.bytes > RECLAIM_THRESHOLD) {
+        get_epoch_manager()->BumpCurrentEpoch();
+        collect(local);
+    }
+}
+
+void retire(void* ptr, uint64_t size, deleter_t deleter, void* ctx) {
+    auto manager = get_epoch_manager();
+    auto& local = get_thread_list();
+    local.list.push_back({ptr, size, deleter, ctx, manager->GetCurrentEpoch(), get_sys_clock()});
+    local.bytes += size;
+    record_footprint(local.bytes);
+    if (++local.since_bump >= RECLAIM_BATCH || local.bytes > RECLAIM_THRESHOLD) {
+        local.since_bump = 0;
+        manager->BumpCurrentEpoch();
+        collect(local);
+    }
+}
+
+uint64_t get_retired_bytes() {
+    return get_thread_list().bytes;
+}
+
+}
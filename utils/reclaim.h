@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+
+// Epoch-based reclamation (on top of cachepush::EpochManager) of objects that concurrent
+// readers may still reach after they are unlinked, e.g., entries evicted from the index cache.
+// Readers stay inside a guard_t while they hold pointers to such objects; an unlinked object
+// is retired and freed once every thread that was inside a guard at that time has left it.
+// Each thread keeps its own retire list and advances the global epoch every RECLAIM_BATCH
+// retirements; once the list holds more than RECLAIM_THRESHOLD bytes, the thread tries to
+// reclaim on every retirement and whenever it leaves its outermost guard.
+// Used by the two-sided cache managers and by the Sherman/Deft IndexCache (whose rcu hooks are guards).
+// Stats: max_retired_bytes, bytes_reclaimed and max_reclaim_lag (retirement to free).
+namespace reclaim {
+
+typedef void (*deleter_t)(void* ptr, void* ctx);
+
+// guards can be nested; only the outermost one protects the epoch
+void enter();
+void exit();
+
+// frees ptr with deleter(ptr, ctx) once no reader can reach it; size counts towards the retired footprint
+void retire(void* ptr, uint64_t size, deleter_t deleter, void* ctx=nullptr);
+
+template <typename T>
+void retire(T* ptr) {
+    retire(ptr, sizeof(T), [](void* p, void*) { delete static_cast<T*>(p); });
+}
+
+// bytes retired by the calling thread and not freed yet
+uint64_t get_retired_bytes();
+
+class guard_t {
+public:
+    guard_t()  { enter(); }
+    ~guard_t() { exit(); }
+};
+
+}
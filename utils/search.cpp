@@ -0,0 +1,122 @@
+#include "utils/search.h"
+#include <immintrin.h>
+#include <climits>
+
+namespace search {
+
+static std::atomic<isa_t> isa(SCALAR);
+
+static inline uint64_t get_key(const char* base, uint32_t stride, unsigned idx) {
+    return *reinterpret_cast<const uint64_t*>(base + (uint64_t)idx * stride);
+}
+
+static unsigned lower_bound_scalar(const char* base, uint32_t stride, unsigned count, uint64_t key) {
+    for (unsigned i=0; i<count; i++) {
+        if (key <= get_key(base, stride, i))
+            return i;
+    }
+    return count;
+}
+
+// 4 keys per iteration; there is no unsigned 64-bit compare in AVX2, so the sign bits are flipped
+__attribute__((target("avx2")))
+static unsigned lower_bound_avx2(const char* base, uint32_t stride, unsigned count, uint64_t key) {
+    const __m256i sign = _mm256_set1_epi64x(LLONG_MIN);
+    const __m256i k = _mm256_xor_si256(_mm256_set1_epi64x(key), sign);
+    const __m256i offsets = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+    unsigned i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const char* ptr = base + (uint64_t)i * stride;
+        __m256i keys;
+        if (stride == 16) { // key-value pairs: keys are the even words of two vectors
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + 32));
+            keys = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+        }
+        else
+            keys = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(ptr), offsets, 1);
+        // bit j is set if keys[j] < key
+        __m256i lt = _mm256_cmpgt_epi64(k, _mm256_xor_si256(keys, sign));
+        unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(lt));
+        if (mask != 0xf)
+            return i + __builtin_ctz(~mask);
+    }
+    for (; i<count; i++) {
+        if (key <= get_key(base, stride, i))
+            return i;
+    }
+    return count;
+}
+
+// 8 keys per iteration
+__attribute__((target("avx512f")))
+static unsigned lower_bound_avx512(const char* base, uint32_t stride, unsigned count, uint64_t key) {
+    const __m512i k = _mm512_set1_epi64(key);
+    const __m512i even = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+    const __m512i offsets = _mm512_set_epi64(7 * stride, 6 * stride, 5 * stride, 4 * stride,
+                                             3 * stride, 2 * stride, stride, 0);
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const char* ptr = base + (uint64_t)i * stride;
+        __m512i keys;
+        if (stride == 16) {
+            __m512i lo = _mm512_loadu_si512(ptr);
+            __m512i hi = _mm512_loadu_si512(ptr + 64);
+            keys = _mm512_permutex2var_epi64(lo, even, hi);
+        }
+        else
+            keys = _mm512_i64gather_epi64(offsets, ptr, 1);
+        unsigned mask = _mm512_cmplt_epu64_mask(keys, k);
+        if (mask != 0xff)
+            return i + __builtin_ctz(~mask);
+    }
+    if (i < count) { // tail with a masked load of the remaining keys
+        __mmask8 valid = (1u << (count - i)) - 1;
+        const char* ptr = base + (uint64_t)i * stride;
+        __m512i keys = _mm512_mask_i64gather_epi64(k, valid, offsets, ptr, 1);
+        unsigned mask = _mm512_mask_cmplt_epu64_mask(valid, keys, k);
+        return i + __builtin_ctz(~mask);
+    }
+    return count;
+}
+
+static unsigned lower_bound_resolve(const char* base, uint32_t stride, unsigned count, uint64_t key);
+
+std::atomic<lower_bound_t> lower_bound_fn(lower_bound_resolve);
+
+isa_t set_isa(isa_t target) {
+    __builtin_cpu_init();
+    if (target == AVX512 && !__builtin_cpu_supports("avx512f"))
+        target = AVX2;
+    if (target == AVX2 && !__builtin_cpu_supports("avx2"))
+        target = SCALAR;
+
+    isa = target;
+    switch (target) {
+        case AVX512: lower_bound_fn.store(lower_bound_avx512); break;
+        case AVX2:   lower_bound_fn.store(lower_bound_avx2); break;
+        default:     lower_bound_fn.store(lower_bound_scalar); break;
+    }
+    return target;
+}
+
+isa_t get_isa() {
+    if (lower_bound_fn.load() == lower_bound_resolve)
+        set_isa(AVX512);
+    return isa;
+}
+
+const char* get_isa_name(isa_t target) {
+    switch (target) {
+        case AVX512: return "AVX-512";
+        case AVX2:   return "AVX2";
+        default:     return "scalar";
+    }
+}
+
+static unsigned lower_bound_resolve(const char* base, uint32_t stride, unsigned count, uint64_t key) {
+    set_isa(AVX512);
+    return lower_bound_fn.load()(base, stride, count, key);
+}
+
+}
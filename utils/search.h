@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+
+// Lower bound over the sorted uint64_t keys of a tree node.
+// Keys are laid out every `stride` bytes (e.g., the first field of std::pair<Key, Value>).
+// The kernel (AVX-512, AVX2 or scalar) is selected at runtime on the first call, which may race with
+// the first calls of other threads; they all select the same kernel.
+// Like the linear search of the nodes, the result is the first position whose key is >= key,
+// so a node that is being modified concurrently (OLC) never makes the search read past count.
+namespace search {
+
+enum isa_t { SCALAR, AVX2, AVX512 };
+
+typedef unsigned (*lower_bound_t)(const char* base, uint32_t stride, unsigned count, uint64_t key);
+extern std::atomic<lower_bound_t> lower_bound_fn;
+
+isa_t       get_isa();
+// forces a kernel (e.g., to compare against the scalar one); unsupported ones fall back to a narrower one
+isa_t       set_isa(isa_t isa);
+const char* get_isa_name(isa_t isa);
+
+template <typename KeyValueType>
+inline unsigned lower_bound(const KeyValueType* data, unsigned count, uint64_t key) {
+    return lower_bound_fn.load(std::memory_order_relaxed)(reinterpret_cast<const char*>(&data[0].first), sizeof(KeyValueType), count, key);
+}
+
+}